@@ -13,6 +13,7 @@
 #include "thread_pool.h"
 #include "md5.h"
 #include "sha2.h"
+#include "hash_mb.h"
 #include "Win32Utils.h"
 #include "send_ping.h"
 #include <regex>
@@ -21,13 +22,33 @@
 #include "crc64.h"
 #include "StopWatch.h"
 #include "GeneralHashFunctions.h"
+#include "FastHashFunctions.h"
+#include "constexpr_hash.h"
 #include <unordered_map>
+#include <unordered_set>
 #include "Singleton.h"
 #include "FileInfoCache.h"
 #include "account_info.h"
 
 // _test_log.cpp
 extern bool test_log_rotate();
+extern bool test_log_async();
+extern bool test_log_finalize_race();
+extern bool test_log_deferred();
+extern bool test_log_level_check();
+extern bool test_log_ratelimit();
+extern bool test_log_json();
+extern bool test_log_group_commit();
+extern bool test_log_rotate_background();
+
+// _test_log_benchmark.cpp
+extern bool test_log_benchmark();
+
+// _test_hash_benchmark.cpp
+extern bool test_hash_benchmark();
+
+// _test_ring_queue.cpp
+extern bool test_ring_queue();
 
 // _test_steady_timer.cpp
 extern bool test_steady_timer();
@@ -43,6 +64,7 @@ extern bool test_iphelp_api();
 
 bool test_create_guid();
 bool test_file_info_cache();
+bool test_file_hash_pipeline();
 
 // _test_process_token.cpp
 extern bool test_process_token();
@@ -58,12 +80,16 @@ bool test_set_security_attributes();
 
 bool test_GeneralHashFunctions();
 bool test_GeneralHashFunctions2();
+bool test_fast_hash_functions();
+bool test_hash_stream();
+bool test_constexpr_hash();
 
 bool test_get_file_extension();
 bool test_raii_xxx();
 bool test_suspend_resume_process();
 bool test_to_str();
 bool test_convert_file_time();
+bool test_time_str_cache();
 
 // _test_ppl.cpp
 extern bool test_ppl();
@@ -77,6 +103,7 @@ extern bool test_scm_context();
 
 bool test_alignment_error_test();
 bool test_crc64();
+bool test_crc64_impl();
 
 bool test_NameConverter_iterate();
 bool test_NameConverter_get_canon_name();
@@ -129,6 +156,7 @@ extern bool test_process_tree();
 extern bool test_iterate_process_tree();
 extern bool test_image_path_by_pid();
 extern bool test_get_process_creation_time();
+extern bool test_known_process();
 
 // _test_cpp_test.cpp
 bool test_cpp_class();
@@ -152,6 +180,10 @@ bool test_rc4_encrypt();
 
 // md5.cpp / sha2.cpp
 bool test_md5_sha2();
+bool test_sha256_impl();
+bool test_sha512_impl();
+bool test_hash_mb();
+bool test_md5_blocks();
 
 // _test_boost_asio_timer.cpp
 extern bool test_boost_asio_timer();
@@ -193,6 +225,13 @@ extern bool test_set_binary_data();
 // thread_pool.h
 bool test_thread_pool();
 
+// _test_thread_pool.cpp
+extern bool test_thread_pool_work_stealing();
+extern bool test_thread_pool_bounded();
+extern bool test_thread_pool_task_alloc();
+extern bool test_parallel_algorithms();
+extern bool test_task_graph();
+
 // _test_boost_thread.cpp
 extern bool test_boost_thread();
 
@@ -208,12 +247,24 @@ void run_test()
 
 	bool ret = false;
 	assert_bool(true, test_log_rotate);
+	//assert_bool(true, test_log_async);
+	//assert_bool(true, test_log_finalize_race);
+	//assert_bool(true, test_log_deferred);
+	//assert_bool(true, test_log_level_check);
+	//assert_bool(true, test_log_ratelimit);
+	//assert_bool(true, test_log_json);
+	//assert_bool(true, test_log_group_commit);
+	//assert_bool(true, test_log_rotate_background);
+	//assert_bool(true, test_log_benchmark);
+	//assert_bool(true, test_hash_benchmark);
+	//assert_bool(true, test_ring_queue);
 	//assert_bool(true, test_steady_timer);
 	//assert_bool(true, test_net_util);
 	//assert_bool(true, test_dns_query);
 	//assert_bool(true, test_iphelp_api);
 	//assert_bool(true, test_create_guid);
 	//assert_bool(true, test_file_info_cache);
+	//assert_bool(true, test_file_hash_pipeline);
 	//
 	//assert_bool(true, test_process_token);
 	//assert_bool(true, test_is_executable_file_w);
@@ -223,10 +274,14 @@ void run_test()
 	//assert_bool(true, test_set_security_attributes);
 	//assert_bool(true, test_GeneralHashFunctions);
 	//assert_bool(true, test_GeneralHashFunctions2);
+	//assert_bool(true, test_fast_hash_functions);
+	//assert_bool(true, test_hash_stream);
+	//assert_bool(true, test_constexpr_hash);
 	//assert_bool(true, test_get_file_extension);
 	//assert_bool(true, test_raii_xxx);
 	//assert_bool(true, test_suspend_resume_process);
 	//assert_bool(true, test_convert_file_time);
+	//assert_bool(true, test_time_str_cache);
 
 	//assert_bool(true, test_ppl);
 
@@ -240,6 +295,7 @@ void run_test()
 	//assert_bool(true, test_ping);
 	//assert_bool(true, test_alignment_error_test);
 	//assert_bool(true, test_crc64);
+	//assert_bool(true, test_crc64_impl);
 
 
 	//assert_bool(true, test_NameConverter_iterate);
@@ -256,6 +312,11 @@ void run_test()
 
 	//assert_bool(true, test_boost_thread);
 	//assert_bool(true, test_thread_pool);
+	//assert_bool(true, test_thread_pool_work_stealing);
+	//assert_bool(true, test_thread_pool_bounded);
+	//assert_bool(true, test_thread_pool_task_alloc);
+	//assert_bool(true, test_parallel_algorithms);
+	//assert_bool(true, test_task_graph);
  //   
 	//assert_bool(true, test_boost_asio_timer);
 	//assert_bool(true, test_for_each);
@@ -280,6 +341,7 @@ void run_test()
 
 	//assert_bool(true, test_image_path_by_pid);
 	//assert_bool(true, test_get_process_creation_time);
+	//assert_bool(true, test_known_process);
 	//assert_bool(true, test_base64);
 	//assert_bool(true, test_random);
 	//assert_bool(true, test_ip_mac);
@@ -303,6 +365,10 @@ void run_test()
 	//assert_bool(true, test_get_installed_programs);
 	//assert_bool(true, test_rc4_encrypt);
 	//assert_bool(true, test_md5_sha2);
+	//assert_bool(true, test_sha256_impl);
+	//assert_bool(true, test_sha512_impl);
+	//assert_bool(true, test_hash_mb);
+	//assert_bool(true, test_md5_blocks);
 
 	//assert_bool(true, boost_lexical_cast);
 	//assert_bool(true, boost_shared_ptr_void);
@@ -1525,6 +1591,462 @@ bool test_md5_sha2()
     return true;
 }
 
+/// @brief	sha256_compile   (c, avx2, sha-ni, armv8)    ؽø 
+///			 Ȯϰ, ó ӵ Ѵ. 
+bool test_sha256_impl()
+{
+	struct
+	{
+		const char* msg;
+		uint32_t repeat;
+		const char* digest;
+	} vectors[] = {
+		{ "", 1, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+		{ "abc", 1, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+		{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+		{ "a", 1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" }
+	};
+
+	const int prev_impl = sha256_get_impl();
+	log_info "selected sha256 impl=%s", sha2_impl_name(prev_impl) log_end;
+
+	// ,  ִ ũ⸦ ٲ㰡  
+	std::vector<uint8_t> data(1024 * 1024 + 13);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+	const uint32_t lengths[] = { 0, 1, 55, 56, 63, 64, 65, 127, 128, 129, 1000, (uint32_t)data.size() };
+	const uint32_t chunks[] = { 0xffffffff, 1, 63, 64, 65, 1000 };	// ó ѹ
+
+	uint8_t expected[_countof(lengths)][32];
+	bool ret = true;
+	for (int impl = SHA2_IMPL_C; impl <= SHA2_IMPL_ARMV8 && true == ret; ++impl)
+	{
+		if (SHA2_GOOD != sha256_set_impl(impl))
+		{
+			log_info "impl=%s, not supported", sha2_impl_name(impl) log_end;
+			continue;
+		}
+
+		for (auto& vector : vectors)
+		{
+			sha256_ctx ctx;
+			uint8_t hval[32];
+			std::string hex;
+			sha256_begin(&ctx);
+			for (uint32_t i = 0; i < vector.repeat; ++i)
+			{
+				sha256_hash((const unsigned char*)vector.msg, (unsigned long)strlen(vector.msg), &ctx);
+			}
+			sha256_end(hval, &ctx);
+			bin_to_hexa_fast(sizeof(hval), hval, false, hex);
+			if (0 != hex.compare(vector.digest))
+			{
+				log_err "impl=%s, msg=%s, sha256=%s, expected=%s",
+					sha2_impl_name(impl),
+					vector.msg,
+					hex.c_str(),
+					vector.digest
+					log_end;
+				ret = false;
+			}
+		}
+
+		for (size_t l = 0; l < _countof(lengths); ++l)
+		{
+			for (auto chunk : chunks)
+			{
+				sha256_ctx ctx;
+				uint8_t hval[32];
+				sha256_begin(&ctx);
+				for (uint32_t pos = 0; pos < lengths[l]; pos += chunk)
+				{
+					uint32_t size = std::min(chunk, lengths[l] - pos);
+					sha256_hash(&data[pos], size, &ctx);
+				}
+				sha256_end(hval, &ctx);
+
+				// ó (c)   Ѵ.
+				if (SHA2_IMPL_C == impl && 0xffffffff == chunk)
+				{
+					RtlCopyMemory(expected[l], hval, sizeof(hval));
+				}
+				else if (0 != memcmp(expected[l], hval, sizeof(hval)))
+				{
+					log_err "impl=%s, length=%u, chunk=%u, mismatch",
+						sha2_impl_name(impl),
+						lengths[l],
+						chunk
+						log_end;
+					ret = false;
+				}
+			}
+		}
+
+		// ó ӵ
+		const uint32_t rounds = 64;
+		sha256_ctx ctx;
+		uint8_t hval[32];
+		StopWatch sw;
+		sw.Start();
+		sha256_begin(&ctx);
+		for (uint32_t i = 0; i < rounds; ++i)
+		{
+			sha256_hash(data.data(), (unsigned long)data.size(), &ctx);
+		}
+		sha256_end(hval, &ctx);
+		sw.Stop();
+		log_info "impl=%s, %.1f MB/s",
+			sha2_impl_name(impl),
+			(double)data.size() * rounds / (1024.0 * 1024.0) / std::max(sw.GetDurationSecond(), 0.000001f)
+			log_end;
+	}
+
+	sha256_set_impl(prev_impl);
+	return ret;
+}
+
+/// @brief	sha384/sha512   (c, avx2)    ؽø  
+///			Ȯϰ, ó ӵ Ѵ. 
+bool test_sha512_impl()
+{
+	struct
+	{
+		uint32_t size;
+		const char* msg;
+		uint32_t repeat;
+		const char* digest;
+	} vectors[] = {
+		{ 48, "abc", 1, "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7" },
+		{ 48, "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 1, "09330c33f71147e83d192fc782cd1b4753111b173b3b05d22fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039" },
+		{ 64, "", 1, "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e" },
+		{ 64, "abc", 1, "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f" },
+		{ 64, "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 1, "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909" },
+		{ 64, "a", 1000000, "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b" }
+	};
+
+	const int prev_impl = sha512_get_impl();
+	log_info "selected sha512 impl=%s", sha2_impl_name(prev_impl) log_end;
+
+	// ,  ִ ũ⸦ ٲ㰡  
+	std::vector<uint8_t> data(1024 * 1024 + 13);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+	const uint32_t lengths[] = { 0, 1, 111, 112, 127, 128, 129, 255, 256, 257, 383, 1000, (uint32_t)data.size() };
+	const uint32_t chunks[] = { 0xffffffff, 1, 127, 128, 129, 1000 };	// ó ѹ
+
+	uint8_t expected[_countof(lengths)][SHA512_DIGEST_SIZE];
+	bool ret = true;
+	for (int impl = SHA2_IMPL_C; impl <= SHA2_IMPL_ARMV8 && true == ret; ++impl)
+	{
+		if (SHA2_GOOD != sha512_set_impl(impl))
+		{
+			log_info "impl=%s, not supported", sha2_impl_name(impl) log_end;
+			continue;
+		}
+
+		for (auto& vector : vectors)
+		{
+			sha2_ctx ctx;
+			uint8_t hval[SHA512_DIGEST_SIZE];
+			std::string hex;
+			sha2_begin(vector.size, &ctx);
+			for (uint32_t i = 0; i < vector.repeat; ++i)
+			{
+				sha2_hash((const unsigned char*)vector.msg, (unsigned long)strlen(vector.msg), &ctx);
+			}
+			sha2_end(hval, &ctx);
+			bin_to_hexa_fast(vector.size, hval, false, hex);
+			if (0 != hex.compare(vector.digest))
+			{
+				log_err "impl=%s, msg=%s, sha%u=%s, expected=%s",
+					sha2_impl_name(impl),
+					vector.msg,
+					vector.size * 8,
+					hex.c_str(),
+					vector.digest
+					log_end;
+				ret = false;
+			}
+		}
+
+		for (size_t l = 0; l < _countof(lengths); ++l)
+		{
+			for (auto chunk : chunks)
+			{
+				sha512_ctx ctx;
+				uint8_t hval[SHA512_DIGEST_SIZE];
+				sha512_begin(&ctx);
+				for (uint32_t pos = 0; pos < lengths[l]; pos += chunk)
+				{
+					uint32_t size = std::min(chunk, lengths[l] - pos);
+					sha512_hash(&data[pos], size, &ctx);
+				}
+				sha512_end(hval, &ctx);
+
+				// ó (c)   Ѵ.
+				if (SHA2_IMPL_C == impl && 0xffffffff == chunk)
+				{
+					RtlCopyMemory(expected[l], hval, sizeof(hval));
+				}
+				else if (0 != memcmp(expected[l], hval, sizeof(hval)))
+				{
+					log_err "impl=%s, length=%u, chunk=%u, mismatch",
+						sha2_impl_name(impl),
+						lengths[l],
+						chunk
+						log_end;
+					ret = false;
+				}
+			}
+		}
+
+		// ó ӵ
+		const uint32_t rounds = 64;
+		sha512_ctx ctx;
+		uint8_t hval[SHA512_DIGEST_SIZE];
+		StopWatch sw;
+		sw.Start();
+		sha512_begin(&ctx);
+		for (uint32_t i = 0; i < rounds; ++i)
+		{
+			sha512_hash(data.data(), (unsigned long)data.size(), &ctx);
+		}
+		sha512_end(hval, &ctx);
+		sw.Stop();
+		log_info "impl=%s, %.1f MB/s",
+			sha2_impl_name(impl),
+			(double)data.size() * rounds / (1024.0 * 1024.0) / std::max(sw.GetDurationSecond(), 0.000001f)
+			log_end;
+	}
+
+	sha512_set_impl(prev_impl);
+	return ret;
+}
+
+/// @brief	hash_mb (multi-buffer)   sha256(), md5, sha384(), sha512()  ϰ, 
+///			 ޼ ؽ  ó ӵ Ѵ. 
+bool test_hash_mb()
+{
+	std::vector<uint8_t> data(256 * 1024 + 7);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+
+	// lane  ̰ ٸ Ѵ.
+	const size_t lengths[] = { 0, 1, 3, 55, 56, 57, 63, 64, 65, 119, 120, 127, 128, 129,
+							   1000, 4096, 5000, 65536 + 11, data.size() };
+	std::vector<hash_mb_job> jobs(3 * _countof(lengths));
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		jobs[i].len = lengths[(i * 7) % _countof(lengths)];
+		jobs[i].data = &data[(i * 13) % (data.size() - jobs[i].len + 1)];
+		jobs[i].context = (void*)i;
+	}
+
+	const int algorithms[] = { hash_mb_sha256, hash_mb_md5, hash_mb_sha384, hash_mb_sha512 };
+	const uint32_t lanes[] = { 4, 8, 16 };
+	bool ret = true;
+	for (auto algorithm : algorithms)
+	{
+		//  ؽ
+		auto single_hash = [algorithm](uint8_t* digest, const unsigned char* data, size_t len)
+		{
+			switch (algorithm)
+			{
+			case hash_mb_sha256: sha256(digest, data, (unsigned long)len); break;
+			case hash_mb_md5: MD5Hash(digest, data, len); break;
+			case hash_mb_sha384: sha384(digest, data, (unsigned long)len); break;
+			case hash_mb_sha512: sha512(digest, data, (unsigned long)len); break;
+			}
+		};
+		std::vector<std::vector<uint8_t>> expected(jobs.size());
+		for (size_t i = 0; i < jobs.size(); ++i)
+		{
+			expected[i].resize(SHA512_DIGEST_SIZE);
+			single_hash(expected[i].data(), jobs[i].data, jobs[i].len);
+		}
+		size_t digest_size = 0;
+		switch (algorithm)
+		{
+		case hash_mb_sha256: digest_size = SHA256_DIGEST_SIZE; break;
+		case hash_mb_md5: digest_size = MD5_DIGEST_SIZE; break;
+		case hash_mb_sha384: digest_size = SHA384_DIGEST_SIZE; break;
+		case hash_mb_sha512: digest_size = SHA512_DIGEST_SIZE; break;
+		}
+
+		for (auto lane_count : lanes)
+		{
+			hash_mb_mgr mgr;
+			if (true != hash_mb_init(&mgr, algorithm, lane_count))
+			{
+				log_info "algorithm=%d, lanes=%u, not supported", algorithm, lane_count log_end;
+				continue;
+			}
+
+			//  job  ѹ ϵǾ Ѵ.
+			std::vector<uint32_t> returned(jobs.size(), 0);
+			for (auto& job : jobs)
+			{
+				memset(job.digest, 0x00, sizeof(job.digest));
+				phash_mb_job done = hash_mb_submit(&mgr, &job);
+				if (nullptr != done) { ++returned[(size_t)done->context]; }
+			}
+			for (phash_mb_job done = hash_mb_flush(&mgr);
+				 nullptr != done;
+				 done = hash_mb_flush(&mgr))
+			{
+				++returned[(size_t)done->context];
+			}
+
+			for (size_t i = 0; i < jobs.size(); ++i)
+			{
+				if (1 != returned[i] || 0 != memcmp(jobs[i].digest, expected[i].data(), digest_size))
+				{
+					log_err "algorithm=%d, lanes=%u, job=%u, length=%u, returned=%u, mismatch",
+						algorithm,
+						lane_count,
+						(uint32_t)i,
+						(uint32_t)jobs[i].len,
+						returned[i]
+						log_end;
+					ret = false;
+				}
+			}
+		}
+		if (true != ret) return false;
+
+		//
+		//	ó ӵ, 1 KB ޼
+		//
+		const size_t count = 64 * 1024;
+		const size_t size = 1024;
+		std::vector<hash_mb_job> small_jobs(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			small_jobs[i].data = &data[(i * size) % (data.size() - size)];
+			small_jobs[i].len = size;
+		}
+
+		StopWatch sw;
+		sw.Start();
+		for (auto& job : small_jobs)
+		{
+			single_hash(job.digest, job.data, job.len);
+		}
+		sw.Stop();
+		float single = std::max(sw.GetDurationSecond(), 0.000001f);
+
+		sw.Start();
+		hash_mb_jobs(algorithm, small_jobs.data(), small_jobs.size());
+		sw.Stop();
+		float multi = std::max(sw.GetDurationSecond(), 0.000001f);
+
+		log_info "algorithm=%d, %u x %u bytes, single=%.1f MB/s, multi-buffer=%.1f MB/s",
+			algorithm,
+			(uint32_t)count,
+			(uint32_t)size,
+			(double)(count * size) / (1024.0 * 1024.0) / single,
+			(double)(count * size) / (1024.0 * 1024.0) / multi
+			log_end;
+	}
+	return true;
+}
+
+/// @brief	md5 (MD5Init/Update/Final, MD5Hash)  RFC 1321 ׽Ʈ Ϳ 
+///			 ִ ũ⸦ ٲ㰡 Ȯϰ, ó ӵ Ѵ. 
+bool test_md5_blocks()
+{
+	struct
+	{
+		const char* msg;
+		const char* digest;
+	} vectors[] = {
+		{ "", "d41d8cd98f00b204e9800998ecf8427e" },
+		{ "a", "0cc175b9c0f1b6a831c399e269772661" },
+		{ "abc", "900150983cd24fb0d6963f7d28e17f72" },
+		{ "message digest", "f96b697d7cb7938d525a2f31aaf161d0" },
+		{ "abcdefghijklmnopqrstuvwxyz", "c3fcd3d76192e4007dfb496cca67e13b" },
+		{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", "d174ab98d277d9f5a5611c2c9f419d9f" },
+		{ "12345678901234567890123456789012345678901234567890123456789012345678901234567890", "57edf4a22be3c955ac49da2e2107b67a" }
+	};
+
+	for (auto& vector : vectors)
+	{
+		MD5_CTX ctx;
+		uint8_t hval[MD5_DIGEST_SIZE];
+		std::string hex;
+		std::string hex2;
+		MD5Init(&ctx, 0);
+		MD5Update(&ctx, (const unsigned char*)vector.msg, (unsigned int)strlen(vector.msg));
+		MD5Final(&ctx);
+		MD5Hash(hval, (const unsigned char*)vector.msg, strlen(vector.msg));
+		bin_to_hexa_fast(sizeof(ctx.digest), ctx.digest, false, hex);
+		bin_to_hexa_fast(sizeof(hval), hval, false, hex2);
+		if (0 != hex.compare(vector.digest) || 0 != hex2.compare(vector.digest))
+		{
+			log_err "msg=%s, md5=%s, MD5Hash=%s, expected=%s",
+				vector.msg,
+				hex.c_str(),
+				hex2.c_str(),
+				vector.digest
+				log_end;
+			return false;
+		}
+	}
+
+	// ,  ִ ũ⸦ ٲ㰡 MD5Hash  
+	std::vector<uint8_t> data(1024 * 1024 + 13);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+	const uint32_t lengths[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000, (uint32_t)data.size() };
+	const uint32_t chunks[] = { 1, 7, 63, 64, 65, 1000, 0xffffffff };
+	for (auto length : lengths)
+	{
+		uint8_t expected[MD5_DIGEST_SIZE];
+		MD5Hash(expected, data.data(), length);
+
+		for (auto chunk : chunks)
+		{
+			MD5_CTX ctx;
+			MD5Init(&ctx, 0);
+			for (uint32_t pos = 0; pos < length; pos += chunk)
+			{
+				MD5Update(&ctx, &data[pos], std::min(chunk, length - pos));
+			}
+			MD5Final(&ctx);
+			if (0 != memcmp(expected, ctx.digest, sizeof(expected)))
+			{
+				log_err "length=%u, chunk=%u, mismatch", length, chunk log_end;
+				return false;
+			}
+		}
+	}
+
+	// ó ӵ
+	const uint32_t rounds = 64;
+	MD5_CTX ctx;
+	StopWatch sw;
+	sw.Start();
+	MD5Init(&ctx, 0);
+	for (uint32_t i = 0; i < rounds; ++i)
+	{
+		MD5Update(&ctx, data.data(), (unsigned int)data.size());
+	}
+	MD5Final(&ctx);
+	sw.Stop();
+	log_info "md5, %.1f MB/s",
+		(double)data.size() * rounds / (1024.0 * 1024.0) / std::max(sw.GetDurationSecond(), 0.000001f)
+		log_end;
+	return true;
+}
+
 /**
  * @brief thread_pool test
  */
@@ -2405,6 +2927,122 @@ bool test_crc64()
     return true;
 }
 
+/// @brief	crc64   (byte, slicing-by-8/16, pclmulqdq)    , 
+///			crc64_combine()     ĥ  ִ Ȯϰ, 
+///			ó ӵ Ѵ. 
+bool test_crc64_impl()
+{
+	std::vector<uint8_t> data(4 * 1024 * 1024 + 13);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+	const uint64_t lengths[] = { 0, 1, 7, 8, 15, 16, 17, 63, 64, 127, 128, 129, 255, 1000, 4096 + 3, data.size() };
+
+	const int prev_impl = crc64_get_impl();
+	log_info "selected crc64 impl=%s", crc64_impl_name(prev_impl) log_end;
+
+	uint64_t expected[_countof(lengths)];
+	bool ret = true;
+	for (int impl = CRC64_IMPL_BYTE; impl <= CRC64_IMPL_CLMUL && true == ret; ++impl)
+	{
+		if (0 == crc64_set_impl(impl))
+		{
+			log_info "impl=%s, not supported", crc64_impl_name(impl) log_end;
+			continue;
+		}
+
+		uint64_t check = crc64(0, (const unsigned char*)"123456789", 9);
+		if (0xe9c6d914c4b8d9caULL != check)
+		{
+			log_err "impl=%s, check=%016llx", crc64_impl_name(impl), check log_end;
+			ret = false;
+		}
+
+		// ó (byte)   Ѵ. (ĵ  ּ, 0  ƴ ʱⰪ)
+		for (size_t l = 0; l < _countof(lengths); ++l)
+		{
+			uint64_t length = std::min(lengths[l], (uint64_t)data.size() - 3);
+			uint64_t crc = crc64(0x123456789abcdefULL, &data[3], length);
+			if (CRC64_IMPL_BYTE == impl)
+			{
+				expected[l] = crc;
+			}
+			else if (expected[l] != crc)
+			{
+				log_err "impl=%s, length=%llu, crc=%016llx, expected=%016llx",
+					crc64_impl_name(impl),
+					length,
+					crc,
+					expected[l]
+					log_end;
+				ret = false;
+			}
+		}
+
+		// ó ӵ
+		const uint32_t rounds = 16;
+		uint64_t crc = 0;
+		StopWatch sw;
+		sw.Start();
+		for (uint32_t i = 0; i < rounds; ++i)
+		{
+			crc = crc64(crc, data.data(), data.size());
+		}
+		sw.Stop();
+		log_info "impl=%s, %.1f MB/s",
+			crc64_impl_name(impl),
+			(double)data.size() * rounds / (1024.0 * 1024.0) / std::max(sw.GetDurationSecond(), 0.000001f)
+			log_end;
+	}
+	crc64_set_impl(prev_impl);
+	if (true != ret) return false;
+
+	//
+	//	crc64_combine
+	//
+	const uint64_t whole = crc64(0, data.data(), data.size());
+	const size_t splits[] = { 0, 1, 8, 100, 4096, data.size() - 1, data.size() };
+	for (auto split : splits)
+	{
+		uint64_t crc_a = crc64(0, data.data(), split);
+		uint64_t crc_b = crc64(0, &data[split], data.size() - split);
+		if (whole != crc64_combine(crc_a, crc_b, data.size() - split))
+		{
+			log_err "split=%u, crc64_combine mismatch", (uint32_t)split log_end;
+			return false;
+		}
+	}
+
+	// 帶   ϰ ģ.
+	const size_t chunk_count = 4;
+	const size_t chunk_size = data.size() / chunk_count;
+	uint64_t chunk_crc[chunk_count];
+	boost::thread_group threads;
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		threads.create_thread([&, i]()
+		{
+			size_t size = (i == chunk_count - 1) ? data.size() - i * chunk_size : chunk_size;
+			chunk_crc[i] = crc64(0, &data[i * chunk_size], size);
+		});
+	}
+	threads.join_all();
+
+	uint64_t merged = chunk_crc[0];
+	for (size_t i = 1; i < chunk_count; ++i)
+	{
+		size_t size = (i == chunk_count - 1) ? data.size() - i * chunk_size : chunk_size;
+		merged = crc64_combine(merged, chunk_crc[i], size);
+	}
+	if (whole != merged)
+	{
+		log_err "parallel crc64=%016llx, expected=%016llx", merged, whole log_end;
+		return false;
+	}
+	return true;
+}
+
 class TestClass
 {
 public:
@@ -2450,6 +3088,100 @@ bool test_file_info_cache()
 	return true;
 }
 
+/// @brief	get_file_hash()  block ũ, buffer   ޸𸮿 
+///			ѹ  ؽÿ    ȮѴ.
+bool test_file_hash_pipeline()
+{
+	std::wstring path = get_current_module_dirEx() + L"\\test_file_hash_pipeline.bin";
+
+	// ؼ ϴ 쿡 ׽Ʈ  .
+	std::unique_ptr<std::wstring, void(*)(std::wstring*)> file_remover(
+		&path, 
+		[](std::wstring* p) { DeleteFileW(p->c_str()); });
+
+	// block 迡  ʴ ũ
+	const uint32_t sizes[] = { 0, 1000, 2 * _hash_block_size_max + 12345 };
+	for (auto size : sizes)
+	{
+		std::vector<uint8_t> data(size);
+		for (uint32_t i = 0; i < size; ++i)
+		{
+			data[i] = (uint8_t)(i * 2654435761u >> 24);
+		}
+
+		{
+			handle_ptr file(CreateFileW(path.c_str(),
+										GENERIC_WRITE,
+										0,
+										NULL,
+										CREATE_ALWAYS,
+										FILE_ATTRIBUTE_NORMAL,
+										NULL),
+							[](HANDLE h) { if (INVALID_HANDLE_VALUE != h) CloseHandle(h); });
+			if (INVALID_HANDLE_VALUE == file.get()) return false;
+
+			DWORD written = 0;
+			if (0 < size && 
+				(!WriteFile(file.get(), data.data(), size, &written, NULL) || written != size))
+			{
+				return false;
+			}
+		}
+
+		//
+		//	޸𸮿 ѹ  ؽ
+		//
+		MD5_CTX ctx_md5;
+		sha256_ctx ctx_sha2;
+		uint8_t sha2_buf[32];
+		MD5Init(&ctx_md5, 0);
+		MD5Update(&ctx_md5, data.data(), size);
+		MD5Final(&ctx_md5);
+		sha256_begin(&ctx_sha2);
+		sha256_hash(data.data(), size, &ctx_sha2);
+		sha256_end(sha2_buf, &ctx_sha2);
+
+		std::string md5_expected;
+		std::string sha2_expected;
+		bin_to_hexa_fast(sizeof(ctx_md5.digest), ctx_md5.digest, false, md5_expected);
+		bin_to_hexa_fast(sizeof(sha2_buf), sha2_buf, false, sha2_expected);
+
+		const uint32_t block_sizes[] = { _hash_block_size_min, _hash_block_size_def, _hash_block_size_max };
+		for (auto block_size : block_sizes)
+		{
+			for (uint32_t count = _hash_buffer_count_min; count <= _hash_buffer_count_max; ++count)
+			{
+				std::string md5;
+				std::string sha2;
+				StopWatch sw;
+				sw.Start();
+				if (true != get_file_hash(path.c_str(), block_size, count, md5, sha2)) return false;
+				sw.Stop();
+
+				if (0 != md5.compare(md5_expected) || 0 != sha2.compare(sha2_expected))
+				{
+					log_err "hash mismatch. size=%u, block=%u, buffers=%u, md5=%s, sha2=%s",
+						size,
+						block_size,
+						count,
+						md5.c_str(),
+						sha2.c_str()
+						log_end;
+					return false;
+				}
+
+				log_info "size=%u, block=%u, buffers=%u, %f msecs",
+					size,
+					block_size,
+					count,
+					sw.GetDurationMilliSecond()
+					log_end;
+			}
+		}
+	}
+	return true;
+}
+
 bool test_create_guid()
 {
 	GUID guid;
@@ -2929,6 +3661,357 @@ bool test_GeneralHashFunctions2()
 	return true;
 }
 
+bool test_fast_hash_functions()
+{
+	std::vector<uint8_t> data(1024 * 1024 + 13);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+
+	//
+	//	XXHash64  reference   ̾ Ѵ.
+	//
+	if (0xef46db3751d8e999ULL != XXHash64("", 0, 0) ||
+		0xd24ec4f1a98c6e5bULL != XXHash64("a", 1, 0) ||
+		0x44bc2cf5ad770999ULL != XXHash64("abc", 3, 0))
+	{
+		log_err "XXHash64 test vector mismatch" log_end;
+		return false;
+	}
+
+	struct functions
+	{
+		hash_function64 func;
+		char* name;
+	} _functions[] = {
+		{ XXHash64, "XXHash64" },
+		{ WYHash64, "WYHash64" },
+		{ StripeHash64, "StripeHash64" },
+		{ [](const void* data, uint64_t len, uint64_t seed)->uint64_t
+			{
+				return StripeHash128(data, len, seed).high;
+			},
+			"StripeHash128" }
+	};
+
+	// seed  ٸ ٸ ̾ Ѵ.
+	for (int i = 0; i < _countof(_functions); ++i)
+	{
+		for (uint64_t len : { 0, 3, 16, 100, 1000 })
+		{
+			if (_functions[i].func(data.data(), len, 0) == _functions[i].func(data.data(), len, 1))
+			{
+				log_err "func=%s, len=%llu, seed ignored", _functions[i].name, len log_end;
+				return false;
+			}
+		}
+	}
+
+	//
+	//	StripeHash    (scalar, sse2, avx2)   ̾ Ѵ.
+	//	(ĵ  ּ, block   )
+	//
+	const int prev_impl = fast_hash_get_impl();
+	log_info "selected fast hash impl=%s", fast_hash_impl_name(prev_impl) log_end;
+
+	const uint64_t lengths[] = { 0, 1, 255, 256, 257, 1023, 1024, 1025, 4096 + 3, data.size() - 3 };
+	uint64_t expected[_countof(lengths)][3];
+	bool ret = true;
+	for (int impl = FAST_HASH_IMPL_SCALAR; impl <= FAST_HASH_IMPL_AVX2 && true == ret; ++impl)
+	{
+		if (0 == fast_hash_set_impl(impl))
+		{
+			log_info "impl=%s, not supported", fast_hash_impl_name(impl) log_end;
+			continue;
+		}
+
+		for (size_t l = 0; l < _countof(lengths); ++l)
+		{
+			hash128_t h128 = StripeHash128(&data[3], lengths[l], 0x123456789abcdefULL);
+			uint64_t hash[3] = { StripeHash64(&data[3], lengths[l], 0x123456789abcdefULL), h128.low, h128.high };
+			if (FAST_HASH_IMPL_SCALAR == impl)
+			{
+				RtlCopyMemory(expected[l], hash, sizeof(hash));
+			}
+			else if (0 != memcmp(expected[l], hash, sizeof(hash)))
+			{
+				log_err "impl=%s, length=%llu, hash=%016llx, expected=%016llx",
+					fast_hash_impl_name(impl),
+					lengths[l],
+					hash[0],
+					expected[l][0]
+					log_end;
+				ret = false;
+			}
+		}
+	}
+	fast_hash_set_impl(prev_impl);
+	if (true != ret) return false;
+
+	//
+	//	   Ű 100 浹
+	//
+	const uint32_t key_count = 1000000;
+	char key[MAX_PATH];
+	for (int i = 0; i < _countof(_functions); ++i)
+	{
+		std::unordered_set<uint64_t> _tbl;
+		_tbl.reserve(key_count);
+		uint32_t collision_count = 0;
+		for (uint32_t j = 0; j < key_count; ++j)
+		{
+			int len = sprintf_s(key, "c:\\windows\\system32\\drivers\\%08u.sys", j);
+			if (true != _tbl.insert(_functions[i].func(key, len, 0)).second)
+			{
+				collision_count++;
+			}
+		}
+		log_info "func=%s, keys=%u, collision=%u",
+			_functions[i].name,
+			key_count,
+			collision_count
+			log_end;
+		if (0 != collision_count) return false;
+	}
+
+	//
+	//	ó ӵ (FNVHash  )
+	//
+	const uint32_t rounds = 16;
+	for (int i = -1; i < (int)_countof(_functions); ++i)
+	{
+		uint64_t hash = 0;
+		StopWatch sw;
+		sw.Start();
+		for (uint32_t r = 0; r < rounds; ++r)
+		{
+			if (0 > i)
+			{
+				hash += FNVHash((char*)data.data(), (unsigned int)data.size());
+			}
+			else
+			{
+				hash += _functions[i].func(data.data(), data.size(), r);
+			}
+		}
+		sw.Stop();
+		log_info "func=%s, %.1f MB/s (%016llx)",
+			(0 > i) ? "FNVHash" : _functions[i].name,
+			(double)data.size() * rounds / (1024.0 * 1024.0) / std::max(sw.GetDurationSecond(), 0.000001f),
+			hash
+			log_end;
+	}
+	return true;
+}
+
+bool test_hash_stream()
+{
+	std::vector<uint8_t> data(64 * 1024 + 13);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = (uint8_t)(i * 2654435761u >> 24);
+	}
+
+	//
+	//	GeneralHashFunctions
+	//	θ component   ־ ѹ   ƾ Ѵ.
+	//
+	struct general_functions
+	{
+		hash_function func;
+		hash_init_function init;
+		hash_update_function update;
+		hash_final_function final;
+		char* name;
+	} _general[] = {
+		{ RSHash, RSHashInit, RSHashUpdate, RSHashFinal, "RSHash" },
+		{ JSHash, JSHashInit, JSHashUpdate, JSHashFinal, "JSHash" },
+		{ PJWHash, PJWHashInit, PJWHashUpdate, PJWHashFinal, "PJWHash" },
+		{ ELFHash, ELFHashInit, ELFHashUpdate, ELFHashFinal, "ELFHash" },
+		{ BKDRHash, BKDRHashInit, BKDRHashUpdate, BKDRHashFinal, "BKDRHash" },
+		{ SDBMHash, SDBMHashInit, SDBMHashUpdate, SDBMHashFinal, "SDBMHash" },
+		{ DJBHash, DJBHashInit, DJBHashUpdate, DJBHashFinal, "DJBHash" },
+		{ DEKHash, DEKHashInit, DEKHashUpdate, DEKHashFinal, "DEKHash" },
+		{ BPHash, BPHashInit, BPHashUpdate, BPHashFinal, "BPHash" },
+		{ FNVHash, FNVHashInit, FNVHashUpdate, FNVHashFinal, "FNVHash" },
+		{ APHash, APHashInit, APHashUpdate, APHashFinal, "APHash" }
+	};
+
+	const char* components[] = { "c:", "\\windows", "\\system32", "\\drivers", "\\", "etc", "\\hosts" };
+	std::string path;
+	for (auto component : components) { path += component; }
+
+	for (int i = 0; i < _countof(_general); ++i)
+	{
+		general_hash_ctx ctx;
+		_general[i].init(&ctx);
+		for (auto component : components)
+		{
+			_general[i].update(&ctx, component, (unsigned int)strlen(component));
+		}
+
+		unsigned int expected = _general[i].func(const_cast<char*>(path.c_str()), (unsigned int)path.size());
+		if (expected != _general[i].final(&ctx))
+		{
+			log_err "func=%s, stream=0x%08x, expected=0x%08x",
+				_general[i].name,
+				_general[i].final(&ctx),
+				expected
+				log_end;
+			return false;
+		}
+	}
+
+	//
+	//	FastHashFunctions
+	//	chunk ũ⸦ ٲ㰡 (1 byte,   , ū ) Ѵ.
+	//
+	const size_t chunks[] = { 1, 7, 16, 31, 32, 33, 48, 49, 63, 64, 65, 255, 256, 257, 1024, 4096, data.size() };
+	const uint64_t seed = 0x123456789abcdefULL;
+	for (auto chunk : chunks)
+	{
+		for (uint64_t length : { (uint64_t)0, (uint64_t)5, (uint64_t)100, (uint64_t)300, (uint64_t)2049, (uint64_t)data.size() - 3 })
+		{
+			XXHash64_ctx xxh;
+			WYHash64_ctx wyh;
+			StripeHash_ctx sh;
+			XXHash64Init(&xxh, seed);
+			WYHash64Init(&wyh, seed);
+			StripeHashInit(&sh, seed);
+			for (uint64_t pos = 0; pos < length; pos += chunk)
+			{
+				uint64_t size = std::min((uint64_t)chunk, length - pos);
+				XXHash64Update(&xxh, &data[3 + pos], size);
+				WYHash64Update(&wyh, &data[3 + pos], size);
+				StripeHashUpdate(&sh, &data[3 + pos], size);
+			}
+
+			hash128_t h128 = StripeHash128Final(&sh);
+			hash128_t e128 = StripeHash128(&data[3], length, seed);
+			if (XXHash64Final(&xxh) != XXHash64(&data[3], length, seed) ||
+				WYHash64Final(&wyh) != WYHash64(&data[3], length, seed) ||
+				StripeHash64Final(&sh) != StripeHash64(&data[3], length, seed) ||
+				h128.low != e128.low ||
+				h128.high != e128.high)
+			{
+				log_err "chunk=%u, length=%llu, stream mismatch",
+					(uint32_t)chunk,
+					length
+					log_end;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool test_constexpr_hash()
+{
+	//
+	//	 Ÿ 
+	//
+	static_assert("explorer.exe"_fnv == const_fnv_hash("explorer.exe", 12), "_fnv");
+	static_assert(L"EXPLORER.EXE"_ifnv == L"explorer.exe"_ifnv, "_ifnv");
+	static_assert("abc"_djb != "abd"_djb, "_djb");
+
+	static constexpr const char* keys[] = { "HKLM", "HKCU", "HKCR", "HKU", "HKCC" };
+	static constexpr const_string_table<char, _countof(keys)> table(keys);
+	static_assert(3 == table.find("HKU"), "const_string_table");
+	static_assert(-1 == table.find("HKLM\\"), "const_string_table");
+
+	//
+	//	Ÿ Լ  ̾ Ѵ. (0x80 ̻  )
+	//
+	char* strs[] = { "", "a", "explorer.exe", "c:\\windows\\system32\\drivers\\etc\\hosts", "\xc7\xd1\xb1\xdb.txt" };
+	for (auto str : strs)
+	{
+		unsigned int len = (unsigned int)strlen(str);
+		if (FNVHash(str, len) != const_fnv_hash(str, len) ||
+			DJBHash(str, len) != const_djb_hash(str, len) ||
+			SDBMHash(str, len) != const_sdbm_hash(str, len) ||
+			BKDRHash(str, len) != const_bkdr_hash(str, len))
+		{
+			log_err "constexpr hash mismatch, str=%s", str log_end;
+			return false;
+		}
+	}
+
+	//
+	//	perfect hash table
+	//
+	for (size_t i = 0; i < table.size(); ++i)
+	{
+		if ((int)i != table.find(keys[i])) return false;
+	}
+	if (-1 != table.find("hklm")) return false;
+	if (-1 != table.find("")) return false;
+
+	static constexpr const wchar_t* names[] = { L"System", L"explorer.exe", L"lsass.exe" };
+	static constexpr const_string_table<wchar_t, _countof(names), true> itable(names);
+	if (1 != itable.find(L"Explorer.EXE")) return false;
+	if (-1 != itable.find(L"explorer.exe ")) return false;
+
+	//
+	//	key   table (, Ʈ ̸ )
+	//
+	static constexpr const char* services[] = {
+		"svc_name_000.exe", "svc_name_001.exe", "svc_name_002.exe", "svc_name_003.exe", "svc_name_004.exe", "svc_name_005.exe",
+		"svc_name_006.exe", "svc_name_007.exe", "svc_name_008.exe", "svc_name_009.exe", "svc_name_010.exe", "svc_name_011.exe",
+		"svc_name_012.exe", "svc_name_013.exe", "svc_name_014.exe", "svc_name_015.exe", "svc_name_016.exe", "svc_name_017.exe",
+		"svc_name_018.exe", "svc_name_019.exe", "svc_name_020.exe", "svc_name_021.exe", "svc_name_022.exe", "svc_name_023.exe",
+		"svc_name_024.exe", "svc_name_025.exe", "svc_name_026.exe", "svc_name_027.exe", "svc_name_028.exe", "svc_name_029.exe",
+		"svc_name_030.exe", "svc_name_031.exe", "svc_name_032.exe", "svc_name_033.exe", "svc_name_034.exe", "svc_name_035.exe",
+		"svc_name_036.exe", "svc_name_037.exe", "svc_name_038.exe", "svc_name_039.exe", "svc_name_040.exe", "svc_name_041.exe",
+		"svc_name_042.exe", "svc_name_043.exe", "svc_name_044.exe", "svc_name_045.exe", "svc_name_046.exe", "svc_name_047.exe",
+		"svc_name_048.exe", "svc_name_049.exe", "svc_name_050.exe", "svc_name_051.exe", "svc_name_052.exe", "svc_name_053.exe",
+		"svc_name_054.exe", "svc_name_055.exe", "svc_name_056.exe", "svc_name_057.exe", "svc_name_058.exe", "svc_name_059.exe",
+		"svc_name_060.exe", "svc_name_061.exe", "svc_name_062.exe", "svc_name_063.exe", "svc_name_064.exe", "svc_name_065.exe",
+		"svc_name_066.exe", "svc_name_067.exe", "svc_name_068.exe", "svc_name_069.exe", "svc_name_070.exe", "svc_name_071.exe"
+	};
+	static constexpr const_string_table<char, _countof(services)> stable(services);
+	static_assert(71 == stable.find("svc_name_071.exe"), "const_string_table");
+	for (size_t i = 0; i < stable.size(); ++i)
+	{
+		if ((int)i != stable.find(services[i])) return false;
+	}
+	if (-1 != stable.find("svc_name_072.exe")) return false;
+
+	log_info "const_string_table, keys=%u, seed=%u", (uint32_t)table.size(), table.seed() log_end;
+
+	//
+	//	ó ӵ, ڿ  vs perfect hash
+	//
+	const wchar_t* inputs[] = { L"svchost.exe", L"explorer.exe", L"chrome.exe", L"System", L"lsass.exe" };
+	const uint32_t rounds = 1000000;
+	uint32_t found = 0;
+	StopWatch sw;
+	sw.Start();
+	for (uint32_t r = 0; r < rounds; ++r)
+	{
+		const wchar_t* input = inputs[r % _countof(inputs)];
+		for (auto name : names)
+		{
+			if (0 == _wcsicmp(input, name)) { ++found; break; }
+		}
+	}
+	sw.Stop();
+	float cmp_time = sw.GetDurationMilliSecond();
+
+	sw.Start();
+	for (uint32_t r = 0; r < rounds; ++r)
+	{
+		if (-1 != itable.find(inputs[r % _countof(inputs)])) ++found;
+	}
+	sw.Stop();
+	log_info "_wcsicmp=%f msecs, const_string_table=%f msecs, found=%u",
+		cmp_time,
+		sw.GetDurationMilliSecond(),
+		found
+		log_end;
+	return true;
+}
+
 bool test_get_file_extension()
 {
 	//
@@ -3198,6 +4281,92 @@ bool test_convert_file_time()
 	return true;
 }
 
+/// @brief	  ĳø ϴ file_time_to_str()  sys_time_to_str() 
+///			 ڿ  Ȯϰ, ӵ Ѵ.
+bool test_time_str_cache()
+{
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	uint64_t base = file_time_to_int(&now);
+
+	//
+	//	 ,  ,  , utc/localtime, и ڸ
+	//
+	const uint64_t deltas[] = {
+		0,
+		1 * _file_time_to_msec,
+		12 * _file_time_to_msec,
+		123 * _file_time_to_msec,
+		999 * _file_time_to_msec,
+		1 * _file_time_to_sec,
+		1 * _file_time_to_sec + 5 * _file_time_to_msec,
+		59 * _file_time_to_sec,
+		1 * _file_time_to_day,
+		0
+	};
+
+	char buf[32];
+	for (auto delta : deltas)
+	{
+		uint64_t file_time = base - (base % _file_time_to_sec) + delta;
+		FILETIME ft;
+		SYSTEMTIME utc;
+		int_to_file_time(file_time, &ft);
+		FileTimeToSystemTime(&ft, &utc);
+
+		for (int localtime = 0; localtime < 2; ++localtime)
+		{
+			for (int show_misec = 0; show_misec < 2; ++show_misec)
+			{
+				std::string expected = sys_time_to_str(&utc, 1 == localtime, 1 == show_misec);
+				size_t length = file_time_to_str(file_time, 1 == localtime, 1 == show_misec, buf, sizeof(buf));
+				if (expected.size() != length || 0 != expected.compare(buf))
+				{
+					log_err "mismatch, expected=%s, cached=%s",
+						expected.c_str(),
+						buf
+						log_end;
+					return false;
+				}
+			}
+		}
+	}
+
+	// buffer   
+	if (0 != file_time_to_str(base, true, true, buf, 10) || '\0' != buf[0]) return false;
+
+	//
+	//	ӵ 
+	//
+	const uint32_t count = 1000000;
+	size_t total = 0;
+	StopWatch sw;
+	sw.Start();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		SYSTEMTIME utc;
+		GetSystemTime(&utc);
+		total += sys_time_to_str(&utc, true, true).size();
+	}
+	sw.Stop();
+	float uncached = sw.GetDurationMilliSecond();
+
+	sw.Start();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		total += time_now_to_str(true, true, buf, sizeof(buf));
+	}
+	sw.Stop();
+	log_info "count=%u, sys_time_to_str=%f msecs, cached=%f msecs, total=%llu",
+		count,
+		uncached,
+		sw.GetDurationMilliSecond(),
+		(uint64_t)total
+		log_end;
+
+	return true;
+}
+
 bool test_trivia()
 {
 	class aaa
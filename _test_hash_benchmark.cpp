@@ -0,0 +1,619 @@
+/**
+ * @file    hash benchmark for GeneralHashFunctions, FastHashFunctions, crc64, md5, sha2
+ * @brief	ؽ Լ
+ *			- 8 B ~ 64 MB Է ó ӵ (bytes/cycle, MB/s)
+ *			-  Ű (4 ~ 64 B) ϳ latency (cycles, ns)
+ *			- Ű  ( , IPv4 ּ, GUID, Ϸùȣ)  浹 ,
+ *			  bucket , avalanche
+ *			 ϰ, α׿ JSON  (hash_benchmark.json)  Ѵ.
+ *
+ *			cycle  __rdtsc()  (TSC) ̹Ƿ turbo/ ¿ core
+ *			cycle  ٸ  ִ.  ӽſ  񱳿̴.
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+#include "stdafx.h"
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <cmath>
+#include <intrin.h>
+#include "GeneralHashFunctions.h"
+#include "FastHashFunctions.h"
+#include "crc64.h"
+#include "md5.h"
+#include "sha2.h"
+#include "StopWatch.h"
+
+/// @brief	digest ִ ũ (sha512)
+#define _hash_bench_max_digest		64
+
+/// @brief	ó ӵ ũ⸶ ּ ̸ŭ ؽ ð ϰ,
+///			_hash_bench_runs      Ѵ.
+#define _hash_bench_max_size		(64 * 1024 * 1024)
+#define _hash_bench_min_bytes		(16 * 1024 * 1024)
+#define _hash_bench_runs			3
+
+/// @brief	latency  Ƚ
+#define _hash_bench_latency_rounds	100000
+
+/// @brief	Ű  Ű , avalanche   Ű 
+#define _hash_bench_keys			100000
+#define _hash_bench_avalanche_keys	1000
+
+/// @brief	bucket  ؽ  bit  . (power of 2 ũ
+///			sharded cache   )
+#define _hash_bench_chi2_bits		16
+#define _hash_bench_shard_bits		10
+
+typedef void (*hash_bench_fn)(
+	_In_reads_bytes_(len) const unsigned char* data,
+	_In_ size_t len,
+	_Out_writes_bytes_(_hash_bench_max_digest) unsigned char* digest
+	);
+
+typedef struct hash_bench_function
+{
+	const char*		name;
+	uint32_t		bits;		///< digest ũ
+	hash_bench_fn	func;
+} *phash_bench_function;
+
+template <hash_function F>
+static void general_hash(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	unsigned int hash = F((char*)data, (unsigned int)len);
+	memcpy(digest, &hash, sizeof(hash));
+}
+
+template <hash_function64 F>
+static void fast_hash64(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	uint64_t hash = F(data, len, 0);
+	memcpy(digest, &hash, sizeof(hash));
+}
+
+static void stripe_hash128(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	hash128_t hash = StripeHash128(data, len, 0);
+	memcpy(digest, &hash, sizeof(hash));
+}
+
+static void crc64_digest(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	uint64_t crc = crc64(0, data, len);
+	memcpy(digest, &crc, sizeof(crc));
+}
+
+static void md5_digest(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	MD5Hash(digest, data, len);
+}
+
+static void sha256_digest(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	sha256(digest, data, (unsigned long)len);
+}
+
+static void sha384_digest(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	sha384(digest, data, (unsigned long)len);
+}
+
+static void sha512_digest(const unsigned char* data, size_t len, unsigned char* digest)
+{
+	sha512(digest, data, (unsigned long)len);
+}
+
+static const hash_bench_function _hash_bench_functions[] = {
+	{ "RSHash", 32, general_hash<RSHash> },
+	{ "JSHash", 32, general_hash<JSHash> },
+	{ "PJWHash", 32, general_hash<PJWHash> },
+	{ "ELFHash", 32, general_hash<ELFHash> },
+	{ "BKDRHash", 32, general_hash<BKDRHash> },
+	{ "SDBMHash", 32, general_hash<SDBMHash> },
+	{ "DJBHash", 32, general_hash<DJBHash> },
+	{ "DEKHash", 32, general_hash<DEKHash> },
+	{ "BPHash", 32, general_hash<BPHash> },
+	{ "FNVHash", 32, general_hash<FNVHash> },
+	{ "APHash", 32, general_hash<APHash> },
+	{ "XXHash64", 64, fast_hash64<XXHash64> },
+	{ "WYHash64", 64, fast_hash64<WYHash64> },
+	{ "StripeHash64", 64, fast_hash64<StripeHash64> },
+	{ "StripeHash128", 128, stripe_hash128 },
+	{ "crc64", 64, crc64_digest },
+	{ "md5", 128, md5_digest },
+	{ "sha256", 256, sha256_digest },
+	{ "sha384", 384, sha384_digest },
+	{ "sha512", 512, sha512_digest }
+};
+
+typedef struct hash_bench_throughput
+{
+	size_t		size;
+	double		bytes_per_cycle;
+	double		mb_per_sec;
+} *phash_bench_throughput;
+
+typedef struct hash_bench_latency
+{
+	size_t		size;
+	double		cycles;
+	double		ns;
+} *phash_bench_latency;
+
+typedef struct hash_bench_quality
+{
+	const char*	key_set;
+	uint32_t	keys;
+	uint64_t	collisions;				///< 64 bit ()  ڸ ؽð 浹
+	double		expected_collisions;	///< ̻ ؽ 浹 밪
+	double		chi2;					///< chi-square / , 1.0   
+	double		max_load;				///<  ū shard / 
+	double		avalanche_mean;			///< Է 1 bit  ٲ  bit , 0.5  ̻
+	double		avalanche_output_bias;	///< max |P( bit j ) - 0.5|
+	double		avalanche_input_bias;	///< max |Է bit i     - 0.5|
+} *phash_bench_quality;
+
+typedef struct hash_bench_result
+{
+	const hash_bench_function*			function;
+	std::vector<hash_bench_throughput>	throughput;
+	std::vector<hash_bench_latency>		latency;
+	std::vector<hash_bench_quality>		quality;
+} *phash_bench_result;
+
+typedef struct hash_bench_key_set
+{
+	const char*					name;
+	std::vector<std::string>	keys;
+} *phash_bench_key_set;
+
+/// @brief	ȭ ؽ ȣ  ʵ digest  ⿡ .
+static volatile uint64_t _hash_bench_sink = 0;
+
+static uint64_t splitmix64(_Inout_ uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/// @brief	digest   64 bit (32 bit ؽô 32 bit)
+static uint64_t digest_to_u64(_In_ const unsigned char* digest, _In_ uint32_t bits)
+{
+	uint64_t value = 0;
+	memcpy(&value, digest, (bits < 64) ? bits / 8 : 8);
+	return value;
+}
+
+/// @brief	data   size Ʈ ؽϴ ӵ
+static void
+measure_throughput(
+	_In_ const hash_bench_function& function,
+	_In_ const std::vector<unsigned char>& data,
+	_In_ size_t size,
+	_Out_ hash_bench_throughput& result
+	)
+{
+	const size_t rounds = std::max((size_t)1, (size_t)_hash_bench_min_bytes / size);
+	unsigned char digest[_hash_bench_max_digest];
+	uint64_t best_cycles = UINT64_MAX;
+	float best_sec = 0.0f;
+
+	for (int run = 0; run < _hash_bench_runs; ++run)
+	{
+		uint64_t sink = 0;
+		StopWatch sw;
+		sw.Start();
+		uint64_t begin = __rdtsc();
+		for (size_t r = 0; r < rounds; ++r)
+		{
+			function.func(data.data(), size, digest);
+			sink += digest[0];
+		}
+		uint64_t cycles = __rdtsc() - begin;
+		sw.Stop();
+		_hash_bench_sink += sink;
+
+		if (cycles < best_cycles)
+		{
+			best_cycles = cycles;
+			best_sec = sw.GetDurationSecond();
+		}
+	}
+
+	const double bytes = (double)size * (double)rounds;
+	result.size = size;
+	result.bytes_per_cycle = bytes / (double)std::max(best_cycles, (uint64_t)1);
+	result.mb_per_sec = bytes / (1024.0 * 1024.0) / std::max(best_sec, 0.000001f);
+}
+
+/// @brief	size Ʈ Ű ϳ latency
+///			 Ű  digest  ϹǷ ȣ ļ  ʴ´.
+static void
+measure_latency(
+	_In_ const hash_bench_function& function,
+	_In_ size_t size,
+	_Out_ hash_bench_latency& result
+	)
+{
+	unsigned char key[64] = { 0 };
+	unsigned char digest[_hash_bench_max_digest] = { 0 };
+	uint64_t state = size;
+	for (size_t i = 0; i < sizeof(key); ++i)
+	{
+		key[i] = (unsigned char)splitmix64(state);
+	}
+
+	StopWatch sw;
+	sw.Start();
+	uint64_t begin = __rdtsc();
+	for (uint32_t r = 0; r < _hash_bench_latency_rounds; ++r)
+	{
+		function.func(key, size, digest);
+		key[0] ^= digest[0];
+	}
+	uint64_t cycles = __rdtsc() - begin;
+	sw.Stop();
+	_hash_bench_sink += key[0];
+
+	result.size = size;
+	result.cycles = (double)cycles / _hash_bench_latency_rounds;
+	result.ns = (double)sw.GetDurationSecond() * 1000000000.0 / _hash_bench_latency_rounds;
+}
+
+/// @brief	key_set  浹 , bucket , avalanche
+static void
+measure_quality(
+	_In_ const hash_bench_function& function,
+	_In_ const hash_bench_key_set& key_set,
+	_Out_ hash_bench_quality& result
+	)
+{
+	const uint32_t bits = std::min(function.bits, (uint32_t)64);
+	const size_t count = key_set.keys.size();
+	unsigned char digest[_hash_bench_max_digest];
+
+	std::vector<uint64_t> hashes(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const std::string& key = key_set.keys[i];
+		function.func((const unsigned char*)key.data(), key.size(), digest);
+		hashes[i] = digest_to_u64(digest, bits);
+	}
+
+	//
+	//	bucket  ( bit)
+	//
+	std::vector<uint32_t> buckets((size_t)1 << _hash_bench_chi2_bits, 0);
+	std::vector<uint32_t> shards((size_t)1 << _hash_bench_shard_bits, 0);
+	for (auto hash : hashes)
+	{
+		buckets[hash & (buckets.size() - 1)]++;
+		shards[hash & (shards.size() - 1)]++;
+	}
+
+	const double expected = (double)count / (double)buckets.size();
+	double chi2 = 0.0;
+	for (auto bucket : buckets)
+	{
+		chi2 += ((double)bucket - expected) * ((double)bucket - expected) / expected;
+	}
+	const double shard_mean = (double)count / (double)shards.size();
+
+	//
+	//	浹
+	//
+	std::sort(hashes.begin(), hashes.end());
+	uint64_t collisions = 0;
+	for (size_t i = 1; i < count; ++i)
+	{
+		if (hashes[i] == hashes[i - 1]) ++collisions;
+	}
+
+	//
+	//	avalanche, Ű bit ϳ ٲ㼭  bit  ٲ 
+	//	(Է bit ġ 512  Ѵ)
+	//
+	const size_t max_input_bits = 512;
+	std::vector<uint64_t> output_flips(bits, 0);
+	std::vector<uint64_t> input_flips(max_input_bits, 0);
+	std::vector<uint64_t> input_samples(max_input_bits, 0);
+	uint64_t samples = 0;
+	uint64_t total_flips = 0;
+
+	const size_t step = std::max((size_t)1, count / _hash_bench_avalanche_keys);
+	for (size_t i = 0; i < count; i += step)
+	{
+		std::string key = key_set.keys[i];
+		function.func((const unsigned char*)key.data(), key.size(), digest);
+		const uint64_t base = digest_to_u64(digest, bits);
+
+		for (size_t bit = 0; bit < key.size() * 8; ++bit)
+		{
+			key[bit / 8] ^= (char)(1 << (bit % 8));
+			function.func((const unsigned char*)key.data(), key.size(), digest);
+			key[bit / 8] ^= (char)(1 << (bit % 8));
+
+			const uint64_t diff = base ^ digest_to_u64(digest, bits);
+			uint32_t flips = 0;
+			for (uint32_t j = 0; j < bits; ++j)
+			{
+				if (0 != ((diff >> j) & 1))
+				{
+					output_flips[j]++;
+					flips++;
+				}
+			}
+			total_flips += flips;
+			samples++;
+
+			const size_t position = std::min(bit, max_input_bits - 1);
+			input_flips[position] += flips;
+			input_samples[position]++;
+		}
+	}
+
+	double output_bias = 0.0;
+	for (auto flips : output_flips)
+	{
+		output_bias = std::max(output_bias, std::abs((double)flips / (double)samples - 0.5));
+	}
+	double input_bias = 0.0;
+	for (size_t i = 0; i < max_input_bits; ++i)
+	{
+		if (0 == input_samples[i]) continue;
+		double ratio = (double)input_flips[i] / (double)input_samples[i] / (double)bits;
+		input_bias = std::max(input_bias, std::abs(ratio - 0.5));
+	}
+
+	result.key_set = key_set.name;
+	result.keys = (uint32_t)count;
+	result.collisions = collisions;
+	result.expected_collisions = (double)count * (double)(count - 1) / 2.0 / std::pow(2.0, (double)bits);
+	result.chi2 = chi2 / (double)(buckets.size() - 1);
+	result.max_load = (double)*std::max_element(shards.begin(), shards.end()) / shard_mean;
+	result.avalanche_mean = (double)total_flips / (double)samples / (double)bits;
+	result.avalanche_output_bias = output_bias;
+	result.avalanche_input_bias = input_bias;
+}
+
+/// @brief	 Ű  Ű  . (׻  Ű)
+static void make_key_sets(_Out_ std::vector<hash_bench_key_set>& key_sets)
+{
+	static const char* dirs[] = {
+		"c:\\windows\\system32",
+		"c:\\windows\\system32\\drivers",
+		"c:\\windows\\syswow64",
+		"c:\\program files\\common files\\microsoft shared",
+		"c:\\program files (x86)\\google\\chrome\\application",
+		"c:\\users\\user\\appdata\\local\\temp",
+		"c:\\users\\user\\documents",
+		"c:\\programdata\\microsoft\\windows defender\\scans"
+	};
+	static const char* names[] = { "setup", "data", "log", "report", "image", "update", "cache", "config" };
+	static const char* exts[] = { "exe", "dll", "sys", "txt", "log", "docx", "xlsx", "pdf", "jpg", "tmp" };
+
+	char buf[MAX_PATH];
+	uint64_t state = 0;
+
+	hash_bench_key_set paths = { "windows_path" };
+	hash_bench_key_set ips = { "ipv4" };
+	hash_bench_key_set guids = { "guid" };
+	hash_bench_key_set numbers = { "sequential_u64" };
+	for (uint32_t i = 0; i < _hash_bench_keys; ++i)
+	{
+		sprintf_s(buf,
+				  "%s\\%s%05u.%s",
+				  dirs[i % _countof(dirs)],
+				  names[(i / _countof(dirs)) % _countof(names)],
+				  i,
+				  exts[(i / 7) % _countof(exts)]);
+		paths.keys.push_back(buf);
+
+		sprintf_s(buf, "10.%u.%u.%u", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+		ips.keys.push_back(buf);
+
+		uint64_t hi = splitmix64(state);
+		uint64_t lo = splitmix64(state);
+		sprintf_s(buf,
+				  "{%08X-%04X-%04X-%04X-%012llX}",
+				  (uint32_t)(hi >> 32),
+				  (uint32_t)(hi >> 16) & 0xffff,
+				  (uint32_t)hi & 0xffff,
+				  (uint32_t)(lo >> 48),
+				  lo & 0xffffffffffffULL);
+		guids.keys.push_back(buf);
+
+		uint64_t number = i;
+		numbers.keys.push_back(std::string((const char*)&number, sizeof(number)));
+	}
+
+	key_sets.push_back(std::move(paths));
+	key_sets.push_back(std::move(ips));
+	key_sets.push_back(std::move(guids));
+	key_sets.push_back(std::move(numbers));
+}
+
+/// @brief	 JSON  .
+static std::string results_to_json(_In_ const std::vector<hash_bench_result>& results)
+{
+	std::stringstream json;
+	json << "{\n  \"functions\": [";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const hash_bench_result& result = results[i];
+		json << ((0 == i) ? "\n" : ",\n")
+			<< "    {\n"
+			<< "      \"name\": \"" << result.function->name << "\",\n"
+			<< "      \"bits\": " << result.function->bits << ",\n"
+			<< "      \"throughput\": [";
+		for (size_t j = 0; j < result.throughput.size(); ++j)
+		{
+			const hash_bench_throughput& t = result.throughput[j];
+			json << ((0 == j) ? "" : ", ")
+				<< "{\"size\": " << t.size
+				<< ", \"bytes_per_cycle\": " << t.bytes_per_cycle
+				<< ", \"mb_per_sec\": " << t.mb_per_sec << "}";
+		}
+		json << "],\n      \"latency\": [";
+		for (size_t j = 0; j < result.latency.size(); ++j)
+		{
+			const hash_bench_latency& l = result.latency[j];
+			json << ((0 == j) ? "" : ", ")
+				<< "{\"size\": " << l.size
+				<< ", \"cycles\": " << l.cycles
+				<< ", \"ns\": " << l.ns << "}";
+		}
+		json << "],\n      \"quality\": [";
+		for (size_t j = 0; j < result.quality.size(); ++j)
+		{
+			const hash_bench_quality& q = result.quality[j];
+			json << ((0 == j) ? "\n" : ",\n")
+				<< "        {\"key_set\": \"" << q.key_set << "\""
+				<< ", \"keys\": " << q.keys
+				<< ", \"collisions\": " << q.collisions
+				<< ", \"expected_collisions\": " << q.expected_collisions
+				<< ", \"chi2\": " << q.chi2
+				<< ", \"max_load\": " << q.max_load
+				<< ", \"avalanche_mean\": " << q.avalanche_mean
+				<< ", \"avalanche_output_bias\": " << q.avalanche_output_bias
+				<< ", \"avalanche_input_bias\": " << q.avalanche_input_bias << "}";
+		}
+		json << "\n      ]\n    }";
+	}
+	json << "\n  ]\n}\n";
+	return json.str();
+}
+
+/// @brief	ؽ Լ ġũ
+///			    hash_benchmark.json  ȴ.
+bool test_hash_benchmark()
+{
+	static const size_t sizes[] = {
+		8, 64, 512, 4 * 1024, 32 * 1024, 256 * 1024,
+		2 * 1024 * 1024, 16 * 1024 * 1024, _hash_bench_max_size
+	};
+	static const size_t latency_sizes[] = { 4, 8, 16, 32, 64 };
+
+	std::vector<unsigned char> data(_hash_bench_max_size);
+	uint64_t state = 0;
+	for (size_t i = 0; i < data.size(); i += sizeof(uint64_t))
+	{
+		uint64_t value = splitmix64(state);
+		memcpy(&data[i], &value, sizeof(value));
+	}
+
+	std::vector<hash_bench_key_set> key_sets;
+	make_key_sets(key_sets);
+
+	std::vector<hash_bench_result> results;
+	for (const auto& function : _hash_bench_functions)
+	{
+		hash_bench_result result;
+		result.function = &function;
+
+		for (auto size : sizes)
+		{
+			hash_bench_throughput throughput;
+			measure_throughput(function, data, size, throughput);
+			result.throughput.push_back(throughput);
+		}
+
+		for (auto size : latency_sizes)
+		{
+			hash_bench_latency latency;
+			measure_latency(function, size, latency);
+			result.latency.push_back(latency);
+		}
+
+		for (const auto& key_set : key_sets)
+		{
+			hash_bench_quality quality;
+			measure_quality(function, key_set, quality);
+			result.quality.push_back(quality);
+		}
+
+		results.push_back(std::move(result));
+	}
+
+	//
+	//	
+	//
+	log_info "%-14s %10s %10s %10s %10s %9s %9s",
+		"func",
+		"8B(B/c)",
+		"4KB(B/c)",
+		"64MB(B/c)",
+		"64MB(MB/s)",
+		"16B(cyc)",
+		"16B(ns)"
+		log_end;
+	for (const auto& result : results)
+	{
+		log_info "%-14s %10.3f %10.3f %10.3f %10.1f %9.1f %9.1f",
+			result.function->name,
+			result.throughput[0].bytes_per_cycle,
+			result.throughput[3].bytes_per_cycle,
+			result.throughput.back().bytes_per_cycle,
+			result.throughput.back().mb_per_sec,
+			result.latency[2].cycles,
+			result.latency[2].ns
+			log_end;
+	}
+
+	log_info "%-14s %-15s %10s %10s %8s %8s %8s %8s %8s",
+		"func",
+		"key_set",
+		"collision",
+		"expected",
+		"chi2",
+		"max_load",
+		"aval",
+		"out_bias",
+		"in_bias"
+		log_end;
+	for (const auto& result : results)
+	{
+		for (const auto& q : result.quality)
+		{
+			log_info "%-14s %-15s %10llu %10.3f %8.3f %8.3f %8.4f %8.4f %8.4f",
+				result.function->name,
+				q.key_set,
+				q.collisions,
+				q.expected_collisions,
+				q.chi2,
+				q.max_load,
+				q.avalanche_mean,
+				q.avalanche_output_bias,
+				q.avalanche_input_bias
+				log_end;
+		}
+	}
+
+	//
+	//	JSON
+	//
+	std::string json = results_to_json(results);
+	std::wstring path = get_current_module_dirEx() + L"\\hash_benchmark.json";
+	DeleteFileW(path.c_str());
+	HANDLE file = open_file_to_write(path.c_str());
+	if (INVALID_HANDLE_VALUE == file) return false;
+
+	DWORD written = 0;
+	bool ret = (TRUE == WriteFile(file, json.c_str(), (DWORD)json.size(), &written, NULL) &&
+				written == (DWORD)json.size());
+	CloseHandle(file);
+	if (true != ret)
+	{
+		log_err "WriteFile(%ws), gle=%u", path.c_str(), GetLastError() log_end;
+		return false;
+	}
+
+	log_info "result=%ws", path.c_str() log_end;
+	return true;
+}
@@ -7,7 +7,10 @@
  * @copyright All rights reserved by Yonghwan, Roh.
 **/
 #include "stdafx.h"
+#include <fstream>
 #include "log.h"
+#include "log_format.h"
+#include "StopWatch.h"
 
 bool test_log_rotate_with_no_file();
 bool test_log_rotate_with_ext();
@@ -123,4 +126,899 @@ bool test_log_rotate_without_ext()
 	log_info "end log rotate test" log_end;
 	finalize_log();
 	return true;
-}
\ No newline at end of file
+}
+
+/// @brief	 忡 ÿ α׸ ,  αװ   
+///			 Ͽ ϵǾ ȮѴ. 
+bool test_log_async()
+{
+	const uint32_t producers = 8;
+	const uint32_t per_producer = 20000;
+
+	std::wstringstream log_file_path;
+	log_file_path
+		<< get_current_module_dirEx()
+		<< L"\\test_log_async.log";
+	if (true == is_file_existsW(log_file_path.str().c_str()))
+	{
+		DeleteFileW(log_file_path.str().c_str());
+	}
+
+	uint32_t prev_log_level = get_log_level();
+	uint32_t prev_log_to = get_log_to();
+	if (true != initialize_log(log_mask_all,
+							   log_level_debug,
+							   log_to_file,
+							   log_file_path.str().c_str(),
+							   producers * per_producer + 1,
+							   2))
+	{
+		return false;
+	}
+
+	StopWatch sw; sw.Start();
+	boost::thread_group threads;
+	for (uint32_t id = 0; id < producers; ++id)
+	{
+		threads.create_thread([id, per_producer]()
+		{
+			for (uint32_t i = 0; i < per_producer; ++i)
+			{
+				log_write_fmt_without_deco(log_mask_sys,
+										   log_level_info,
+										   "producer=%u, seq=%u",
+										   id,
+										   i);
+			}
+		});
+	}
+	threads.join_all();
+	sw.Stop();
+	float elapsed = sw.GetDurationMilliSecond();
+
+	//
+	// logger thread   Ŀ  α׵ ϵǾ Ѵ. 
+	// 
+	Sleep(200);
+	log_write_fmt_without_deco(log_mask_sys, log_level_info, "last");
+	finalize_log();
+	set_log_env(log_mask_all, prev_log_level, prev_log_to);
+
+	//
+	//   α  ȮѴ.
+	// 
+	std::ifstream file(WcsToMbsEx(log_file_path.str().c_str()).c_str());
+	if (true != file.is_open()) return false;
+
+	std::vector<uint32_t> next(producers, 0);
+	uint32_t count = 0;
+	bool last = false;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		uint32_t id = 0;
+		uint32_t seq = 0;
+		if (2 != sscanf_s(line.c_str(), "producer=%u, seq=%u", &id, &seq))
+		{
+			if (line == "last") { last = true; continue; }
+			log_err "unexpected line, %s", line.c_str() log_end;
+			return false;
+		}
+
+		if (id >= producers || next[id] != seq)
+		{
+			log_err "out of order, producer=%u, seq=%u", id, seq log_end;
+			return false;
+		}
+		++next[id];
+		++count;
+	}
+	file.close();
+
+	if (producers * per_producer != count || true != last)
+	{
+		log_err "missing logs, count=%u, last=%s", count, last ? "true" : "false" log_end;
+		return false;
+	}
+
+	log_info "%u producers, %u logs, %.3f ms (%.0f logs/sec)",
+		producers,
+		count,
+		elapsed,
+		(double)count / (elapsed / 1000.0)
+		log_end;
+
+	DeleteFileW(log_file_path.str().c_str());
+	return true;
+}
+
+/// @brief	 尡 α׸   initialize_log(), finalize_log()  
+///			ݺѴ. finalize_log()  slogger    尡   
+///			ؾ Ѵ.
+bool test_log_finalize_race()
+{
+	const uint32_t producers = 4;
+	const uint32_t rounds = 50;
+
+	std::wstring path = get_current_module_dirEx() + L"\\test_log_finalize_race.log";
+	DeleteFileW(path.c_str());
+
+	uint32_t prev_log_level = get_log_level();
+	uint32_t prev_log_to = get_log_to();
+
+	//
+	// logger    log_to_file  Ǿ Ƿ ƹ͵  ʴ´.
+	// 
+	set_log_env(log_mask_all, log_level_debug, log_to_file);
+
+	std::atomic<bool> stop(false);
+	std::atomic<uint64_t> written(0);
+	boost::thread_group threads;
+	for (uint32_t id = 0; id < producers; ++id)
+	{
+		threads.create_thread([&stop, &written, id]()
+		{
+			uint32_t seq = 0;
+			while (true != stop.load())
+			{
+				log_write_fmt_without_deco(log_mask_sys,
+										   log_level_info,
+										   "producer=%u, seq=%u",
+										   id,
+										   seq++);
+			}
+			written += seq;
+		});
+	}
+
+	bool ret = true;
+	for (uint32_t round = 0; round < rounds; ++round)
+	{
+		if (true != initialize_log(log_mask_all,
+								   log_level_debug,
+								   log_to_file,
+								   path.c_str(),
+								   100000,
+								   2))
+		{
+			log_err "initialize_log() failed, round=%u", round log_end;
+			ret = false;
+			break;
+		}
+
+		Sleep(5);
+		finalize_log();
+	}
+
+	stop = true;
+	threads.join_all();
+	set_log_env(log_mask_all, prev_log_level, prev_log_to);
+	if (true != ret) return false;
+
+	log_info "%u rounds, %llu logs", rounds, written.load() log_end;
+
+	DeleteFileW(path.c_str());
+	return true;
+}
+
+/// @brief	deferred    ٷ    ȮѴ.
+static bool check_deferred_format(_In_z_ const char* fmt, ...)
+{
+	char expected[_max_log_message_size];
+	char packed[_max_log_message_size];
+	char formatted[_max_log_message_size];
+
+	va_list args;
+	va_start(args, fmt);
+	va_list args_copy;
+	va_copy(args_copy, args);
+	StringCbVPrintfA(expected, sizeof(expected), fmt, args);
+	uint32_t length = 0;
+	bool ret = log_pack_args(packed, sizeof(packed), fmt, args_copy, length);
+	va_end(args_copy);
+	va_end(args);
+
+	if (true != ret)
+	{
+		log_err "log_pack_args() failed, fmt=%s", fmt log_end;
+		return false;
+	}
+
+	log_format_args(formatted, sizeof(formatted), fmt, packed, length);
+	if (0 != strcmp(expected, formatted))
+	{
+		log_err "fmt=%s, expected=%s, formatted=%s", fmt, expected, formatted log_end;
+		return false;
+	}
+	return true;
+}
+
+/// @brief	log_pack_args()  ڸ   ִ ȮѴ.
+static bool can_pack_args(_In_z_ const char* fmt, ...)
+{
+	char packed[_max_log_message_size];
+	uint32_t length = 0;
+
+	va_list args;
+	va_start(args, fmt);
+	bool ret = log_pack_args(packed, sizeof(packed), fmt, args, length);
+	va_end(args);
+	return ret;
+}
+
+/// @brief	 α׸ ؽƮ , binary  Ѵ.
+static bool write_test_logs(_In_ uint32_t format_mode, _In_z_ const wchar_t* path)
+{
+	set_log_format_mode(format_mode);
+	if (true != initialize_log(log_mask_all,
+							   log_level_debug,
+							   log_to_file,
+							   path))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		log_info "deferred log, i=%d, str=%s, wstr=%ws, dbl=%.3f, %%",
+			i,
+			"narrow",
+			L"wide",
+			i / 7.0
+			log_end;
+		log_err "no argument" log_end;
+		log_msg "without decoration, %08x", i log_end;
+
+		//
+		// log_write_fmt()  fmt   ۿ ٷ Ѵ.
+		// (deferred  ϸ  fmt  о ؽƮ α׿ ޶)
+		// 
+		char fmt[64];
+		StringCbPrintfA(fmt, sizeof(fmt), "dynamic format %d, %%s", i);
+		log_write_fmt(log_mask_sys, log_level_info, __FUNCTION__, fmt, "arg");
+		memset(fmt, 'x', sizeof(fmt) - 1);
+	}
+	finalize_log();
+	return true;
+}
+
+static bool read_test_log(_In_z_ const wchar_t* path, _Out_ std::string& content)
+{
+	std::ifstream file(WcsToMbsEx(path).c_str(), std::ios::binary);
+	if (true != file.is_open()) return false;
+
+	std::stringstream strm;
+	strm << file.rdbuf();
+	content = strm.str();
+	return true;
+}
+
+/// @brief	deferred/binary  
+bool test_log_deferred()
+{
+	//
+	//    
+	// 
+	if (true != check_deferred_format("%d %u %x %X %o", -1, 2u, 0xbeef, 0xcafe, 8)) return false;
+	if (true != check_deferred_format("%lld %llu %llx", -1ll, 0xffffffffffull, 0x123456789abcull)) return false;
+	if (true != check_deferred_format("%zu %hd %c", (size_t)12345, (short)-3, 'z')) return false;
+	if (true != check_deferred_format("[%5.2f] [%-8.3e] [%g]", 3.14159, 0.000123, 1e20)) return false;
+	if (true != check_deferred_format("[%s] [%-10s] [%.3s]", "narrow", "left", "truncated")) return false;
+	if (true != check_deferred_format("[%ws] [%10ws]", L"wide", L"right")) return false;
+	if (true != check_deferred_format("[%*d] [%-*.*s]", 6, 42, 8, 2, "star")) return false;
+	if (true != check_deferred_format("%p %% 100%%", (void*)0x1234)) return false;
+	if (true != check_deferred_format("no argument")) return false;
+
+	// %n   ʴ´. (ٷ )
+	int n = 0;
+	if (true == can_pack_args("abc%n", &n)) return false;
+
+	//
+	//  α׸ ؽƮ , binary  ϰ, 
+	// binary α  ȯ  ؽƮ α ϰ  ȮѴ. 
+	// 
+	bool show_current_time, show_process_name, show_pid_tid, show_function_name;
+	get_log_format(show_current_time, show_process_name, show_pid_tid, show_function_name);
+	uint32_t prev_format_mode = get_log_format_mode();
+	uint32_t prev_log_level = get_log_level();
+	uint32_t prev_log_to = get_log_to();
+	set_log_format(false, true, true, true);
+
+	std::wstring dir = get_current_module_dirEx();
+	std::wstring text_path = dir + L"\\test_log_deferred_text.log";
+	std::wstring deferred_path = dir + L"\\test_log_deferred_deferred.log";
+	std::wstring binary_path = dir + L"\\test_log_deferred_binary.log";
+	std::wstring decoded_path = dir + L"\\test_log_deferred_decoded.log";
+	DeleteFileW(text_path.c_str());
+	DeleteFileW(deferred_path.c_str());
+	DeleteFileW(binary_path.c_str());
+
+	bool ret = write_test_logs(log_format_text, text_path.c_str()) &&
+			   write_test_logs(log_format_deferred, deferred_path.c_str()) &&
+			   write_test_logs(log_format_binary, binary_path.c_str()) &&
+			   decode_log_file(binary_path.c_str(), decoded_path.c_str());
+
+	set_log_format_mode(prev_format_mode);
+	set_log_format(show_current_time, show_process_name, show_pid_tid, show_function_name);
+	set_log_env(log_mask_all, prev_log_level, prev_log_to);
+	if (true != ret) return false;
+
+	std::string text;
+	std::string deferred;
+	std::string binary;
+	std::string decoded;
+	if (true != read_test_log(text_path.c_str(), text) ||
+		true != read_test_log(deferred_path.c_str(), deferred) ||
+		true != read_test_log(binary_path.c_str(), binary) ||
+		true != read_test_log(decoded_path.c_str(), decoded))
+	{
+		return false;
+	}
+
+	if (text != deferred || text != decoded)
+	{
+		log_err "log mismatch, text=%u bytes, deferred=%u bytes, decoded=%u bytes",
+			(uint32_t)text.size(),
+			(uint32_t)deferred.size(),
+			(uint32_t)decoded.size()
+			log_end;
+		return false;
+	}
+
+	log_info "text log %u bytes, binary log %u bytes",
+		(uint32_t)text.size(),
+		(uint32_t)binary.size()
+		log_end;
+
+	DeleteFileW(text_path.c_str());
+	DeleteFileW(deferred_path.c_str());
+	DeleteFileW(binary_path.c_str());
+	DeleteFileW(decoded_path.c_str());
+	return true;
+}
+
+/// @brief	log_dbg   Ƚ .
+static uint32_t log_arg_evaluated(_Inout_ uint32_t& count)
+{
+	return ++count;
+}
+
+/// @brief	ִ log level  ڴ 򰡵 ʴ ȮѴ.
+bool test_log_level_check()
+{
+	static_assert(true == log_compiled<log_mask_sys, log_level_error>::value, "log_err must be compiled");
+
+	uint32_t prev_log_mask = get_log_mask();
+	uint32_t prev_log_level = get_log_level();
+	uint32_t count = 0;
+
+	// if/else ȿ ũΰ ǵ ؾ Ѵ.
+	set_log_level(log_level_info);
+	if (0 == count)
+		log_dbg "disabled, count=%u", log_arg_evaluated(count) log_end
+	else
+		return false;
+
+	if (0 != count || true == log_enabled<log_mask_sys, log_level_debug>())
+	{
+		set_log_level(prev_log_level);
+		return false;
+	}
+
+	// ִ α״  ѹ 븸 .
+	StopWatch sw; sw.Start();
+	for (uint32_t i = 0; i < 10000000; ++i)
+	{
+		log_dbg "disabled, count=%u", log_arg_evaluated(count) log_end
+	}
+	sw.Stop();
+
+	// ִ α״ ڸ ѹ Ѵ. 
+	set_log_level(log_level_debug);
+	if (true == log_compiled<log_mask_sys, log_level_debug>::value)
+	{
+		log_dbg "enabled, count=%u", log_arg_evaluated(count) log_end
+		if (1 != count) 
+		{
+			set_log_level(prev_log_level);
+			return false;
+		}
+	}
+
+	// mask  Ե ʴ α
+	set_log_mask(0);
+	log_err "disabled, count=%u", log_arg_evaluated(count) log_end
+	set_log_mask(prev_log_mask);
+	set_log_level(prev_log_level);
+	if (1 < count) return false;
+
+	log_info "10,000,000 disabled log_dbg, %f msec", sw.GetDurationMilliSecond() log_end;
+	return true;
+}
+
+/// @brief	call site  α  (log_xxx_ratelimited, log_xxx_once)
+bool test_log_ratelimit()
+{
+	//
+	//  忡 ÿ Ȯص interval  burst  Ѵ. 
+	// (interval 踦  ѹ  burst    )
+	// 
+	log_rate_limiter limiter(5, 60 * 1000);
+	log_once_flag once;
+	std::atomic<uint32_t> allowed(0);
+	std::atomic<uint32_t> allowed_once(0);
+
+	boost::thread_group threads;
+	for (uint32_t id = 0; id < 8; ++id)
+	{
+		threads.create_thread([&]()
+		{
+			for (uint32_t i = 0; i < 10000; ++i)
+			{
+				if (true == limiter.allow(log_mask_sys, log_level_debug, __FUNCTION__)) ++allowed;
+				if (true == once.allow(log_mask_sys, log_level_debug, __FUNCTION__)) ++allowed_once;
+			}
+		});
+	}
+	threads.join_all();
+	if (allowed < 5 || allowed > 10 || 1 != allowed_once)
+	{
+		log_err "allowed=%u, allowed_once=%u", 
+			allowed.load(), 
+			allowed_once.load() 
+			log_end;
+		return false;
+	}
+
+	//
+	// ѵ α ڴ 򰡵 ʴ´. 
+	// 
+	uint32_t prev_log_level = get_log_level();
+	set_log_level(log_level_debug);
+
+	uint32_t count = 0;
+	uint32_t count_once = 0;
+	for (uint32_t i = 0; i <= 1000; ++i)
+	{
+		//  interval   α  µȴ.
+		if (1000 == i) Sleep(_log_ratelimit_interval_def + 100);
+
+		log_dbg_ratelimited "ratelimited, count=%u", log_arg_evaluated(count) log_end;
+		log_dbg_once "once, count=%u", log_arg_evaluated(count_once) log_end;
+	}
+	set_log_level(prev_log_level);
+
+	if (1 != count_once || 
+		count < _log_ratelimit_burst_def + 1 || 
+		count > 2 * _log_ratelimit_burst_def + 1)
+	{
+		log_err "count=%u, count_once=%u", count, count_once log_end;
+		return false;
+	}
+
+	//
+	//  α  (ȣ Ƚ - burst) ̰,  ȣ  
+	// interval   flush_suppressed()    ִ. 
+	// 
+	log_rate_limiter idle_limiter(2, 100);
+	uint32_t idle_allowed = 0;
+	for (uint32_t i = 0; i < 5; ++i)
+	{
+		if (true == idle_limiter.allow(log_mask_sys, log_level_debug, __FUNCTION__)) ++idle_allowed;
+	}
+	uint32_t early = idle_limiter.flush_suppressed(log_mask_sys, log_level_debug, __FUNCTION__);
+	Sleep(200);
+	uint32_t flushed = idle_limiter.flush_suppressed(log_mask_sys, log_level_debug, __FUNCTION__);
+	uint32_t flushed_again = idle_limiter.flush_suppressed(log_mask_sys, log_level_debug, __FUNCTION__);
+	if (2 != idle_allowed || 
+		0 != early || 
+		3 != flushed || 
+		0 != flushed_again || 
+		true != idle_limiter.allow(log_mask_sys, log_level_debug, __FUNCTION__))
+	{
+		log_err "allowed=%u, early=%u, flushed=%u, flushed_again=%u", 
+			idle_allowed, 
+			early, 
+			flushed, 
+			flushed_again 
+			log_end;
+		return false;
+	}
+	return true;
+}
+
+/// @brief	log_format_json_record()  expected   ȮѴ.
+static bool check_json_format(_In_ uint64_t time, 
+							  _In_z_ const char* msg, 
+							  _In_reads_opt_(field_count) const log_field* fields, 
+							  _In_ size_t field_count,
+							  _In_z_ const char* expected)
+{
+	char buffer[_max_log_message_size];
+	size_t length = log_format_json_record(buffer,
+									sizeof(buffer),
+									log_level_warn,
+									time,
+									1234,
+									5678,
+									L"test.exe",
+									"func",
+									msg,
+									strlen(msg),
+									fields,
+									field_count);
+	if (length != strlen(expected) || 0 != strcmp(buffer, expected))
+	{
+		log_err "json mismatch, \n%s%s", buffer, expected log_end;
+		return false;
+	}
+	return true;
+}
+
+/// @brief	`{...}\n` ̰,  ڿ  ִ ȮѴ.
+static bool is_json_line(_In_reads_(length) const char* line, _In_ size_t length)
+{
+	if (length < 3 || '{' != line[0] || 0 != strcmp(&line[length - 2], "}\n")) return false;
+
+	bool in_string = false;
+	for (size_t i = 0; i < length - 2; ++i)
+	{
+		if (true == in_string && '\\' == line[i]) { ++i; continue; }
+		if ('"' == line[i]) in_string = !in_string;
+	}
+	return true != in_string;
+}
+
+/// @brief	structured log (log_format_json)
+bool test_log_json()
+{
+	//
+	// ڵ
+	// 
+	if (true != check_json_format(134366725234560000ull, 
+								  "hello", 
+								  nullptr, 
+								  0,
+								  "{\"time\":\"2026-10-17T01:02:03.456Z\",\"level\":\"warn\",\"pid\":1234,\"tid\":5678,"
+								  "\"process\":\"test.exe\",\"function\":\"func\",\"msg\":\"hello\"}\n"))
+	{
+		return false;
+	}
+
+	std::string str = "a\"b";
+	log_field fields[] = {
+		log_field("int", -5),
+		log_field("uint", 18446744073709551615ull),
+		log_field("bool", true),
+		log_field("double", 1.5),
+		log_field("str", str),
+		log_field("wstr", L"\xd55c\\"),
+		log_field("null", (const char*)nullptr)
+	};
+	if (true != check_json_format(125963423999990000ull,
+								  "q\"b\\n\nt\t\x01", 
+								  fields, 
+								  _countof(fields),
+								  "{\"time\":\"2000-02-29T23:59:59.999Z\",\"level\":\"warn\",\"pid\":1234,\"tid\":5678,"
+								  "\"process\":\"test.exe\",\"function\":\"func\",\"msg\":\"q\\\"b\\\\n\\nt\\t\\u0001\","
+								  "\"int\":-5,\"uint\":18446744073709551615,\"bool\":true,\"double\":1.5,"
+								  "\"str\":\"a\\\"b\",\"wstr\":\"\xed\x95\x9c\\\\\",\"null\":null}\n"))
+	{
+		return false;
+	}
+
+	//
+	// ANSI code page ޼ UTF-8  ȯȴ.
+	// 
+	std::string ansi_msg = WcsToMbsEx(L"\xd55c\xae00 abc \x3131");
+	std::string utf8_msg = WcsToMbsUTF8Ex(MbsToWcsEx(ansi_msg.c_str()).c_str());
+	std::string expected = "{\"time\":\"2026-10-17T01:02:03.456Z\",\"level\":\"warn\",\"pid\":1234,\"tid\":5678,"
+						   "\"process\":\"test.exe\",\"function\":\"func\",\"msg\":\"" + utf8_msg + "\"}\n";
+	if (true != check_json_format(134366725234560000ull, ansi_msg.c_str(), nullptr, 0, expected.c_str()))
+	{
+		return false;
+	}
+
+	// ߷ UTF-8 ڰ ߰  ʾƾ Ѵ.
+	std::string long_ansi_msg;
+	for (int i = 0; i < 64; ++i) long_ansi_msg += ansi_msg;
+	for (size_t size = 120; size < 300; ++size)
+	{
+		char buffer[300];
+		size_t length = log_format_json_record(buffer,
+										size,
+										log_level_info,
+										134366725234560000ull,
+										1,
+										2,
+										L"test.exe",
+										"func",
+										long_ansi_msg.c_str(),
+										long_ansi_msg.size(),
+										nullptr,
+										0);
+		if (0 == length) continue;
+		if (length >= size || 
+			true != is_json_line(buffer, length) ||
+			0 == MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, buffer, (int)length, nullptr, 0))
+		{
+			log_err "invalid utf-8 json, size=%u", (uint32_t)size log_end;
+			return false;
+		}
+	}
+
+	//
+	// buffer  ص ùٸ JSON   Ѵ.
+	// 
+	std::string long_msg(4096, '"');
+	for (size_t size = 120; size < 300; ++size)
+	{
+		char buffer[300];
+		size_t length = log_format_json_record(buffer,
+										size,
+										log_level_info,
+										134366725234560000ull,
+										1,
+										2,
+										L"test.exe",
+										"func",
+										long_msg.c_str(),
+										long_msg.size(),
+										fields,
+										_countof(fields));
+		if (0 == length) continue;
+		if (length >= size || true != is_json_line(buffer, length))
+		{
+			log_err "invalid json, size=%u, %s", (uint32_t)size, buffer log_end;
+			return false;
+		}
+	}
+
+	//
+	// text 忡 ʵ ޼ ڿ ٴ´.
+	// 
+	char text[128];
+	log_format_fields(text, sizeof(text), fields, 3);
+	if (0 != strcmp(text, " int=-5 uint=18446744073709551615 bool=true"))
+	{
+		log_err "fields mismatch, %s", text log_end;
+		return false;
+	}
+
+	//
+	// json  Ͽ Ѵ.
+	// 
+	std::wstring path = get_current_module_dirEx() + L"\\test_log_json.log";
+	DeleteFileW(path.c_str());
+
+	uint32_t prev_format_mode = get_log_format_mode();
+	uint32_t prev_log_level = get_log_level();
+	uint32_t prev_log_to = get_log_to();
+	set_log_format_mode(log_format_json);
+	bool ret = initialize_log(log_mask_all, log_level_debug, log_to_file, path.c_str());
+	if (true == ret)
+	{
+		for (uint32_t i = 0; i < 100; ++i)
+		{
+			log_field kv[] = { log_field("seq", i), log_field("path", L"c:\\windows") };
+			log_info_kv(kv) "json log, i=%u", i log_end;
+		}
+		finalize_log();
+	}
+	set_log_format_mode(prev_format_mode);
+	set_log_env(log_mask_all, prev_log_level, prev_log_to);
+	if (true != ret) return false;
+
+	std::string content;
+	if (true != read_test_log(path.c_str(), content)) return false;
+
+	std::istringstream lines(content);
+	std::string line;
+	uint32_t count = 0;
+	while (std::getline(lines, line))
+	{
+		char expected[128];
+		StringCbPrintfA(expected, sizeof(expected), "\"msg\":\"json log, i=%u\",\"seq\":%u,\"path\":\"c:\\\\windows\"}", count, count);
+		if (0 != line.find("{\"time\":\"") ||
+			std::string::npos == line.find(expected) ||
+			line.size() != line.find(expected) + strlen(expected))
+		{
+			log_err "unexpected line, %s", line.c_str() log_end;
+			return false;
+		}
+		++count;
+	}
+	if (100 != count) return false;
+
+	DeleteFileW(path.c_str());
+	return true;
+}
+
+/// @brief	 α group commit
+bool test_log_group_commit()
+{
+	std::wstring path = get_current_module_dirEx() + L"\\test_log_group_commit.log";
+	DeleteFileW(path.c_str());
+
+	const uint32_t producers = 4;
+	const uint32_t per_producer = 10000;
+	std::string content;
+	uint64_t writes = 0;
+	{
+		slogger logger(log_level_debug,
+					   log_to_file,
+					   path.c_str(),
+					   producers * per_producer + 10,
+					   2,
+					   false,
+					   256 * 1024,
+					   1000,
+					   log_sync_error);
+		if (true != logger.slog_start()) return false;
+
+		//
+		// flush_interval    Ͽ  ʴ´. 
+		// 
+		logger.slog_write(log_level_info, "first\n");
+		Sleep(100);
+		if (true != read_test_log(path.c_str(), content) || 0 != content.size()) return false;
+
+		//
+		// error α״ ٷ , FlushFileBuffers()  ȣѴ. (log_sync_error)
+		// 
+		logger.slog_write(log_level_error, "error\n");
+		Sleep(100);
+		if (true != read_test_log(path.c_str(), content) || 
+			content != "first\nerror\n" ||
+			1 != logger.file_sync_count())
+		{
+			log_err "error log is not committed, %s", content.c_str() log_end;
+			return false;
+		}
+
+		//
+		//   α׸ Ƽ . 
+		// 
+		uint64_t writes_before = logger.file_write_count();
+		boost::thread_group threads;
+		for (uint32_t id = 0; id < producers; ++id)
+		{
+			threads.create_thread([&logger, id, per_producer]()
+			{
+				char msg[64];
+				for (uint32_t i = 0; i < per_producer; ++i)
+				{
+					StringCbPrintfA(msg, sizeof(msg), "producer=%u, seq=%u\n", id, i);
+					logger.slog_write(log_level_info, msg);
+				}
+			});
+		}
+		threads.join_all();
+
+		// flush_interval    α׸ .
+		Sleep(1500);
+		writes = logger.file_write_count() - writes_before;
+		if (true != read_test_log(path.c_str(), content)) return false;
+		logger.slog_stop();
+	}
+
+	uint32_t lines = (uint32_t)std::count(content.begin(), content.end(), '\n');
+	if (2 + producers * per_producer != lines)
+	{
+		log_err "missing logs, lines=%u", lines log_end;
+		return false;
+	}
+
+	log_info "%u logs, %llu WriteFile() calls", lines, writes log_end;
+
+	//
+	//  1 MB ̹Ƿ batch_size (256 KB)   4 , flush_interval   
+	//  α׸   . 尡 α׸  ߿ flush_interval  
+	//  츦 ص 8   ȵȴ.
+	// 
+	if (writes > 8)
+	{
+		log_err "too many WriteFile() calls, writes=%llu", writes log_end;
+		return false;
+	}
+
+	DeleteFileW(path.c_str());
+	return true;
+}
+
+/// @brief	α   (maintenance thread)
+bool test_log_rotate_background()
+{
+	const uint32_t producers = 4;
+	const uint32_t per_producer = 20125;
+	const uint32_t max_log_count = 1000;
+	const uint32_t max_log_files = 3;
+
+	std::wstring dir = get_current_module_dirEx();
+	std::wstring path = dir + L"\\test_log_rotate_bg.log";
+	std::wstring pattern = dir + L"\\test_log_rotate_bg.*.log";
+	std::vector<std::wstring> files;
+	auto list_files = [&]()
+	{
+		files.clear();
+		find_files(pattern.c_str(), [](DWORD_PTR tag, const wchar_t* file_path)->bool {
+			((std::vector<std::wstring>*)tag)->push_back(file_path);
+			return true;
+		}, (DWORD_PTR)&files, false);
+	};
+	list_files();
+	for (const auto& file : files) { DeleteFileW(file.c_str()); }
+	DeleteFileW(path.c_str());
+
+	{
+		slogger logger(log_level_debug,
+					   log_to_file,
+					   path.c_str(),
+					   max_log_count,
+					   max_log_files,
+					   false,
+					   _log_batch_size_def,
+					   0,
+					   log_sync_never,
+					   true);
+		if (true != logger.slog_start()) return false;
+
+		StopWatch sw; sw.Start();
+		boost::thread_group threads;
+		for (uint32_t id = 0; id < producers; ++id)
+		{
+			threads.create_thread([&logger, id, per_producer]()
+			{
+				char msg[64];
+				for (uint32_t i = 0; i < per_producer; ++i)
+				{
+					StringCbPrintfA(msg, sizeof(msg), "producer=%u, seq=%u\n", id, i);
+					logger.slog_write(log_level_info, msg);
+				}
+			});
+		}
+		threads.join_all();
+		sw.Stop();
+		logger.slog_stop();
+
+		log_info "%u logs, %u rotations, %.3f ms",
+			producers * per_producer,
+			producers * per_producer / max_log_count,
+			sw.GetDurationMilliSecond()
+			log_end;
+	}
+
+	//
+	//  α  ǰ, ̸   α   ʾƾ Ѵ.
+	// 
+	list_files();
+	if (max_log_files != files.size() || 
+		true == is_file_existsW((path + L".next").c_str()))
+	{
+		log_err "rotated files=%u", (uint32_t)files.size() log_end;
+		return false;
+	}
+
+	//
+	//   α  max_log_count  α׿  ޼ Ѵ.
+	// 
+	files.push_back(path);
+	for (const auto& file : files)
+	{
+		std::string content;
+		if (true != read_test_log(file.c_str(), content)) return false;
+
+		uint32_t lines = (uint32_t)std::count(content.begin(), content.end(), '\n');
+		uint32_t expected = (file == path) ? 
+			(producers * per_producer) % max_log_count : 
+			max_log_count;
+		if (expected != lines || 
+			(file != path && std::string::npos == content.find("> log rotated -> ")))
+		{
+			log_err "unexpected log file, %ws, lines=%u", file.c_str(), lines log_end;
+			return false;
+		}
+		DeleteFileW(file.c_str());
+	}
+	return true;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file    logging benchmark for log.h/cpp
+ * @brief	producer  (1 ~ 64), log_to_xxx , decoration  
+ *			log_write_fmt()  ȣ latency (p50/p99/p99.9/max) 
+ *			ʴ ó, ring buffer , / α  Ѵ.
+ *
+ *			 ึ  ޼,   ϹǷ  /
+ *			 ״   ִ.
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+#include "stdafx.h"
+#include <algorithm>
+#include "log.h"
+#include "StopWatch.h"
+
+/// @brief	ѹ    α  (producer   )
+///			ܼ     .
+#define _log_bench_messages			(64 * 1024)
+#define _log_bench_con_messages		(4 * 1024)
+
+/// @brief	ġũ 
+typedef struct log_bench_result
+{
+	uint32_t	producers;
+	uint32_t	log_to;
+	bool		decorate;
+	uint32_t	messages;
+	double		p50;			///< usec
+	double		p99;
+	double		p999;
+	double		max;
+	double		produce_rate;	///< producer  α׸  ӵ (msgs/sec)
+	double		drain_rate;		///<  αװ µ  ӵ (msgs/sec)
+	uint64_t	max_depth;		///<     ring buffer 
+	uint64_t	dropped;
+	uint64_t	delayed;
+	uint64_t	file_writes;
+} *plog_bench_result;
+
+/// @brief	ĵ latency  percentile  (usec)  Ѵ.
+static double
+latency_percentile(
+	_In_ const std::vector<uint64_t>& sorted,
+	_In_ double percentile,
+	_In_ double ticks_per_usec
+	)
+{
+	if (true == sorted.empty()) return 0.0;
+
+	size_t index = (size_t)(percentile / 100.0 * (double)(sorted.size() - 1) + 0.5);
+	return (double)sorted[std::min(index, sorted.size() - 1)] / ticks_per_usec;
+}
+
+/// @brief	producers  忡 messages  α׸ ,  Ѵ.
+static bool
+run_log_benchmark(
+	_In_ uint32_t producers,
+	_In_ uint32_t log_to,
+	_In_ bool decorate,
+	_In_ uint32_t messages,
+	_Out_ log_bench_result& result
+	)
+{
+	std::wstring path = get_current_module_dirEx() + L"\\test_log_benchmark.log";
+	DeleteFileW(path.c_str());
+
+	const uint32_t per_producer = messages / producers;
+	result.producers = producers;
+	result.log_to = log_to;
+	result.decorate = decorate;
+	result.messages = per_producer * producers;
+
+	if (true == decorate)
+	{
+		set_log_format(true, true, true, true);
+	}
+	if (true != initialize_log(log_mask_all,
+							   log_level_debug,
+							   log_to,
+							   FlagOn(log_to, log_to_file) ? path.c_str() : nullptr,
+							   result.messages + 1,	//  ߿   ʴ´.
+							   2))
+	{
+		return false;
+	}
+
+	//
+	//  producer  غ  ÿ Ѵ.
+	// latency  QueryPerformanceCounter()  .
+	//
+	std::vector<std::vector<uint64_t>> latencies(producers);
+	for (auto& latency : latencies) { latency.resize(per_producer); }
+
+	boost::barrier start(producers + 1);
+	std::atomic<uint32_t> running(producers);
+	boost::thread_group threads;
+	for (uint32_t id = 0; id < producers; ++id)
+	{
+		threads.create_thread([&, id]()
+		{
+			std::vector<uint64_t>& latency = latencies[id];
+			LARGE_INTEGER begin;
+			LARGE_INTEGER end;
+
+			start.wait();
+			for (uint32_t i = 0; i < per_producer; ++i)
+			{
+				QueryPerformanceCounter(&begin);
+				if (true == decorate)
+				{
+					log_write_fmt_static(log_mask_sys,
+										 log_level_info,
+										 __FUNCTION__,
+										 "benchmark, producer=%u, seq=%u, value=%s",
+										 id,
+										 i,
+										 "0123456789abcdef");
+				}
+				else
+				{
+					log_write_fmt_without_deco_static(log_mask_sys,
+													  log_level_info,
+													  "benchmark, producer=%u, seq=%u, value=%s",
+													  id,
+													  i,
+													  "0123456789abcdef");
+				}
+				QueryPerformanceCounter(&end);
+				latency[i] = (uint64_t)(end.QuadPart - begin.QuadPart);
+			}
+			--running;
+		});
+	}
+
+	//
+	// producer  α׸   ring buffer ̸ øѴ.
+	//
+	StopWatch produce_sw;
+	StopWatch drain_sw;
+	start.wait();
+	produce_sw.Start();
+	drain_sw.Start();
+
+	result.max_depth = 0;
+	log_stats stats = { 0 };
+	while (0 < running)
+	{
+		if (true == get_log_stats(stats))
+		{
+			result.max_depth = std::max(result.max_depth, stats.queue_depth);
+		}
+		Sleep(1);
+	}
+	threads.join_all();
+	produce_sw.Stop();
+
+	get_log_stats(stats);
+	result.dropped = stats.dropped;
+	result.delayed = stats.delayed;
+	result.file_writes = stats.file_writes;
+
+	//  α׸    ٸ.
+	finalize_log();
+	drain_sw.Stop();
+
+	//
+	// 
+	//
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	double ticks_per_usec = (double)freq.QuadPart / 1000000.0;
+
+	std::vector<uint64_t> all;
+	all.reserve(result.messages);
+	for (const auto& latency : latencies)
+	{
+		all.insert(all.end(), latency.begin(), latency.end());
+	}
+	std::sort(all.begin(), all.end());
+
+	result.p50 = latency_percentile(all, 50.0, ticks_per_usec);
+	result.p99 = latency_percentile(all, 99.0, ticks_per_usec);
+	result.p999 = latency_percentile(all, 99.9, ticks_per_usec);
+	result.max = latency_percentile(all, 100.0, ticks_per_usec);
+	result.produce_rate = (double)result.messages / std::max(produce_sw.GetDurationSecond(), 0.000001f);
+	result.drain_rate = (double)result.messages / std::max(drain_sw.GetDurationSecond(), 0.000001f);
+
+	DeleteFileW(path.c_str());
+	return true;
+}
+
+/// @brief	logging ġũ
+///			ܼ  ϴ   ̿ αװ  µȴ.
+bool test_log_benchmark()
+{
+	static const uint32_t producer_counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+	static const uint32_t sinks[] = {
+		log_to_file,
+		log_to_ods,
+		log_to_con,
+		log_to_file | log_to_ods,
+		log_to_file | log_to_con,
+		log_to_ods | log_to_con,
+		log_to_all
+	};
+
+	bool show_current_time, show_process_name, show_pid_tid, show_function_name;
+	get_log_format(show_current_time, show_process_name, show_pid_tid, show_function_name);
+	uint32_t prev_log_level = get_log_level();
+	uint32_t prev_log_to = get_log_to();
+
+	std::vector<log_bench_result> results;
+	bool ret = true;
+	for (uint32_t sink : sinks)
+	{
+		for (int decorate = 1; decorate >= 0 && true == ret; --decorate)
+		{
+			for (uint32_t producers : producer_counts)
+			{
+				log_bench_result result;
+				ret = run_log_benchmark(producers,
+										sink,
+										(1 == decorate),
+										FlagOn(sink, log_to_con) ? _log_bench_con_messages : _log_bench_messages,
+										result);
+				set_log_format(show_current_time, show_process_name, show_pid_tid, show_function_name);
+				if (true != ret) break;
+
+				results.push_back(result);
+			}
+		}
+	}
+	set_log_env(log_mask_all, prev_log_level, prev_log_to);
+	if (true != ret) return false;
+
+	log_info "%-18s %-5s %4s %8s %8s %8s %8s %8s %12s %12s %6s %7s %7s %7s",
+		"log_to",
+		"deco",
+		"thrd",
+		"msgs",
+		"p50(us)",
+		"p99(us)",
+		"p999(us)",
+		"max(us)",
+		"produce/s",
+		"drain/s",
+		"depth",
+		"dropped",
+		"delayed",
+		"writes"
+		log_end;
+	for (const auto& result : results)
+	{
+		log_info "%-18s %-5s %4u %8u %8.2f %8.2f %8.2f %8.2f %12.0f %12.0f %6llu %7llu %7llu %7llu",
+			log_to_to_str(result.log_to),
+			(true == result.decorate) ? "yes" : "no",
+			result.producers,
+			result.messages,
+			result.p50,
+			result.p99,
+			result.p999,
+			result.max,
+			result.produce_rate,
+			result.drain_rate,
+			result.max_depth,
+			result.dropped,
+			result.delayed,
+			result.file_writes
+			log_end;
+	}
+	return true;
+}
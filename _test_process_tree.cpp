@@ -201,4 +201,26 @@ bool test_get_process_creation_time()
 		log_end;
 
 	return true;
-}
\ No newline at end of file
+}
+
+/// @brief	get_known_process_type(), find_process(known_process_type)
+bool test_known_process()
+{
+	if (known_process_system != get_known_process_type(_system_proc_)) return false;
+	if (known_process_explorer != get_known_process_type(L"EXPLORER.EXE")) return false;
+	if (known_process_idle != get_known_process_type(_idle_proc_)) return false;
+	if (known_process_unknown != get_known_process_type(L"explorer.ex")) return false;
+	if (known_process_unknown != get_known_process_type(L"notepad.exe")) return false;
+	if (known_process_unknown != get_known_process_type(L"")) return false;
+
+	cprocess_tree proc_tree;
+	if (!proc_tree.build_process_tree(true)) return false;
+
+	DWORD pid = proc_tree.find_process(known_process_explorer);
+	if (pid != proc_tree.find_process(_explorer_proc_)) return false;
+
+	if (_system_proc_pid != proc_tree.find_process(known_process_system)) return false;
+
+	log_info "explorer pid=%u", pid log_end;
+	return true;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file    tests for ring_queue.h
+ * @brief
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+#include "stdafx.h"
+#include "ring_queue.h"
+#include "StopWatch.h"
+
+bool test_ring_queue_mpmc();
+bool test_ring_queue_spsc();
+bool test_ring_queue_move_only();
+
+bool test_ring_queue()
+{
+	if (true != test_ring_queue_mpmc()) return false;
+	if (true != test_ring_queue_spsc()) return false;
+	if (true != test_ring_queue_move_only()) return false;
+	return true;
+}
+
+/// @brief	4 producers, 4 consumers, every value delivered exactly once.
+bool test_ring_queue_mpmc()
+{
+	const uint32_t producers = 4;
+	const uint32_t per_producer = 100000;
+
+	ring_queue<uint64_t> q(1024, true);
+	std::atomic<uint64_t> sum(0);
+	std::atomic<uint32_t> received(0);
+
+	StopWatch sw; sw.Start();
+	boost::thread_group threads;
+	for (uint32_t p = 0; p < producers; ++p)
+	{
+		threads.create_thread([&q, p, per_producer]()
+		{
+			uint64_t batch[16];
+			uint32_t i = 0;
+			while (i < per_producer)
+			{
+				// half of the values one by one, the other half in batches.
+				if (0 == (i & 1))
+				{
+					q.push((uint64_t)p * per_producer + i);
+					++i;
+					continue;
+				}
+
+				std::size_t n = 0;
+				while (n < 16 && i + n < per_producer)
+				{
+					batch[n] = (uint64_t)p * per_producer + i + n;
+					++n;
+				}
+				std::size_t pushed = q.push_n(batch, n);
+				if (0 == pushed) boost::this_thread::yield();
+				i += (uint32_t)pushed;
+			}
+		});
+	}
+
+	for (uint32_t c = 0; c < producers; ++c)
+	{
+		threads.create_thread([&]()
+		{
+			uint64_t batch[8];
+			while (received.load() < producers * per_producer)
+			{
+				std::size_t n = q.pop_n(batch, 8);
+				if (0 == n)
+				{
+					if (true == q.pop_for(batch[0], 10)) n = 1;
+				}
+
+				for (std::size_t i = 0; i < n; ++i) { sum += batch[i]; }
+				received += (uint32_t)n;
+			}
+		});
+	}
+	threads.join_all();
+	sw.Stop();
+
+	uint64_t total = (uint64_t)producers * per_producer;
+	uint64_t expected = total * (total - 1) / 2;
+	log_info "mpmc: %llu items, %.0f items/sec",
+		total,
+		total / sw.GetDurationSecond()
+		log_end;
+
+	return (expected == sum.load() && true == q.empty()) ? true : false;
+}
+
+/// @brief	Single producer, single consumer keeps the order.
+bool test_ring_queue_spsc()
+{
+	const uint32_t count = 1000000;
+	ring_queue<uint32_t, ring_spsc> q(256, true);
+	bool in_order = true;
+
+	boost::thread consumer([&]()
+	{
+		uint32_t expected = 0;
+		uint32_t value;
+		while (expected < count)
+		{
+			if (true != q.pop(value)) break;
+			if (value != expected++) { in_order = false; break; }
+		}
+	});
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		q.push(std::move(i));
+	}
+	consumer.join();
+
+	return (true == in_order && true == q.empty()) ? true : false;
+}
+
+/// @brief	Move-only elements, full/empty edges, non-blocking queue.
+bool test_ring_queue_move_only()
+{
+	ring_queue<std::unique_ptr<int>> q(4);
+	if (4 != q.capacity()) return false;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		if (true != q.try_push(std::unique_ptr<int>(new int(i)))) return false;
+	}
+
+	// Full: the value is not consumed and push() does not wait.
+	std::unique_ptr<int> extra(new int(4));
+	if (true == q.try_push(std::move(extra)) || !extra) return false;
+	if (true == q.push(std::move(extra)) || !extra) return false;
+
+	std::unique_ptr<int> out;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (true != q.try_pop(out) || i != *out) return false;
+	}
+	if (true == q.try_pop(out)) return false;
+
+	// Elements left in the queue are destroyed with it.
+	ring_queue<std::unique_ptr<int>, ring_spsc> spsc(2);
+	spsc.try_push(std::unique_ptr<int>(new int(0)));
+	return true;
+}
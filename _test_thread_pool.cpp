@@ -0,0 +1,447 @@
+/**
+ * @file    tests for thread_pool.h
+ * @brief
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+#include "stdafx.h"
+#include "thread_pool.h"
+#include "task_graph.h"
+#include "md5.h"
+#include "sha2.h"
+#include "StopWatch.h"
+#include <map>
+
+#ifdef _DEBUG
+static std::atomic<uint64_t> _alloc_count(0);
+
+/// @brief	Counts every heap allocation made through the debug CRT.
+static
+int
+__cdecl
+count_alloc_hook(
+	_In_ int alloc_type,
+	_In_ void* user_data,
+	_In_ size_t size,
+	_In_ int block_type,
+	_In_ long request_number,
+	_In_ const unsigned char* file_name,
+	_In_ int line_number
+	)
+{
+	UNREFERENCED_PARAMETER(user_data);
+	UNREFERENCED_PARAMETER(size);
+	UNREFERENCED_PARAMETER(request_number);
+	UNREFERENCED_PARAMETER(file_name);
+	UNREFERENCED_PARAMETER(line_number);
+
+	if (_CRT_BLOCK != block_type &&
+		(_HOOK_ALLOC == alloc_type || _HOOK_REALLOC == alloc_type))
+	{
+		++_alloc_count;
+	}
+	return TRUE;
+}
+#endif//_DEBUG
+
+static uint64_t _alloc_count_snapshot()
+{
+#ifdef _DEBUG
+	return _alloc_count.load();
+#else
+	return 0;
+#endif
+}
+
+/// @brief	Posts tasks from outside (injection queue) and from inside of
+///			the workers (own deque), then checks every accepted task ran.
+bool test_thread_pool_work_stealing()
+{
+	const std::size_t pool_size = 2 * boost::thread::hardware_concurrency();
+	const uint32_t task_count = 100000;
+
+	std::atomic<uint32_t> posted(0);
+	std::atomic<uint32_t> executed(0);
+
+	StopWatch sw; sw.Start();
+	{
+		thread_pool pool(pool_size);
+		for (uint32_t i = 0; i < task_count; ++i)
+		{
+			while (true != pool.run_task([&]()
+			{
+				++executed;
+
+				// Nested task goes to this worker's own deque and is
+				// stolen by the others if they run out of work.
+				if (true == pool.run_task([&]() { ++executed; }))
+				{
+					++posted;
+				}
+			}))
+			{
+				boost::this_thread::yield();
+			}
+			++posted;
+		}
+
+		while (true != pool.is_idle())
+		{
+			boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+		}
+	}
+	sw.Stop();
+
+	log_info "pool size=%u, posted=%u, executed=%u, elapsed=%f sec",
+		(uint32_t)pool_size,
+		posted.load(),
+		executed.load(),
+		sw.GetDurationSecond()
+		log_end;
+
+	return (posted.load() == executed.load()) ? true : false;
+}
+
+/// @brief	Bounded mode: producers park on a full queue instead of spinning
+///			and results come back through submit()'s future.
+bool test_thread_pool_bounded()
+{
+	const uint32_t task_count = 100000;
+	std::atomic<uint32_t> executed(0);
+
+	{
+		thread_pool pool(boost::thread::hardware_concurrency(), 64);
+		for (uint32_t i = 0; i < task_count; ++i)
+		{
+			if (true != pool.run_task([&]() { ++executed; }))
+			{
+				log_err "run_task() failed. i=%u", i log_end;
+				return false;
+			}
+		}
+
+		std::vector<std::future<uint64_t>> results;
+		for (uint64_t i = 0; i < 1000; ++i)
+		{
+			results.push_back(pool.submit([i]() { return i * i; }));
+		}
+
+		uint64_t sum = 0;
+		for (auto& result : results)
+		{
+			sum += result.get();
+		}
+		if (332833500 != sum)
+		{
+			log_err "invalid sum of squares. sum=%llu", sum log_end;
+			return false;
+		}
+
+		// Exceptions travel through the future.
+		std::future<int> failed = pool.submit([]() -> int
+		{
+			throw std::runtime_error("task failed");
+		});
+		try
+		{
+			failed.get();
+			log_err "exception expected" log_end;
+			return false;
+		}
+		catch (const std::runtime_error&) {}
+
+		while (true != pool.is_idle())
+		{
+			boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+		}
+	}
+
+	if (task_count != executed.load())
+	{
+		log_err "executed=%u, expected=%u", executed.load(), task_count log_end;
+		return false;
+	}
+
+	//
+	// run_task_for() gives up when the only thread stays busy.
+	//
+	thread_pool single(1);
+	single.run_task([]() { boost::this_thread::sleep_for(boost::chrono::milliseconds(500)); });
+	if (true == single.run_task_for([]() {}, 50))
+	{
+		log_err "run_task_for() should time out" log_end;
+		return false;
+	}
+	if (true != single.run_task_for([]() {}, 2000))
+	{
+		log_err "run_task_for() failed" log_end;
+		return false;
+	}
+	return true;
+}
+
+/// @brief	Allocation count and throughput of short tasks whose captures
+///			fill most of pool_task's inline buffer.
+///			Allocations are counted with the debug CRT hook only.
+bool test_thread_pool_task_alloc()
+{
+	struct payload { uint64_t v[12]; };
+	payload p = {};
+	p.v[0] = 1;
+
+	const uint32_t task_count = 1000000;
+	std::atomic<uint64_t> sum(0);
+
+#ifdef _DEBUG
+	_CRT_ALLOC_HOOK prev_hook = _CrtSetAllocHook(count_alloc_hook);
+#endif
+
+	//
+	// pool_task by itself: construct, move, invoke.
+	//
+	uint64_t task_allocs = _alloc_count_snapshot();
+	for (uint32_t i = 0; i < task_count; ++i)
+	{
+		pool_task task([p, &sum]() { sum += p.v[0]; });
+		pool_task moved(std::move(task));
+		moved();
+	}
+	task_allocs = _alloc_count_snapshot() - task_allocs;
+
+	//
+	// through the pool. Warm up first so that every ring has reached its
+	// working size.
+	//
+	uint64_t pool_allocs = 0;
+	StopWatch sw;
+	{
+		thread_pool pool(boost::thread::hardware_concurrency(), 1024);
+		for (uint32_t i = 0; i < 10000; ++i)
+		{
+			pool.run_task([p, &sum]() { sum += p.v[0]; });
+		}
+		while (true != pool.is_idle()) { boost::this_thread::yield(); }
+
+		pool_allocs = _alloc_count_snapshot();
+		sw.Start();
+		for (uint32_t i = 0; i < task_count; ++i)
+		{
+			pool.run_task([p, &sum]() { sum += p.v[0]; });
+		}
+		while (true != pool.is_idle()) { boost::this_thread::yield(); }
+		sw.Stop();
+		pool_allocs = _alloc_count_snapshot() - pool_allocs;
+	}
+
+#ifdef _DEBUG
+	_CrtSetAllocHook(prev_hook);
+#else
+	log_info "allocation counts need the debug CRT, throughput only." log_end;
+#endif
+
+	log_info
+		"sizeof(pool_task)=%u, tasks=%u, %.0f tasks/sec, allocs: task=%llu, pool=%llu",
+		(uint32_t)sizeof(pool_task),
+		task_count,
+		task_count / sw.GetDurationSecond(),
+		task_allocs,
+		pool_allocs
+		log_end;
+
+	if (sum.load() != 2 * task_count + 10000)
+	{
+		log_err "sum=%llu, not all tasks ran", sum.load() log_end;
+		return false;
+	}
+
+	// Producers and workers may park now and then, which allocates inside
+	// boost::condition_variable, but never once per task.
+	return (0 == task_allocs && pool_allocs < task_count / 100) ? true : false;
+}
+
+/// @brief	parallel_for, parallel_for_each, parallel_reduce, parallel_sort
+bool test_parallel_algorithms()
+{
+	thread_pool pool(boost::thread::hardware_concurrency());
+
+	//
+	// parallel_for: every index exactly once.
+	//
+	std::vector<uint32_t> hits(1000000, 0);
+	parallel_for(pool, 0, (int)hits.size(), [&](int i)
+	{
+		++hits[i];
+	});
+	if (hits.end() != std::find_if(hits.begin(), hits.end(), [](uint32_t h) { return 1 != h; }))
+	{
+		log_err "parallel_for() missed or repeated an index" log_end;
+		return false;
+	}
+
+	//
+	// parallel_for_each over a random access and a forward range.
+	//
+	std::atomic<uint64_t> sum(0);
+	std::vector<uint64_t> numbers(100000);
+	for (uint64_t i = 0; i < numbers.size(); ++i) { numbers[i] = i; }
+	parallel_for_each(pool, numbers.begin(), numbers.end(), [&](uint64_t& n)
+	{
+		sum += n;
+	});
+
+	std::map<uint32_t, uint64_t> process_map;
+	for (uint32_t i = 0; i < 1000; ++i) { process_map[i * 4] = i; }
+	parallel_for_each(pool, process_map.begin(), process_map.end(), [&](std::pair<const uint32_t, uint64_t>& p)
+	{
+		sum += p.second;
+	});
+	if (4999950000 + 499500 != sum.load())
+	{
+		log_err "parallel_for_each() failed. sum=%llu", sum.load() log_end;
+		return false;
+	}
+
+	//
+	// parallel_reduce
+	//
+	uint64_t total = parallel_reduce(pool,
+									 (uint64_t)0,
+									 (uint64_t)numbers.size(),
+									 (uint64_t)0,
+									 [&](uint64_t i) { return numbers[(size_t)i]; },
+									 [](uint64_t a, uint64_t b) { return a + b; });
+	if (4999950000 != total)
+	{
+		log_err "parallel_reduce() failed. total=%llu", total log_end;
+		return false;
+	}
+
+	//
+	// parallel_sort against std::sort
+	//
+	std::vector<uint32_t> values(2000000);
+	uint32_t x = 2463534242;
+	for (auto& v : values) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; v = x; }
+	std::vector<uint32_t> expected(values);
+
+	StopWatch sw; sw.Start();
+	std::sort(expected.begin(), expected.end());
+	sw.Stop();
+	float serial = sw.GetDurationMilliSecond();
+
+	sw.Start();
+	parallel_sort(pool, values.begin(), values.end());
+	sw.Stop();
+	log_info "sort %u items, std::sort=%.2f ms, parallel_sort=%.2f ms",
+		(uint32_t)values.size(),
+		serial,
+		sw.GetDurationMilliSecond()
+		log_end;
+	if (values != expected)
+	{
+		log_err "parallel_sort() failed" log_end;
+		return false;
+	}
+
+	//
+	// Exception from the body reaches the caller.
+	//
+	try
+	{
+		parallel_for(pool, 0, 100000, [](int i)
+		{
+			if (77777 == i) throw std::runtime_error("oops");
+		});
+		log_err "exception expected" log_end;
+		return false;
+	}
+	catch (const std::runtime_error&) {}
+
+	return true;
+}
+
+/// @brief	read chunk -> md5 + sha256 -> store, as a task graph.
+bool test_task_graph()
+{
+	struct chunk
+	{
+		std::vector<uint8_t> data;
+		uint8_t md5[16];
+		uint8_t sha256[32];
+		bool stored;
+	};
+
+	thread_pool pool(2);
+
+	std::vector<std::shared_ptr<chunk>> chunks;
+	std::vector<task_node> stores;
+	for (uint32_t i = 0; i < 64; ++i)
+	{
+		std::shared_ptr<chunk> c = std::make_shared<chunk>();
+		c->stored = false;
+		chunks.push_back(c);
+
+		task_node read = spawn_task(pool, [c, i]()
+		{
+			c->data.assign(64 * 1024, (uint8_t)i);
+		});
+		task_node md5 = read.then([c]()
+		{
+			MD5_CTX ctx;
+			MD5Init(&ctx, 0);
+			MD5Update(&ctx, c->data.data(), (unsigned int)c->data.size());
+			MD5Final(&ctx);
+			memcpy(c->md5, ctx.digest, sizeof(c->md5));
+		});
+		task_node sha = read.then([c]()
+		{
+			sha256(c->sha256, c->data.data(), (unsigned long)c->data.size());
+		});
+		stores.push_back(when_all({ md5, sha }).then([c]()
+		{
+			c->stored = true;
+		}));
+	}
+
+	// More pending nodes than pool threads, none of them blocks a worker.
+	when_all(stores).wait();
+
+	for (const auto& c : chunks)
+	{
+		uint8_t expected[32];
+		sha256(expected, c->data.data(), (unsigned long)c->data.size());
+		if (true != c->stored || 0 != memcmp(expected, c->sha256, sizeof(expected)))
+		{
+			log_err "invalid chunk" log_end;
+			return false;
+		}
+	}
+
+	//
+	// when_any completes with the first node; failures propagate downstream.
+	//
+	std::atomic<bool> release(false);
+	task_node slow = spawn_task(pool, [&]()
+	{
+		while (true != release) { boost::this_thread::sleep_for(boost::chrono::milliseconds(1)); }
+	});
+	task_node fast = spawn_task(pool, []() {});
+	when_any({ slow, fast }).wait();
+	release = true;
+	slow.wait();
+
+	bool skipped = true;
+	task_node failed = spawn_task(pool, []() { throw std::runtime_error("read failed"); })
+		.then([&]() { skipped = false; });
+	try
+	{
+		failed.wait();
+		log_err "exception expected" log_end;
+		return false;
+	}
+	catch (const std::runtime_error&) {}
+
+	return skipped;
+}
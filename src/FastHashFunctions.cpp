@@ -0,0 +1,925 @@
+#include "stdafx.h"
+#include <string.h>
+#include "sha2.h"
+#include "FastHashFunctions.h"
+
+/*
+ * xxHash  : Yann Collet, https://github.com/Cyan4973/xxHash (BSD 2-Clause)
+ * wyhash  : Wang Yi, https://github.com/wangyi-fudan/wyhash (public domain)
+ */
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define FAST_HASH_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#endif
+
+#if defined(__GNUC__)
+#  define FAST_HASH_TARGET(x) __attribute__((target(x)))
+#else
+#  define FAST_HASH_TARGET(x)
+#endif
+
+#if defined(_MSC_VER)
+#  define FAST_HASH_ROTL64(x, r) _rotl64((x), (r))
+#else
+#  define FAST_HASH_ROTL64(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+#endif
+
+static const uint64_t P64_1 = UINT64_C(0x9E3779B185EBCA87);
+static const uint64_t P64_2 = UINT64_C(0xC2B2AE3D27D4EB4F);
+static const uint64_t P64_3 = UINT64_C(0x165667B19E3779F9);
+static const uint64_t P64_4 = UINT64_C(0x85EBCA77C2B2AE63);
+static const uint64_t P64_5 = UINT64_C(0x27D4EB2F165667C5);
+static const uint32_t P32_1 = 0x9E3779B1U;
+
+
+static inline uint64_t fast_hash_load64(const unsigned char* p)
+{
+#if defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64) || \
+    (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+   uint64_t v;
+   memcpy(&v, p, sizeof(v));
+   return v;
+#else
+   return (uint64_t)p[0]         | ((uint64_t)p[1] << 8)  | ((uint64_t)p[2] << 16) |
+          ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+          ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+#endif
+}
+
+
+static inline uint64_t fast_hash_load32(const unsigned char* p)
+{
+#if defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64) || \
+    (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+   uint32_t v;
+   memcpy(&v, p, sizeof(v));
+   return v;
+#else
+   return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24);
+#endif
+}
+
+
+/* 64 x 64 -> 128 bit multiply, *a = low, *b = high */
+static inline void fast_hash_mum(uint64_t* a, uint64_t* b)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+   *a = _umul128(*a, *b, b);
+#elif defined(__SIZEOF_INT128__)
+   unsigned __int128 r = (unsigned __int128)(*a) * (*b);
+   *a = (uint64_t)r;
+   *b = (uint64_t)(r >> 64);
+#else
+   uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+   uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+   uint64_t t  = rl + (rm0 << 32);
+   uint64_t c  = (t < rl);
+   uint64_t lo = t + (rm1 << 32);
+   c += (lo < t);
+   *a = lo;
+   *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+
+static inline uint64_t fast_hash_mix(uint64_t a, uint64_t b)
+{
+   fast_hash_mum(&a, &b);
+   return a ^ b;
+}
+
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input)
+{
+   acc += input * P64_2;
+   acc  = FAST_HASH_ROTL64(acc, 31);
+   return acc * P64_1;
+}
+
+
+static inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t val)
+{
+   acc ^= xxh64_round(0, val);
+   return acc * P64_1 + P64_4;
+}
+
+
+/* 32 byte stripes while p <= limit */
+static const unsigned char* xxh64_consume(uint64_t v[4], const unsigned char* p, const unsigned char* limit)
+{
+   uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+
+   while(p <= limit)
+   {
+      v1 = xxh64_round(v1, fast_hash_load64(p));
+      v2 = xxh64_round(v2, fast_hash_load64(p + 8));
+      v3 = xxh64_round(v3, fast_hash_load64(p + 16));
+      v4 = xxh64_round(v4, fast_hash_load64(p + 24));
+      p += 32;
+   }
+
+   v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+   return p;
+}
+
+
+static void xxh64_reset(uint64_t v[4], uint64_t seed)
+{
+   v[0] = seed + P64_1 + P64_2;
+   v[1] = seed + P64_2;
+   v[2] = seed;
+   v[3] = seed - P64_1;
+}
+
+
+static uint64_t xxh64_converge(const uint64_t v[4])
+{
+   uint64_t hash = FAST_HASH_ROTL64(v[0], 1) + FAST_HASH_ROTL64(v[1], 7) + FAST_HASH_ROTL64(v[2], 12) + FAST_HASH_ROTL64(v[3], 18);
+   hash = xxh64_merge_round(hash, v[0]);
+   hash = xxh64_merge_round(hash, v[1]);
+   hash = xxh64_merge_round(hash, v[2]);
+   hash = xxh64_merge_round(hash, v[3]);
+   return hash;
+}
+
+
+/* the last (len % 32) bytes and avalanche */
+static uint64_t xxh64_finalize(uint64_t hash, const unsigned char* p, const unsigned char* end)
+{
+   for(; p + 8 <= end; p += 8)
+   {
+      hash ^= xxh64_round(0, fast_hash_load64(p));
+      hash  = FAST_HASH_ROTL64(hash, 27) * P64_1 + P64_4;
+   }
+
+   if(p + 4 <= end)
+   {
+      hash ^= fast_hash_load32(p) * P64_1;
+      hash  = FAST_HASH_ROTL64(hash, 23) * P64_2 + P64_3;
+      p += 4;
+   }
+
+   for(; p < end; p++)
+   {
+      hash ^= (*p) * P64_5;
+      hash  = FAST_HASH_ROTL64(hash, 11) * P64_1;
+   }
+
+   hash ^= hash >> 33;
+   hash *= P64_2;
+   hash ^= hash >> 29;
+   hash *= P64_3;
+   hash ^= hash >> 32;
+   return hash;
+}
+
+
+uint64_t XXHash64(const void* data, uint64_t len, uint64_t seed)
+{
+   const unsigned char* p   = (const unsigned char*)data;
+   const unsigned char* end = p + len;
+   uint64_t hash;
+
+   if(len >= 32)
+   {
+      uint64_t v[4];
+      xxh64_reset(v, seed);
+      p = xxh64_consume(v, p, end - 32);
+      hash = xxh64_converge(v);
+   }
+   else
+   {
+      hash = seed + P64_5;
+   }
+
+   return xxh64_finalize(hash + len, p, end);
+}
+/* End Of XXHash64 Function */
+
+
+void XXHash64Init(XXHash64_ctx* ctx, uint64_t seed)
+{
+   ctx->total   = 0;
+   ctx->pending = 0;
+   ctx->seed    = seed;
+   xxh64_reset(ctx->v, seed);
+}
+
+
+void XXHash64Update(XXHash64_ctx* ctx, const void* data, uint64_t len)
+{
+   const unsigned char* p   = (const unsigned char*)data;
+   const unsigned char* end = p + len;
+
+   ctx->total += len;
+
+   if(ctx->pending + len < 32)
+   {
+      memcpy(ctx->buf + ctx->pending, p, (size_t)len);
+      ctx->pending += (uint32_t)len;
+      return;
+   }
+
+   if(0 != ctx->pending)
+   {
+      const uint32_t fill = 32 - ctx->pending;
+      memcpy(ctx->buf + ctx->pending, p, fill);
+      xxh64_consume(ctx->v, ctx->buf, ctx->buf);
+      p += fill;
+      ctx->pending = 0;
+   }
+
+   if(end - p >= 32)
+   {
+      p = xxh64_consume(ctx->v, p, end - 32);
+   }
+
+   memcpy(ctx->buf, p, (size_t)(end - p));
+   ctx->pending = (uint32_t)(end - p);
+}
+
+
+uint64_t XXHash64Final(const XXHash64_ctx* ctx)
+{
+   uint64_t hash;
+
+   if(ctx->total >= 32)
+   {
+      hash = xxh64_converge(ctx->v);
+   }
+   else
+   {
+      hash = ctx->seed + P64_5;
+   }
+
+   return xxh64_finalize(hash + ctx->total, ctx->buf, ctx->buf + ctx->pending);
+}
+/* End Of XXHash64 Stream */
+
+
+static const uint64_t wyhash_secret[4] =
+{
+   UINT64_C(0x2d358dccaa6c78a5), UINT64_C(0x8bb84b93962eacc9),
+   UINT64_C(0x4b33a62ed433d4a3), UINT64_C(0x4d5a2da51de1aa47)
+};
+
+
+static inline uint64_t wyhash_seed(uint64_t seed)
+{
+   return seed ^ fast_hash_mix(seed ^ wyhash_secret[0], wyhash_secret[1]);
+}
+
+
+/* three independent multiply chains per 48 bytes */
+static inline void wyhash_48(uint64_t* seed, uint64_t* see1, uint64_t* see2, const unsigned char* p)
+{
+   *seed = fast_hash_mix(fast_hash_load64(p)      ^ wyhash_secret[1], fast_hash_load64(p + 8)  ^ *seed);
+   *see1 = fast_hash_mix(fast_hash_load64(p + 16) ^ wyhash_secret[2], fast_hash_load64(p + 24) ^ *see1);
+   *see2 = fast_hash_mix(fast_hash_load64(p + 32) ^ wyhash_secret[3], fast_hash_load64(p + 40) ^ *see2);
+}
+
+
+static inline uint64_t wyhash_final(uint64_t a, uint64_t b, uint64_t seed, uint64_t len)
+{
+   a ^= wyhash_secret[1];
+   b ^= seed;
+   fast_hash_mum(&a, &b);
+   return fast_hash_mix(a ^ wyhash_secret[0] ^ len, b ^ wyhash_secret[1]);
+}
+
+
+/* len <= 16 */
+static uint64_t wyhash_short(const unsigned char* p, uint64_t len, uint64_t seed)
+{
+   uint64_t a;
+   uint64_t b;
+
+   if(len >= 4)
+   {
+      /* two overlapping 4 byte reads from each end cover 4..16 bytes */
+      const uint64_t mid = (len >> 3) << 2;
+      a = (fast_hash_load32(p) << 32) | fast_hash_load32(p + mid);
+      b = (fast_hash_load32(p + len - 4) << 32) | fast_hash_load32(p + len - 4 - mid);
+   }
+   else if(len > 0)
+   {
+      a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+      b = 0;
+   }
+   else
+   {
+      a = b = 0;
+   }
+
+   return wyhash_final(a, b, seed, len);
+}
+
+
+/* the last i (<= 48) bytes of a len (> 16) byte input, the 16 bytes
+   before p must be readable when i < 16 */
+static uint64_t wyhash_tail(const unsigned char* p, uint64_t i, uint64_t seed, uint64_t len)
+{
+   while(i > 16)
+   {
+      seed = fast_hash_mix(fast_hash_load64(p) ^ wyhash_secret[1], fast_hash_load64(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+   }
+
+   return wyhash_final(fast_hash_load64(p + i - 16), fast_hash_load64(p + i - 8), seed, len);
+}
+
+
+uint64_t WYHash64(const void* data, uint64_t len, uint64_t seed)
+{
+   const unsigned char* p = (const unsigned char*)data;
+   uint64_t i = len;
+
+   seed = wyhash_seed(seed);
+
+   if(len <= 16) return wyhash_short(p, len, seed);
+
+   if(i > 48)
+   {
+      uint64_t see1 = seed;
+      uint64_t see2 = seed;
+
+      do
+      {
+         wyhash_48(&seed, &see1, &see2, p);
+         p += 48;
+         i -= 48;
+      }
+      while(i > 48);
+
+      seed ^= see1 ^ see2;
+   }
+
+   return wyhash_tail(p, i, seed, len);
+}
+/* End Of WYHash64 Function */
+
+
+void WYHash64Init(WYHash64_ctx* ctx, uint64_t seed)
+{
+   ctx->total   = 0;
+   ctx->seed    = wyhash_seed(seed);
+   ctx->see1    = ctx->seed;
+   ctx->see2    = ctx->seed;
+   ctx->bulk    = 0;
+   ctx->pending = 0;
+}
+
+
+/*
+ * A 48 byte block is hashed only when more input is known to follow it
+ * (the one shot loop runs while more than 48 bytes are left), the last
+ * 1..48 bytes wait in buf for Final().
+ */
+void WYHash64Update(WYHash64_ctx* ctx, const void* data, uint64_t len)
+{
+   const unsigned char* p = (const unsigned char*)data;
+   unsigned char* pending = ctx->buf + 16;
+
+   ctx->total += len;
+
+   while(len > 0)
+   {
+      if(0 == ctx->pending && len > 48)
+      {
+         do
+         {
+            wyhash_48(&ctx->seed, &ctx->see1, &ctx->see2, p);
+            p += 48;
+            len -= 48;
+         }
+         while(len > 48);
+
+         ctx->bulk = 1;
+         memcpy(ctx->buf, p - 16, 16);
+         continue;
+      }
+
+      const uint64_t fill = (64 - ctx->pending < len) ? 64 - ctx->pending : len;
+      memcpy(pending + ctx->pending, p, (size_t)fill);
+      ctx->pending += (uint32_t)fill;
+      p += fill;
+      len -= fill;
+
+      if(ctx->pending > 48)
+      {
+         wyhash_48(&ctx->seed, &ctx->see1, &ctx->see2, pending);
+         ctx->bulk = 1;
+         memcpy(ctx->buf, pending + 32, 16);
+         memmove(pending, pending + 48, ctx->pending - 48);
+         ctx->pending -= 48;
+      }
+   }
+}
+
+
+uint64_t WYHash64Final(const WYHash64_ctx* ctx)
+{
+   uint64_t seed = ctx->seed;
+
+   if(ctx->total <= 16) return wyhash_short(ctx->buf + 16, ctx->total, seed);
+
+   if(ctx->bulk) seed ^= ctx->see1 ^ ctx->see2;
+
+   return wyhash_tail(ctx->buf + 16, ctx->pending, seed, ctx->total);
+}
+/* End Of WYHash64 Stream */
+
+
+/*
+ * StripeHash
+ *
+ * Inputs of 256 bytes or more are consumed in 64 byte stripes by 8 64 bit
+ * accumulators:
+ *
+ *    k       = word[i] ^ key[stripe + i]
+ *    acc[i] += (k & 0xffffffff) * (k >> 32)
+ *    acc[i ^ 1] += word[i]
+ *
+ * The 32 x 32 -> 64 bit multiply and the lane swap map to one
+ * pmuludq / pshufd per 2 (SSE2) or 4 (AVX2) lanes. Every 16 stripes
+ * (1 KB) the accumulators are scrambled so high bits flow back into the
+ * multiplier inputs. The last stripe is read from the end of the input
+ * (overlapping) so there is no byte tail.
+ */
+
+#define STRIPE_LEN          64
+#define STRIPES_PER_BLOCK   16
+#define STRIPE_BLOCK_LEN    (STRIPE_LEN * STRIPES_PER_BLOCK)
+#define STRIPE_MIN_LEN      256
+#define STRIPE_KEY_COUNT    24
+#define STRIPE_SCRAMBLE_KEY 16  /* key[16..23] */
+#define STRIPE_LAST_KEY     9   /* key[9..16] for the last stripe */
+
+/* splitmix64 stream, seed 0 */
+static const uint64_t stripe_secret[STRIPE_KEY_COUNT] =
+{
+   UINT64_C(0xe220a8397b1dcdaf), UINT64_C(0x6e789e6aa1b965f4),
+   UINT64_C(0x06c45d188009454f), UINT64_C(0xf88bb8a8724c81ec),
+   UINT64_C(0x1b39896a51a8749b), UINT64_C(0x53cb9f0c747ea2ea),
+   UINT64_C(0x2c829abe1f4532e1), UINT64_C(0xc584133ac916ab3c),
+   UINT64_C(0x3ee5789041c98ac3), UINT64_C(0xf3b8488c368cb0a6),
+   UINT64_C(0x657eecdd3cb13d09), UINT64_C(0xc2d326e0055bdef6),
+   UINT64_C(0x8621a03fe0bbdb7b), UINT64_C(0x8e1f7555983aa92f),
+   UINT64_C(0xb54e0f1600cc4d19), UINT64_C(0x84bb3f97971d80ab),
+   UINT64_C(0x7d29825c75521255), UINT64_C(0xc3cf17102b7f7f86),
+   UINT64_C(0x3466e9a083914f64), UINT64_C(0xd81a8d2b5a4485ac),
+   UINT64_C(0xdb01602b100b9ed7), UINT64_C(0xa9038a921825f10d),
+   UINT64_C(0xedf5f1d90dca2f6a), UINT64_C(0x54496ad67bd2634c)
+};
+
+typedef void (*stripe_accumulate_t)(uint64_t acc[8], const unsigned char* p, const uint64_t* key, uint64_t stripes);
+typedef void (*stripe_scramble_t)(uint64_t acc[8], const uint64_t* key);
+
+
+static void stripe_accumulate_scalar(uint64_t acc[8], const unsigned char* p, const uint64_t* key, uint64_t stripes)
+{
+   uint64_t s;
+   int i;
+
+   for(s = 0; s < stripes; s++, p += STRIPE_LEN)
+   {
+      for(i = 0; i < 8; i++)
+      {
+         const uint64_t d = fast_hash_load64(p + 8 * i);
+         const uint64_t k = d ^ key[s + i];
+         acc[i ^ 1] += d;
+         acc[i]     += (k & 0xffffffff) * (k >> 32);
+      }
+   }
+}
+
+
+static void stripe_scramble_scalar(uint64_t acc[8], const uint64_t* key)
+{
+   int i;
+
+   for(i = 0; i < 8; i++)
+   {
+      uint64_t a = acc[i];
+      a ^= a >> 47;
+      a ^= key[i];
+      acc[i] = a * P32_1;
+   }
+}
+
+
+#if defined(FAST_HASH_X86)
+
+static void stripe_accumulate_sse2(uint64_t acc[8], const unsigned char* p, const uint64_t* key, uint64_t stripes)
+{
+   __m128i a[4];
+   uint64_t s;
+   int j;
+
+   for(j = 0; j < 4; j++) a[j] = _mm_loadu_si128((const __m128i*)acc + j);
+
+   for(s = 0; s < stripes; s++, p += STRIPE_LEN)
+   {
+      for(j = 0; j < 4; j++)
+      {
+         const __m128i d = _mm_loadu_si128((const __m128i*)p + j);
+         const __m128i k = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)(key + s + 2 * j)));
+         const __m128i m = _mm_mul_epu32(k, _mm_srli_epi64(k, 32));
+         a[j] = _mm_add_epi64(a[j], _mm_add_epi64(m, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))));
+      }
+   }
+
+   for(j = 0; j < 4; j++) _mm_storeu_si128((__m128i*)acc + j, a[j]);
+}
+
+
+static void stripe_scramble_sse2(uint64_t acc[8], const uint64_t* key)
+{
+   const __m128i prime = _mm_set1_epi32((int)P32_1);
+   int j;
+
+   for(j = 0; j < 4; j++)
+   {
+      __m128i a = _mm_loadu_si128((const __m128i*)acc + j);
+      a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+      a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(key + 2 * j)));
+
+      /* 64 x 32 bit multiply from two 32 x 32 -> 64 */
+      const __m128i lo = _mm_mul_epu32(a, prime);
+      const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+      _mm_storeu_si128((__m128i*)acc + j, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+   }
+}
+
+
+FAST_HASH_TARGET("avx2")
+static void stripe_accumulate_avx2(uint64_t acc[8], const unsigned char* p, const uint64_t* key, uint64_t stripes)
+{
+   __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+   __m256i a1 = _mm256_loadu_si256((const __m256i*)acc + 1);
+   uint64_t s;
+
+   for(s = 0; s < stripes; s++, p += STRIPE_LEN)
+   {
+      const __m256i d0 = _mm256_loadu_si256((const __m256i*)p);
+      const __m256i d1 = _mm256_loadu_si256((const __m256i*)p + 1);
+      const __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)(key + s)));
+      const __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)(key + s + 4)));
+      const __m256i m0 = _mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32));
+      const __m256i m1 = _mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32));
+      a0 = _mm256_add_epi64(a0, _mm256_add_epi64(m0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+      a1 = _mm256_add_epi64(a1, _mm256_add_epi64(m1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+   }
+
+   _mm256_storeu_si256((__m256i*)acc, a0);
+   _mm256_storeu_si256((__m256i*)acc + 1, a1);
+}
+
+
+FAST_HASH_TARGET("avx2")
+static void stripe_scramble_avx2(uint64_t acc[8], const uint64_t* key)
+{
+   const __m256i prime = _mm256_set1_epi32((int)P32_1);
+   int j;
+
+   for(j = 0; j < 2; j++)
+   {
+      __m256i a = _mm256_loadu_si256((const __m256i*)acc + j);
+      a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+      a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(key + 4 * j)));
+
+      const __m256i lo = _mm256_mul_epu32(a, prime);
+      const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+      _mm256_storeu_si256((__m256i*)acc + j, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+   }
+}
+
+#endif
+
+
+typedef struct
+{
+   int                 impl;
+   stripe_accumulate_t accumulate;
+   stripe_scramble_t   scramble;
+} fast_hash_impl_t;
+
+
+static int fast_hash_impl_supported(int impl)
+{
+   switch(impl)
+   {
+   case FAST_HASH_IMPL_SCALAR:
+      return 1;
+#if defined(FAST_HASH_X86)
+   case FAST_HASH_IMPL_SSE2:
+      return 1;
+   case FAST_HASH_IMPL_AVX2:
+      return (sha2_cpu_features() & SHA2_CPU_AVX2) != 0;
+#endif
+   }
+   return 0;
+}
+
+
+static void fast_hash_select(fast_hash_impl_t* t, int impl)
+{
+   t->impl       = impl;
+   t->accumulate = stripe_accumulate_scalar;
+   t->scramble   = stripe_scramble_scalar;
+
+#if defined(FAST_HASH_X86)
+   if(FAST_HASH_IMPL_SSE2 == impl)
+   {
+      t->accumulate = stripe_accumulate_sse2;
+      t->scramble   = stripe_scramble_sse2;
+   }
+   else if(FAST_HASH_IMPL_AVX2 == impl)
+   {
+      t->accumulate = stripe_accumulate_avx2;
+      t->scramble   = stripe_scramble_avx2;
+   }
+#endif
+}
+
+
+static fast_hash_impl_t* fast_hash_impl(void)
+{
+   static fast_hash_impl_t impl = []()
+   {
+      fast_hash_impl_t t;
+      if(fast_hash_impl_supported(FAST_HASH_IMPL_AVX2))
+         fast_hash_select(&t, FAST_HASH_IMPL_AVX2);
+      else if(fast_hash_impl_supported(FAST_HASH_IMPL_SSE2))
+         fast_hash_select(&t, FAST_HASH_IMPL_SSE2);
+      else
+         fast_hash_select(&t, FAST_HASH_IMPL_SCALAR);
+      return t;
+   }();
+   return &impl;
+}
+
+
+static void stripe_reset(uint64_t acc[8])
+{
+   acc[0] = P32_1; acc[1] = P64_1; acc[2] = P64_2; acc[3] = P64_3;
+   acc[4] = P64_4; acc[5] = P32_1 ^ P64_5; acc[6] = P64_5; acc[7] = ~P64_1;
+}
+
+
+/* len >= STRIPE_MIN_LEN */
+static void stripe_bulk(uint64_t acc[8], const unsigned char* p, uint64_t len, const uint64_t* key)
+{
+   const fast_hash_impl_t* t = fast_hash_impl();
+   const unsigned char* end  = p + len;
+   uint64_t blocks = (len - 1) / STRIPE_BLOCK_LEN;
+   uint64_t b;
+
+   stripe_reset(acc);
+
+   for(b = 0; b < blocks; b++, p += STRIPE_BLOCK_LEN)
+   {
+      t->accumulate(acc, p, key, STRIPES_PER_BLOCK);
+      t->scramble(acc, key + STRIPE_SCRAMBLE_KEY);
+   }
+
+   /* 1..STRIPE_BLOCK_LEN bytes left, the last (partial) stripe is read
+      from the end of the input */
+   t->accumulate(acc, p, key, (uint64_t)(end - p - 1) / STRIPE_LEN);
+   t->accumulate(acc, end - STRIPE_LEN, key + STRIPE_LAST_KEY, 1);
+}
+
+
+static uint64_t stripe_merge(const uint64_t acc[8], const uint64_t* key, uint64_t hash)
+{
+   int i;
+
+   for(i = 0; i < 8; i += 2)
+   {
+      hash += fast_hash_mix(acc[i] ^ key[i], acc[i + 1] ^ key[i + 1]);
+   }
+
+   hash ^= hash >> 37;
+   hash *= UINT64_C(0x165667919E3779F9);
+   hash ^= hash >> 32;
+   return hash;
+}
+
+
+/* key[2i] = secret[2i] + seed, key[2i + 1] = secret[2i + 1] - seed */
+static const uint64_t* stripe_key(uint64_t seed, uint64_t key[STRIPE_KEY_COUNT])
+{
+   int i;
+
+   if(0 == seed) return stripe_secret;
+
+   for(i = 0; i < STRIPE_KEY_COUNT; i += 2)
+   {
+      key[i]     = stripe_secret[i] + seed;
+      key[i + 1] = stripe_secret[i + 1] - seed;
+   }
+   return key;
+}
+
+
+uint64_t StripeHash64(const void* data, uint64_t len, uint64_t seed)
+{
+   uint64_t acc[8];
+   uint64_t buffer[STRIPE_KEY_COUNT];
+   const uint64_t* key;
+
+   if(len < STRIPE_MIN_LEN) return WYHash64(data, len, seed);
+
+   key = stripe_key(seed, buffer);
+   stripe_bulk(acc, (const unsigned char*)data, len, key);
+   return stripe_merge(acc, key + 11, len * P64_1);
+}
+/* End Of StripeHash64 Function */
+
+
+hash128_t StripeHash128(const void* data, uint64_t len, uint64_t seed)
+{
+   hash128_t hash;
+   uint64_t acc[8];
+   uint64_t buffer[STRIPE_KEY_COUNT];
+   const uint64_t* key;
+
+   if(len < STRIPE_MIN_LEN)
+   {
+      hash.low  = WYHash64(data, len, seed);
+      hash.high = WYHash64(data, len, seed ^ P64_2);
+      return hash;
+   }
+
+   key = stripe_key(seed, buffer);
+   stripe_bulk(acc, (const unsigned char*)data, len, key);
+   hash.low  = stripe_merge(acc, key + 11, len * P64_1);
+   hash.high = stripe_merge(acc, key + 3, ~(len * P64_2));
+   return hash;
+}
+/* End Of StripeHash128 Function */
+
+
+/*
+ * Streaming StripeHash
+ *
+ * A stripe is accumulated (and a full block scrambled) only when at least
+ * one more byte is known to follow it, which is exactly the set of
+ * stripes the one shot loop accumulates before the overlapping last
+ * stripe. The first STRIPE_MIN_LEN bytes are buffered because shorter
+ * inputs are hashed by WYHash64 instead.
+ */
+
+/* stripes (each followed by more input), *block_stripes is the position
+   in the current block */
+static void stripe_consume(const fast_hash_impl_t* t,
+                           uint64_t acc[8],
+                           uint32_t* block_stripes,
+                           const uint64_t* key,
+                           const unsigned char* p,
+                           uint64_t stripes)
+{
+   while(stripes > 0)
+   {
+      uint64_t n = STRIPES_PER_BLOCK - *block_stripes;
+      if(n > stripes) n = stripes;
+
+      t->accumulate(acc, p, key + *block_stripes, n);
+      *block_stripes += (uint32_t)n;
+      p += n * STRIPE_LEN;
+      stripes -= n;
+
+      if(STRIPES_PER_BLOCK == *block_stripes)
+      {
+         t->scramble(acc, key + STRIPE_SCRAMBLE_KEY);
+         *block_stripes = 0;
+      }
+   }
+}
+
+
+void StripeHashInit(StripeHash_ctx* ctx, uint64_t seed)
+{
+   uint64_t buffer[STRIPE_KEY_COUNT];
+
+   ctx->total   = 0;
+   ctx->seed    = seed;
+   ctx->stripes = 0;
+   ctx->pending = 0;
+   stripe_reset(ctx->acc);
+   memcpy(ctx->key, stripe_key(seed, buffer), sizeof(ctx->key));
+}
+
+
+void StripeHashUpdate(StripeHash_ctx* ctx, const void* data, uint64_t len)
+{
+   const fast_hash_impl_t* t = fast_hash_impl();
+   const unsigned char* p    = (const unsigned char*)data;
+   unsigned char* pending    = ctx->buf + STRIPE_LEN;
+
+   ctx->total += len;
+
+   while(len > 0)
+   {
+      if(STRIPE_MIN_LEN == ctx->pending)
+      {
+         /* more input follows, so none of the buffered stripes is the last */
+         stripe_consume(t, ctx->acc, &ctx->stripes, ctx->key, pending, STRIPE_MIN_LEN / STRIPE_LEN);
+         memcpy(ctx->buf, pending + STRIPE_MIN_LEN - STRIPE_LEN, STRIPE_LEN);
+         ctx->pending = 0;
+      }
+
+      if(0 == ctx->pending && ctx->total >= STRIPE_MIN_LEN && len > STRIPE_LEN)
+      {
+         /* straight from the input, keep the last 1..64 bytes */
+         const uint64_t stripes = (len - 1) / STRIPE_LEN;
+         stripe_consume(t, ctx->acc, &ctx->stripes, ctx->key, p, stripes);
+         p   += stripes * STRIPE_LEN;
+         len -= stripes * STRIPE_LEN;
+         memcpy(ctx->buf, p - STRIPE_LEN, STRIPE_LEN);
+      }
+
+      const uint64_t fill = (STRIPE_MIN_LEN - ctx->pending < len) ? STRIPE_MIN_LEN - ctx->pending : len;
+      memcpy(pending + ctx->pending, p, (size_t)fill);
+      ctx->pending += (uint32_t)fill;
+      p   += fill;
+      len -= fill;
+   }
+}
+
+
+/* total >= STRIPE_MIN_LEN, the pending stripes and the last stripe on a
+   copy of the accumulators */
+static void stripe_final_acc(const StripeHash_ctx* ctx, uint64_t acc[8])
+{
+   const fast_hash_impl_t* t = fast_hash_impl();
+   const unsigned char* end  = ctx->buf + STRIPE_LEN + ctx->pending;
+   uint32_t block_stripes    = ctx->stripes;
+
+   memcpy(acc, ctx->acc, sizeof(ctx->acc));
+   stripe_consume(t, acc, &block_stripes, ctx->key, ctx->buf + STRIPE_LEN, (ctx->pending - 1) / STRIPE_LEN);
+   t->accumulate(acc, end - STRIPE_LEN, ctx->key + STRIPE_LAST_KEY, 1);
+}
+
+
+uint64_t StripeHash64Final(const StripeHash_ctx* ctx)
+{
+   uint64_t acc[8];
+
+   if(ctx->total < STRIPE_MIN_LEN) return WYHash64(ctx->buf + STRIPE_LEN, ctx->total, ctx->seed);
+
+   stripe_final_acc(ctx, acc);
+   return stripe_merge(acc, ctx->key + 11, ctx->total * P64_1);
+}
+
+
+hash128_t StripeHash128Final(const StripeHash_ctx* ctx)
+{
+   hash128_t hash;
+   uint64_t acc[8];
+
+   if(ctx->total < STRIPE_MIN_LEN)
+   {
+      hash.low  = WYHash64(ctx->buf + STRIPE_LEN, ctx->total, ctx->seed);
+      hash.high = WYHash64(ctx->buf + STRIPE_LEN, ctx->total, ctx->seed ^ P64_2);
+      return hash;
+   }
+
+   stripe_final_acc(ctx, acc);
+   hash.low  = stripe_merge(acc, ctx->key + 11, ctx->total * P64_1);
+   hash.high = stripe_merge(acc, ctx->key + 3, ~(ctx->total * P64_2));
+   return hash;
+}
+/* End Of StripeHash Stream */
+
+
+int fast_hash_get_impl(void)
+{
+   return fast_hash_impl()->impl;
+}
+
+
+/* not thread safe, StripeHash must not run while switching */
+int fast_hash_set_impl(int impl)
+{
+   if(!fast_hash_impl_supported(impl)) return 0;
+   fast_hash_select(fast_hash_impl(), impl);
+   return 1;
+}
+
+
+const char* fast_hash_impl_name(int impl)
+{
+   switch(impl)
+   {
+   case FAST_HASH_IMPL_SCALAR: return "scalar";
+   case FAST_HASH_IMPL_SSE2:   return "sse2";
+   case FAST_HASH_IMPL_AVX2:   return "avx2";
+   }
+   return "unknown";
+}
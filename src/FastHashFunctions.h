@@ -0,0 +1,104 @@
+/*
+ * Word at a time 64/128 bit hash functions, companion of
+ * GeneralHashFunctions.h.
+ *
+ * GeneralHashFunctions consumes one byte per step and produces 32 bits,
+ * which is slow for long keys (paths, file contents) and collides too
+ * often for large in-memory indexes. The functions below consume 8 bytes
+ * per step (and 64 byte stripes with SIMD for long inputs), take a seed
+ * and a 64 bit length.
+ *
+ *   XXHash64      xxHash64 (XXH64), bit exact with the reference
+ *   WYHash64      wyhash structure (128 bit multiply and fold), best for
+ *                 short keys
+ *   StripeHash64  XXH3 like stripe accumulator for long inputs,
+ *   StripeHash128 WYHash64 for inputs shorter than 256 bytes. The bulk
+ *                 loop runs on AVX2 / SSE2 when available, all versions
+ *                 produce identical results.
+ *
+ * The values are stable across platforms (little endian byte order is
+ * used for the words) but StripeHash / WYHash are NOT compatible with the
+ * upstream XXH3 / wyhash.
+ */
+
+#ifndef INCLUDE_FASTHASHFUNCTIONS_H
+#define INCLUDE_FASTHASHFUNCTIONS_H
+
+#include <stdint.h>
+
+typedef struct hash128_t
+{
+   uint64_t low;
+   uint64_t high;
+} hash128_t;
+
+typedef uint64_t  (*hash_function64) (const void* data, uint64_t len, uint64_t seed);
+typedef hash128_t (*hash_function128)(const void* data, uint64_t len, uint64_t seed);
+
+uint64_t  XXHash64     (const void* data, uint64_t len, uint64_t seed);
+uint64_t  WYHash64     (const void* data, uint64_t len, uint64_t seed);
+uint64_t  StripeHash64 (const void* data, uint64_t len, uint64_t seed);
+hash128_t StripeHash128(const void* data, uint64_t len, uint64_t seed);
+
+/* streaming versions, Final() gives the same value as the one shot
+ * function on the concatenated input and does not change the context, so
+ * a running hash can be read and updated further. Update() hashes whole
+ * words / stripes straight from the input and copies only the pieces
+ * that straddle two calls. */
+typedef struct XXHash64_ctx
+{
+   uint64_t      total;
+   uint64_t      v[4];
+   unsigned char buf[32];
+   uint32_t      pending;
+   uint64_t      seed;
+} XXHash64_ctx;
+
+typedef struct WYHash64_ctx
+{
+   uint64_t      total;
+   uint64_t      seed;
+   uint64_t      see1;
+   uint64_t      see2;
+   int           bulk;        /* 48 byte loop entered */
+   uint32_t      pending;
+   unsigned char buf[16 + 64];  /* last 16 hashed bytes + pending bytes */
+} WYHash64_ctx;
+
+typedef struct StripeHash_ctx
+{
+   uint64_t      total;
+   uint64_t      seed;
+   uint64_t      acc[8];
+   uint64_t      key[24];
+   uint32_t      stripes;     /* stripes of the current 1 KB block */
+   uint32_t      pending;
+   unsigned char buf[64 + 256]; /* last hashed stripe + pending bytes */
+} StripeHash_ctx;
+
+void      XXHash64Init   (XXHash64_ctx* ctx, uint64_t seed);
+void      XXHash64Update (XXHash64_ctx* ctx, const void* data, uint64_t len);
+uint64_t  XXHash64Final  (const XXHash64_ctx* ctx);
+
+void      WYHash64Init   (WYHash64_ctx* ctx, uint64_t seed);
+void      WYHash64Update (WYHash64_ctx* ctx, const void* data, uint64_t len);
+uint64_t  WYHash64Final  (const WYHash64_ctx* ctx);
+
+/* one context gives both StripeHash64 and StripeHash128 */
+void      StripeHashInit    (StripeHash_ctx* ctx, uint64_t seed);
+void      StripeHashUpdate  (StripeHash_ctx* ctx, const void* data, uint64_t len);
+uint64_t  StripeHash64Final (const StripeHash_ctx* ctx);
+hash128_t StripeHash128Final(const StripeHash_ctx* ctx);
+
+/* implementations of the StripeHash bulk loop. The fastest one the CPU
+ * supports is selected on first use, fast_hash_set_impl() can force
+ * another one (for testing) and returns 0 if it is not supported. */
+#define FAST_HASH_IMPL_SCALAR   0
+#define FAST_HASH_IMPL_SSE2     1
+#define FAST_HASH_IMPL_AVX2     2
+
+int fast_hash_get_impl(void);
+int fast_hash_set_impl(int impl);
+const char* fast_hash_impl_name(int impl);
+
+#endif
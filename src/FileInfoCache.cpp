@@ -12,6 +12,7 @@
 #include "md5.h"
 #include "sha2.h"
 #include "Win32Utils.h"
+#include <algorithm>
 
 #define _create_file_cache \
                 "CREATE TABLE file_hash ( "\
@@ -79,6 +80,8 @@ FileInfoCache::FileInfoCache() :
 	_size(0), 
 	_hit_count(0),
 	_cache_size(0),
+	_hash_block_size(_hash_block_size_def),
+	_hash_buffer_count(_hash_buffer_count_def),
 	_select_cache_stmt(nullptr),
 	_insert_cache_stmt(nullptr),
 	_update_cache_stmt(nullptr),
@@ -192,6 +195,19 @@ void FileInfoCache::finalize()
     }
 }
 
+/// @brief	
+void 
+FileInfoCache::set_hash_block(
+	_In_ uint32_t block_size, 
+	_In_ uint32_t buffer_count
+	)
+{
+	_hash_block_size = std::min<uint32_t>(std::max<uint32_t>(block_size, _hash_block_size_min), 
+										  _hash_block_size_max);
+	_hash_buffer_count = std::min<uint32_t>(std::max<uint32_t>(buffer_count, _hash_buffer_count_min), 
+											_hash_buffer_count_max);
+}
+
 /// @brief 
 bool 
 FileInfoCache::get_file_information(
@@ -515,13 +531,182 @@ FileInfoCache::file_util_get_hash(
 	_Out_ std::string& md5, 
 	_Out_ std::string& sha2)
 {
+	return get_file_hash(file_path, 
+						 _hash_block_size, 
+						 _hash_buffer_count, 
+						 md5, 
+						 sha2);
+}
+
+namespace {
+
+/// @brief	read -> (md5, sha256) pipeline
+///
+///			ȣ 尡  block  о buffer   ä,
+///			md5, sha256    buffer   ؽѴ. 
+///			 尡   buffer  ٽ б⿡ ǹǷ buffer  
+///			 ʴ´.
+class hash_pipeline
+{
+public:
+	hash_pipeline(_In_ uint32_t block_size, _In_ uint32_t buffer_count) :
+		_block_size(block_size),
+		_buffers(buffer_count),
+		_lengths(buffer_count, 0),
+		_pending(buffer_count, 0),
+		_produced(0),
+		_eof(false)
+	{
+		for (auto& buffer : _buffers)
+		{
+			buffer.reset(new uint8_t[block_size]);
+		}
+	}
+
+	bool run(_In_ const wchar_t* file_path,
+			 _In_ HANDLE file_handle,
+			 _Inout_ MD5_CTX& ctx_md5,
+			 _Inout_ sha256_ctx& ctx_sha2)
+	{
+		boost::thread md5_thread([&]()
+		{
+			consume([&](uint8_t* data, uint32_t length)
+			{
+				MD5Update(&ctx_md5, data, length);
+			});
+		});
+		boost::thread sha2_thread([&]()
+		{
+			consume([&](uint8_t* data, uint32_t length)
+			{
+				sha256_hash(data, length, &ctx_sha2);
+			});
+		});
+
+		bool ret = produce(file_path, file_handle);
+
+		md5_thread.join();
+		sha2_thread.join();
+		return ret;
+	}
+
+private:
+	/// @brief	 о buffer  ä. (ȣ )
+	bool produce(_In_ const wchar_t* file_path, _In_ HANDLE file_handle)
+	{
+		bool ret = true;
+		for (uint64_t block = 0; ; ++block)
+		{
+			size_t slot = (size_t)(block % _buffers.size());
+			{
+				boost::unique_lock<boost::mutex> lock(_lock);
+				while (0 != _pending[slot])
+				{
+					_consumed_cond.wait(lock);
+				}
+			}
+
+			DWORD read = 0;
+			if (FALSE == ::ReadFile(file_handle,
+									_buffers[slot].get(),
+									_block_size,
+									&read,
+									NULL))
+			{
+				log_err
+					"ReadFile() failed. path=%ws, gle = 0x%08x",
+					file_path,
+					GetLastError()
+					log_end;
+				ret = false;
+				break;
+			}
+			if (0 == read) break;
+
+			{
+				boost::lock_guard<boost::mutex> lock(_lock);
+				_lengths[slot] = read;
+				_pending[slot] = 2;		// md5, sha256
+				++_produced;
+			}
+			_produced_cond.notify_all();
+		}
+
+		{
+			boost::lock_guard<boost::mutex> lock(_lock);
+			_eof = true;
+		}
+		_produced_cond.notify_all();
+		return ret;
+	}
+
+	/// @brief	 block   ؽѴ. (md5, sha256 )
+	template <typename hash_func>
+	void consume(_In_ hash_func hash)
+	{
+		for (uint64_t block = 0; ; ++block)
+		{
+			size_t slot = (size_t)(block % _buffers.size());
+			{
+				boost::unique_lock<boost::mutex> lock(_lock);
+				while (block == _produced && true != _eof)
+				{
+					_produced_cond.wait(lock);
+				}
+				if (block == _produced) break;
+			}
+
+			hash(_buffers[slot].get(), _lengths[slot]);
+
+			bool consumed = false;
+			{
+				boost::lock_guard<boost::mutex> lock(_lock);
+				consumed = (0 == --_pending[slot]);
+			}
+			if (true == consumed) _consumed_cond.notify_one();
+		}
+	}
+
+private:
+	uint32_t								_block_size;
+	std::vector<std::unique_ptr<uint8_t[]>>	_buffers;
+	std::vector<uint32_t>					_lengths;
+	std::vector<uint32_t>					_pending;	///<  ؽ   
+	uint64_t								_produced;	///<  block 
+	bool									_eof;		///< б  (Ǵ )
+
+	boost::mutex							_lock;
+	boost::condition_variable				_produced_cond;
+	boost::condition_variable				_consumed_cond;
+};
+
+} // namespace
+
+/// @brief 
+bool 
+get_file_hash(
+	_In_ const wchar_t* file_path,
+	_In_ uint32_t block_size,
+	_In_ uint32_t buffer_count,
+	_Out_ std::string& md5, 
+	_Out_ std::string& sha2
+	)
+{
+	_ASSERTE(nullptr != file_path);
+	if (nullptr == file_path) return false;
+
+	block_size = std::min<uint32_t>(std::max<uint32_t>(block_size, _hash_block_size_min), 
+									_hash_block_size_max);
+	buffer_count = std::min<uint32_t>(std::max<uint32_t>(buffer_count, _hash_buffer_count_min), 
+									  _hash_buffer_count_max);
+
 	handle_ptr file_handle(
 		CreateFileW(file_path,
 					GENERIC_READ,
 					FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
 					NULL,
 					OPEN_EXISTING,
-					FILE_ATTRIBUTE_NORMAL,
+					FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
 					NULL),
 		[](HANDLE h) 
 		{
@@ -540,19 +725,17 @@ FileInfoCache::file_util_get_hash(
             log_end;
         return false; 
     }
-    
-    if (INVALID_SET_FILE_POINTER == SetFilePointer(file_handle.get(), 
-												   0, 
-												   NULL, 
-												   FILE_BEGIN))
-    {
-        log_err
-            "SetFilePointer() failed. path=%ws, gle = %u", 
-			file_path, 
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle.get(), &file_size))
+	{
+		log_err
+			"GetFileSizeEx() failed. path=%ws, gle = %u",
+			file_path,
 			GetLastError()
-            log_end;
-        return false;
-    }
+			log_end;
+		return false;
+	}
 
     uint8_t sha2_buf[32];
     MD5_CTX ctx_md5;
@@ -560,32 +743,47 @@ FileInfoCache::file_util_get_hash(
     MD5Init(&ctx_md5, 0);
     sha256_begin(&ctx_sha2);
 
-    const uint32_t read_buffer_size = 4096;
-    uint8_t read_buffer[read_buffer_size];
-    DWORD read = read_buffer_size;
-
-    while (read_buffer_size == read)
-    {
-		if (FALSE == ::ReadFile(file_handle.get(),
-								read_buffer,
-								read_buffer_size,
-								&read,
-								NULL))
-        {
-            log_err
-                "ReadFile() failed. path=%ws, gle = 0x%08x",
-                file_path,
-                GetLastError()
-                log_end;
-            return false;
-        }
+	if ((uint64_t)file_size.QuadPart > block_size)
+	{
+		//
+		//	ū  б md5, sha256  pipeline  óѴ.
+		//
+		hash_pipeline pipeline(block_size, buffer_count);
+		if (true != pipeline.run(file_path, file_handle.get(), ctx_md5, ctx_sha2))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		//
+		//	  带    ũǷ ȣ 忡 
+		//	ѹ о ؽѴ. (д   Ŀ ̾ д´)
+		//
+		const uint32_t read_buffer_size = std::max<uint32_t>((uint32_t)file_size.QuadPart, 4096);
+		std::unique_ptr<uint8_t[]> read_buffer(new uint8_t[read_buffer_size]);
+		DWORD read = 0;
+		for (;;)
+		{
+			if (FALSE == ::ReadFile(file_handle.get(),
+									read_buffer.get(),
+									read_buffer_size,
+									&read,
+									NULL))
+			{
+				log_err
+					"ReadFile() failed. path=%ws, gle = 0x%08x",
+					file_path,
+					GetLastError()
+					log_end;
+				return false;
+			}
+			if (0 == read) break;
 
-        if (0 != read)
-        {
-            MD5Update(&ctx_md5, read_buffer, read);
-            sha256_hash(read_buffer, read, &ctx_sha2);
-        }
-    }
+			MD5Update(&ctx_md5, read_buffer.get(), read);
+			sha256_hash(read_buffer.get(), read, &ctx_sha2);
+		}
+	}
 
     MD5Final(&ctx_md5);
     sha256_end(sha2_buf, &ctx_sha2);
@@ -613,8 +811,6 @@ FileInfoCache::file_util_get_hash(
     return true;
 }
 
-
-
 // ============================================================================
 //
 //	C API
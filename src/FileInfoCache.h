@@ -10,6 +10,18 @@
 
 #include "CppSQLite\CppSQLite3.h"
 
+/// @brief	 ؽ (md5, sha256)    б  (bytes)  buffer 
+///
+///			block ũ⺸ ū  б ؽø ġ, md5/sha256  ÿ
+///			Ѵ. (get_file_hash() )
+#define _hash_block_size_min		(1 * 1024 * 1024)
+#define _hash_block_size_max		(8 * 1024 * 1024)
+#define _hash_block_size_def		(4 * 1024 * 1024)
+
+#define _hash_buffer_count_min		2
+#define _hash_buffer_count_max		4
+#define _hash_buffer_count_def		3
+
 
 /// @brief	FileInformationn class
 typedef class FileInformation
@@ -50,6 +62,10 @@ public:
 
 	int64_t size() { return _size; }
 	int64_t hit_count() { return _hit_count; }
+
+	/// @brief	 ؽø   б  (1 ~ 8 MB)  buffer  (2 ~ 4)  
+	///			Ѵ.   ּ/ִ밪 ȴ.
+	void set_hash_block(_In_ uint32_t block_size, _In_ uint32_t buffer_count);
 private:
 	bool insert_file_info(_In_ const wchar_t* path,
 						  _In_ uint64_t create_time,
@@ -75,6 +91,8 @@ private:
 	int64_t		 _size;
 	int64_t		 _hit_count;
 	int64_t		 _cache_size;
+	uint32_t	 _hash_block_size;
+	uint32_t	 _hash_buffer_count;
 
 	PCppSQLite3Statement _select_cache_stmt;
 	PCppSQLite3Statement _insert_cache_stmt;
@@ -93,6 +111,22 @@ void fi_finalize();
 bool fi_get_file_information(_In_ const wchar_t* file_path, _Out_ FileInformation& file_information);
 
 
+//
+//	 ؽ
+//
+
+/// @brief	file_path  md5, sha256  hex ڿ Ѵ.
+///
+///			block_size  ū  buffer_count  buffer  ư 
+///			block_size  а, д  ̹  block  md5, sha256 
+///			尡 ÿ ؽѴ.   ȣ 忡 óѴ.
+bool get_file_hash(_In_ const wchar_t* file_path,
+				   _In_ uint32_t block_size,
+				   _In_ uint32_t buffer_count,
+				   _Out_ std::string& md5,
+				   _Out_ std::string& sha2);
+
+
 
 
 
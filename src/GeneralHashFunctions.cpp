@@ -185,3 +185,343 @@ unsigned int APHash(char* str, unsigned int len)
    return hash;
 }
 /* End Of AP Hash Function */
+
+
+/*
+ * Streaming versions. Each Update() runs the same loop as the one shot
+ * function on the next piece, so the result matches the one shot function
+ * on the concatenated input.
+ */
+
+void RSHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 63689;
+   ctx->count = 0;
+}
+
+void RSHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   const unsigned int b = 378551;
+   unsigned int a       = ctx->a;
+   unsigned int hash    = ctx->hash;
+   unsigned int i       = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = hash * a + (*str);
+      a    = a * b;
+   }
+
+   ctx->a    = a;
+   ctx->hash = hash;
+}
+
+unsigned int RSHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of RS Hash Stream */
+
+
+void JSHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 1315423911;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void JSHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int i    = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash ^= ((hash << 5) + (*str) + (hash >> 2));
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int JSHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of JS Hash Stream */
+
+
+void PJWHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void PJWHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   const unsigned int BitsInUnsignedInt = (unsigned int)(sizeof(unsigned int) * 8);
+   const unsigned int ThreeQuarters     = (unsigned int)((BitsInUnsignedInt  * 3) / 4);
+   const unsigned int OneEighth         = (unsigned int)(BitsInUnsignedInt / 8);
+   const unsigned int HighBits          = (unsigned int)(0xFFFFFFFF) << (BitsInUnsignedInt - OneEighth);
+   unsigned int hash              = ctx->hash;
+   unsigned int test              = 0;
+   unsigned int i                 = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = (hash << OneEighth) + (*str);
+
+      if((test = hash & HighBits)  != 0)
+      {
+         hash = (( hash ^ (test >> ThreeQuarters)) & (~HighBits));
+      }
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int PJWHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of P. J. Weinberger Hash Stream */
+
+
+void ELFHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void ELFHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int x    = 0;
+   unsigned int i    = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = (hash << 4) + (*str);
+      if((x = hash & 0xF0000000L) != 0)
+      {
+         hash ^= (x >> 24);
+      }
+      hash &= ~x;
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int ELFHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of ELF Hash Stream */
+
+
+void BKDRHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void BKDRHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int seed = 131; /* 31 131 1313 13131 131313 etc.. */
+   unsigned int hash = ctx->hash;
+   unsigned int i    = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = (hash * seed) + (*str);
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int BKDRHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of BKDR Hash Stream */
+
+
+void SDBMHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void SDBMHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int i    = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = (*str) + (hash << 6) + (hash << 16) - hash;
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int SDBMHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of SDBM Hash Stream */
+
+
+void DJBHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 5381;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void DJBHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int i    = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = ((hash << 5) + hash) + (*str);
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int DJBHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of DJB Hash Stream */
+
+
+/*
+ * DEKHash starts from the total length, which is not known until the
+ * end. The step ((hash << 5) ^ (hash >> 27)) is a 32 bit rotation, so the
+ * initial value only contributes rotl(len, 5 * len) to the result and can
+ * be xored in by Final().
+ */
+void DEKHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void DEKHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int i    = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = ((hash << 5) ^ (hash >> 27)) ^ (*str);
+   }
+
+   ctx->hash   = hash;
+   ctx->count += len;
+}
+
+unsigned int DEKHashFinal(const general_hash_ctx* ctx)
+{
+   const unsigned int len   = ctx->count;
+   const unsigned int shift = (len * 5) & 31;
+   const unsigned int init  = (0 == shift) ? len : ((len << shift) | (len >> (32 - shift)));
+
+   return ctx->hash ^ init;
+}
+/* End Of DEK Hash Stream */
+
+
+void BPHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void BPHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int i    = 0;
+   for(i = 0; i < len; str++, i++)
+   {
+      hash = hash << 7 ^ (*str);
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int BPHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of BP Hash Stream */
+
+
+void FNVHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void FNVHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   const unsigned int fnv_prime = 0x811C9DC5;
+   unsigned int hash      = ctx->hash;
+   unsigned int i         = 0;
+
+   for(i = 0; i < len; str++, i++)
+   {
+      hash *= fnv_prime;
+      hash ^= (*str);
+   }
+
+   ctx->hash = hash;
+}
+
+unsigned int FNVHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of FNV Hash Stream */
+
+
+/* AP alternates on the byte position in the whole input */
+void APHashInit(general_hash_ctx* ctx)
+{
+   ctx->hash  = 0xAAAAAAAA;
+   ctx->a     = 0;
+   ctx->count = 0;
+}
+
+void APHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len)
+{
+   unsigned int hash = ctx->hash;
+   unsigned int i    = ctx->count;
+   unsigned int end  = ctx->count + len;
+
+   for(; i != end; str++, i++)
+   {
+      hash ^= ((i & 1) == 0) ? (  (hash <<  7) ^ (*str) * (hash >> 3)) :
+                               (~((hash << 11) + ((*str) ^ (hash >> 5))));
+   }
+
+   ctx->hash  = hash;
+   ctx->count = end;
+}
+
+unsigned int APHashFinal(const general_hash_ctx* ctx)
+{
+   return ctx->hash;
+}
+/* End Of AP Hash Stream */
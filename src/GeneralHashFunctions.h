@@ -41,4 +41,62 @@ unsigned int FNVHash (char* str, unsigned int len);
 unsigned int APHash  (char* str, unsigned int len);
 
 
+/*
+ * Streaming versions of the functions above, for input that arrives in
+ * pieces (network chunks, file windows, path components):
+ *
+ *    general_hash_ctx ctx;
+ *    FNVHashInit(&ctx);
+ *    FNVHashUpdate(&ctx, part1, len1);
+ *    FNVHashUpdate(&ctx, part2, len2);
+ *    hash = FNVHashFinal(&ctx);      == FNVHash(part1 + part2, len1 + len2)
+ */
+typedef struct general_hash_ctx
+{
+   unsigned int hash;
+   unsigned int a;      /* RS: multiplier */
+   unsigned int count;  /* AP, DEK: bytes hashed so far */
+} general_hash_ctx;
+
+typedef void         (*hash_init_function)  (general_hash_ctx* ctx);
+typedef void         (*hash_update_function)(general_hash_ctx* ctx, const char* str, unsigned int len);
+typedef unsigned int (*hash_final_function) (const general_hash_ctx* ctx);
+
+void RSHashInit  (general_hash_ctx* ctx);
+void JSHashInit  (general_hash_ctx* ctx);
+void PJWHashInit (general_hash_ctx* ctx);
+void ELFHashInit (general_hash_ctx* ctx);
+void BKDRHashInit(general_hash_ctx* ctx);
+void SDBMHashInit(general_hash_ctx* ctx);
+void DJBHashInit (general_hash_ctx* ctx);
+void DEKHashInit (general_hash_ctx* ctx);
+void BPHashInit  (general_hash_ctx* ctx);
+void FNVHashInit (general_hash_ctx* ctx);
+void APHashInit  (general_hash_ctx* ctx);
+
+void RSHashUpdate  (general_hash_ctx* ctx, const char* str, unsigned int len);
+void JSHashUpdate  (general_hash_ctx* ctx, const char* str, unsigned int len);
+void PJWHashUpdate (general_hash_ctx* ctx, const char* str, unsigned int len);
+void ELFHashUpdate (general_hash_ctx* ctx, const char* str, unsigned int len);
+void BKDRHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len);
+void SDBMHashUpdate(general_hash_ctx* ctx, const char* str, unsigned int len);
+void DJBHashUpdate (general_hash_ctx* ctx, const char* str, unsigned int len);
+void DEKHashUpdate (general_hash_ctx* ctx, const char* str, unsigned int len);
+void BPHashUpdate  (general_hash_ctx* ctx, const char* str, unsigned int len);
+void FNVHashUpdate (general_hash_ctx* ctx, const char* str, unsigned int len);
+void APHashUpdate  (general_hash_ctx* ctx, const char* str, unsigned int len);
+
+unsigned int RSHashFinal  (const general_hash_ctx* ctx);
+unsigned int JSHashFinal  (const general_hash_ctx* ctx);
+unsigned int PJWHashFinal (const general_hash_ctx* ctx);
+unsigned int ELFHashFinal (const general_hash_ctx* ctx);
+unsigned int BKDRHashFinal(const general_hash_ctx* ctx);
+unsigned int SDBMHashFinal(const general_hash_ctx* ctx);
+unsigned int DJBHashFinal (const general_hash_ctx* ctx);
+unsigned int DEKHashFinal (const general_hash_ctx* ctx);
+unsigned int BPHashFinal  (const general_hash_ctx* ctx);
+unsigned int FNVHashFinal (const general_hash_ctx* ctx);
+unsigned int APHashFinal  (const general_hash_ctx* ctx);
+
+
 #endif
@@ -205,10 +205,27 @@ add_day_to_file_time(
 /// @brief	 ð `2017-05-23 21:23:24.821`  ڿ Ѵ. 
 std::string	time_now_to_str(_In_ bool localtime, _In_ bool show_misec)
 {
-	SYSTEMTIME utc_system_time;
-	GetSystemTime(&utc_system_time);
+	char buf[32];
+	if (0 == time_now_to_str(localtime, show_misec, buf, sizeof(buf)))
+	{
+		return std::string("1601-01-01 00:00:000");
+	}
+	return std::string(buf);
+}
+
+/// @brief	 ð `2017-05-23 21:23:24.821`  ڿ buffer  .
+size_t
+time_now_to_str(
+	_In_ bool localtime,
+	_In_ bool show_misec,
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size
+)
+{
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
 
-	return sys_time_to_str(&utc_system_time, localtime, show_misec);
+	return file_time_to_str(file_time_to_int(&now), localtime, show_misec, buffer, size);
 }
 
 
@@ -229,9 +246,7 @@ file_time_to_str(
 	_In_ bool show_misec
 )
 {
-	SYSTEMTIME utc;
-	FileTimeToSystemTime(file_time, &utc);
-	return sys_time_to_str(&utc, localtime, show_misec);
+	return file_time_to_str(file_time_to_int(file_time), localtime, show_misec);
 }
 
 /// @brief  FILETIME to `yyyy-mm-dd hh:mi:ss` string representation.
@@ -242,9 +257,100 @@ file_time_to_str(
 	_In_ bool show_misec
 )
 {
-	FILETIME ft;
-	int_to_file_time(file_time, &ft);
-	return file_time_to_str(&ft, localtime, show_misec);
+	char buf[32];
+	if (0 == file_time_to_str(file_time, localtime, show_misec, buf, sizeof(buf)))
+	{
+		return std::string("1601-01-01 00:00:000");
+	}
+	return std::string(buf);
+}
+
+/// @brief	file_time_to_str()    ĳ
+///
+///			α ٸ ð ڿ µ, κ    ð̹Ƿ
+///			`yyyy-mm-dd hh:mi:ss` κ 庰  ΰ ʰ ٲ 
+///			ٽ . 庰 ĳ̹Ƿ lock  ʿ.
+typedef struct time_str_cache
+{
+	uint64_t	second;			///< file_time / _file_time_to_sec
+	size_t		length;			///< 0 ̸ 
+	char		str[32];
+} *ptime_str_cache;
+
+static thread_local time_str_cache _time_str_cache[2] = {};	///< [0] utc, [1] localtime
+
+/// @brief  FILETIME to `yyyy-mm-dd hh:mi:ss` string representation.
+///			buffer  ϸ 0  Ѵ.
+size_t
+file_time_to_str(
+	_In_ uint64_t file_time,
+	_In_ bool localtime,
+	_In_ bool show_misec,
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size
+)
+{
+	_ASSERTE(nullptr != buffer);
+	_ASSERTE(0 < size);
+	if (nullptr == buffer || 0 == size) return 0;
+
+	//
+	//	ʰ ٲ ĳø Ѵ.
+	//	time zone bias   ̹Ƿ   utc/localtime  .
+	//
+	ptime_str_cache cache = &_time_str_cache[(true == localtime) ? 1 : 0];
+	uint64_t second = file_time / _file_time_to_sec;
+	if (0 == cache->length || second != cache->second)
+	{
+		FILETIME ft;
+		SYSTEMTIME utc;
+		int_to_file_time(second * _file_time_to_sec, &ft);
+		if (TRUE != FileTimeToSystemTime(&ft, &utc))
+		{
+			buffer[0] = '\0';
+			return 0;
+		}
+
+		std::string str = sys_time_to_str(&utc, localtime, false);
+		if (str.size() >= sizeof(cache->str))
+		{
+			buffer[0] = '\0';
+			return 0;
+		}
+		RtlCopyMemory(cache->str, str.c_str(), str.size() + 1);
+		cache->length = str.size();
+		cache->second = second;
+	}
+
+	//
+	//	`yyyy-mm-dd hh:mi:ss` + ` и`
+	//
+	char msec_str[8];
+	size_t msec_length = 0;
+	if (true == show_misec)
+	{
+		uint32_t msec = (uint32_t)((file_time % _file_time_to_sec) / _file_time_to_msec);
+		char digits[4];
+		size_t count = 0;
+		do
+		{
+			digits[count++] = (char)('0' + msec % 10);
+			msec /= 10;
+		} while (0 != msec);
+
+		msec_str[msec_length++] = ' ';
+		while (0 < count) { msec_str[msec_length++] = digits[--count]; }
+	}
+
+	if (cache->length + msec_length >= size)
+	{
+		buffer[0] = '\0';
+		return 0;
+	}
+	RtlCopyMemory(buffer, cache->str, cache->length);
+	RtlCopyMemory(&buffer[cache->length], msec_str, msec_length);
+	buffer[cache->length + msec_length] = '\0';
+	return cache->length + msec_length;
 }
 
 /// @brief  SYSTEMTIME (UTC) to `yyyy-mm-dd hh:mi:ss` string representation.
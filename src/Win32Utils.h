@@ -185,6 +185,14 @@ std::string	time_now_to_str2();
 std::string file_time_to_str(_In_ const PFILETIME file_time, _In_ bool localtime, _In_ bool show_misec = false);
 std::string file_time_to_str(_In_ uint64_t file_time, _In_ bool localtime, _In_ bool show_misec = false);
 
+/// @brief	time_now_to_str(), file_time_to_str()  buffer  (std::string 
+///			 ), ڿ  (NULL )  Ѵ.
+///
+///			`yyyy-mm-dd hh:mi:ss` κ 庰   ĳõǹǷ  
+///			ȿ ð ȯ  иʸ δ.
+size_t time_now_to_str(_In_ bool localtime, _In_ bool show_misec, _Out_writes_z_(size) char* buffer, _In_ size_t size);
+size_t file_time_to_str(_In_ uint64_t file_time, _In_ bool localtime, _In_ bool show_misec, _Out_writes_z_(size) char* buffer, _In_ size_t size);
+
 std::string sys_time_to_str(_In_ const PSYSTEMTIME utc_sys_time, _In_ bool localtime, _In_ bool show_misec = false);
 std::string sys_time_to_str2(_In_ const PSYSTEMTIME utc_sys_time);
 
@@ -0,0 +1,312 @@
+/**
+ * @file    constexpr_hash.h
+ * @brief   GeneralHashFunctions  FNV, DJB, SDBM, BKDR ؽ constexpr 
+ *			 Ÿ perfect hash table
+ *
+ *			char ڿ ؽð FNVHash(), DJBHash(), SDBMHash(), BKDRHash()
+ *			 . wchar_t ڿ  (UTF-16 code unit) ϳ  
+ *			ؽѴ. ignore_case ̸ ASCII 빮ڸ ҹڷ ٲ㼭 ؽѴ.
+ *
+ *			//	ؽð switch (浹 ɼ Ƿ case ȿ ؾ )
+ *			switch (const_fnv_hash(name, len))
+ *			{
+ *			case "explorer.exe"_fnv: ...
+ *			}
+ *
+ *			//	perfect hash table, ؽ ѹ + ڿ  ѹ
+ *			static constexpr const wchar_t* names[] = { L"System", L"explorer.exe" };
+ *			static constexpr const_string_table<wchar_t, _countof(names), true> table(names);
+ *			switch (table.find(name))
+ *			{
+ *			case 0: ...		// System
+ *			case 1: ...		// explorer.exe
+ *			default: ...	// -1, 
+ *			}
+ *
+ *			table   ڿ  ؽð      .
+ *
+ *			table    key  x key ̿ Ѵ. (g++    16  key
+ *			ϳ  1,600 step, κ ؽ ) MSVC v141  ⺻ constexpr step 
+ *			ѵ (/constexpr:steps100000) δ ̷ key 60   Ѱ̹Ƿ,
+ *			׺ ū table   Ʈ /constexpr:steps  ÷ Ѵ.
+ *			(_MyLib_test  /constexpr:steps1048576, key 600  )
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+
+#ifndef _constexpr_hash_h_
+#define _constexpr_hash_h_
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+/// @brief	ignore_case ̸ ASCII 빮ڸ ҹڷ ٲ۴.
+template <typename CharT>
+constexpr CharT const_hash_fold(_In_ CharT c, _In_ bool ignore_case)
+{
+	return (true == ignore_case && c >= 'A' && c <= 'Z') ? (CharT)(c - 'A' + 'a') : c;
+}
+
+template <typename CharT>
+constexpr size_t const_strlen(_In_ const CharT* str)
+{
+	size_t len = 0;
+	while (0 != str[len]) { ++len; }
+	return len;
+}
+
+/// @brief	FNVHash()
+template <typename CharT>
+constexpr uint32_t const_fnv_hash(_In_ const CharT* str, _In_ size_t len, _In_ bool ignore_case = false)
+{
+	uint32_t hash = 0;
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash *= 0x811C9DC5;
+		hash ^= const_hash_fold(str[i], ignore_case);
+	}
+	return hash;
+}
+
+/// @brief	DJBHash()
+template <typename CharT>
+constexpr uint32_t const_djb_hash(_In_ const CharT* str, _In_ size_t len, _In_ bool ignore_case = false)
+{
+	uint32_t hash = 5381;
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash = ((hash << 5) + hash) + const_hash_fold(str[i], ignore_case);
+	}
+	return hash;
+}
+
+/// @brief	SDBMHash()
+template <typename CharT>
+constexpr uint32_t const_sdbm_hash(_In_ const CharT* str, _In_ size_t len, _In_ bool ignore_case = false)
+{
+	uint32_t hash = 0;
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash = const_hash_fold(str[i], ignore_case) + (hash << 6) + (hash << 16) - hash;
+	}
+	return hash;
+}
+
+/// @brief	BKDRHash()
+template <typename CharT>
+constexpr uint32_t const_bkdr_hash(_In_ const CharT* str, _In_ size_t len, _In_ bool ignore_case = false)
+{
+	uint32_t hash = 0;
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash = (hash * 131) + const_hash_fold(str[i], ignore_case);
+	}
+	return hash;
+}
+
+/// @brief	"explorer.exe"_fnv, L"explorer.exe"_fnv, ...
+///			_ifnv  ҹڸ  ʴ´.
+constexpr uint32_t operator"" _fnv(_In_ const char* str, _In_ size_t len) { return const_fnv_hash(str, len); }
+constexpr uint32_t operator"" _fnv(_In_ const wchar_t* str, _In_ size_t len) { return const_fnv_hash(str, len); }
+constexpr uint32_t operator"" _ifnv(_In_ const char* str, _In_ size_t len) { return const_fnv_hash(str, len, true); }
+constexpr uint32_t operator"" _ifnv(_In_ const wchar_t* str, _In_ size_t len) { return const_fnv_hash(str, len, true); }
+constexpr uint32_t operator"" _djb(_In_ const char* str, _In_ size_t len) { return const_djb_hash(str, len); }
+constexpr uint32_t operator"" _djb(_In_ const wchar_t* str, _In_ size_t len) { return const_djb_hash(str, len); }
+constexpr uint32_t operator"" _sdbm(_In_ const char* str, _In_ size_t len) { return const_sdbm_hash(str, len); }
+constexpr uint32_t operator"" _sdbm(_In_ const wchar_t* str, _In_ size_t len) { return const_sdbm_hash(str, len); }
+constexpr uint32_t operator"" _bkdr(_In_ const char* str, _In_ size_t len) { return const_bkdr_hash(str, len); }
+constexpr uint32_t operator"" _bkdr(_In_ const wchar_t* str, _In_ size_t len) { return const_bkdr_hash(str, len); }
+
+/// @brief	table ũ (2^bits >= 2 * count)
+constexpr uint32_t const_string_table_bits(_In_ size_t count)
+{
+	uint32_t bits = 1;
+	while (((size_t)1 << bits) < 2 * count) { ++bits; }
+	return bits;
+}
+
+/// @brief	 Ÿӿ  ڿ -> index perfect hash table
+///
+///			hash-and-displace ̴. key  ؽð bucket ( 2  )
+///			 , key   bucket  bucket   key   slot  
+///			 displacement  ã´. 
+///				m    = mix(const_fnv_hash(key) ^ seed)
+///				slot = (f1(m) + displacement[bucket(m)] * f2(m)) % table_size
+///			bucket   ãǷ key   ϴ ð .
+///			seed   bucket  key  и   ٲ۴.
+///			keys  table   static ̾ Ѵ. (͸ )
+template <typename CharT, size_t N, bool ignore_case = false>
+class const_string_table
+{
+	static_assert(0 < N, "const_string_table, empty table");
+
+public:
+	constexpr const_string_table(_In_ const CharT* const (&keys)[N])
+		: _keys{}, _lengths{}, _hashes{}, _displacements{}, _slots{}, _seed(0)
+	{
+		for (size_t i = 0; i < N; ++i)
+		{
+			_keys[i] = keys[i];
+			_lengths[i] = const_strlen(keys[i]);
+			_hashes[i] = const_fnv_hash(_keys[i], _lengths[i], ignore_case);
+		}
+
+		for (uint32_t seed = 1; seed <= max_seed; ++seed)
+		{
+			if (true == build(seed))
+			{
+				_seed = seed;
+				return;
+			}
+		}
+
+		// ؽð  key  ִ. ( Ÿ̸  )
+		throw std::logic_error("const_string_table, no perfect hash seed");
+	}
+
+	/// @brief	str  index (keys  ),  -1
+	constexpr int find(_In_ const CharT* str, _In_ size_t len) const
+	{
+		const uint32_t m = mix(const_fnv_hash(str, len, ignore_case) ^ _seed);
+		const int index = _slots[slot(m, _displacements[bucket(m)])];
+		if (-1 == index || len != _lengths[index]) return -1;
+
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (const_hash_fold(str[i], ignore_case) != const_hash_fold(_keys[index][i], ignore_case))
+			{
+				return -1;
+			}
+		}
+		return index;
+	}
+
+	constexpr int find(_In_ const CharT* str) const
+	{
+		return find(str, const_strlen(str));
+	}
+
+	constexpr size_t size() const { return N; }
+	constexpr const CharT* key(_In_ size_t index) const { return _keys[index]; }
+	constexpr uint32_t seed() const { return _seed; }
+
+private:
+	static constexpr uint32_t table_bits = const_string_table_bits(N);
+	static constexpr uint32_t table_size = (uint32_t)1 << table_bits;
+	static constexpr uint32_t bucket_bits = (table_bits > 2) ? table_bits - 2 : 1;
+	static constexpr uint32_t bucket_count = (uint32_t)1 << bucket_bits;
+	static constexpr uint32_t max_seed = 64;
+
+	/// @brief	murmur3 fmix32
+	static constexpr uint32_t mix(_In_ uint32_t hash)
+	{
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6B;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	static constexpr uint32_t bucket(_In_ uint32_t m)
+	{
+		return m >> (32 - bucket_bits);
+	}
+
+	/// @brief	f2  Ȧ̹Ƿ displacement  0 ~ table_size - 1  ٲٸ 
+	///			 slot  ѹ .
+	static constexpr uint32_t slot(_In_ uint32_t m, _In_ uint32_t displacement)
+	{
+		const uint32_t f1 = mix(m ^ 0x9E3779B9);
+		const uint32_t f2 = mix(m + 0x7F4A7C15) | 1;
+		return (f1 + displacement * f2) & (table_size - 1);
+	}
+
+	/// @brief	seed  _slots, _displacements  . 
+	///			 bucket  key  и   false
+	constexpr bool build(_In_ uint32_t seed)
+	{
+		//
+		// bucket  key  (counting sort)
+		//
+		uint32_t m[N] = {};
+		uint32_t begin[bucket_count + 1] = {};
+		uint32_t filled[bucket_count] = {};
+		uint32_t order[N] = {};
+		for (size_t i = 0; i < N; ++i)
+		{
+			m[i] = mix(_hashes[i] ^ seed);
+			++begin[bucket(m[i]) + 1];
+		}
+
+		uint32_t max_size = 0;
+		for (uint32_t b = 0; b < bucket_count; ++b)
+		{
+			if (begin[b + 1] > max_size) { max_size = begin[b + 1]; }
+			begin[b + 1] += begin[b];
+		}
+
+		for (size_t i = 0; i < N; ++i)
+		{
+			const uint32_t b = bucket(m[i]);
+			order[begin[b] + filled[b]++] = (uint32_t)i;
+		}
+
+		for (uint32_t s = 0; s < table_size; ++s) { _slots[s] = -1; }
+		for (uint32_t b = 0; b < bucket_count; ++b) { _displacements[b] = 0; }
+
+		//
+		// key   bucket  displacement  ã´.
+		//
+		for (uint32_t size = max_size; size > 0; --size)
+		{
+			for (uint32_t b = 0; b < bucket_count; ++b)
+			{
+				if (size != begin[b + 1] - begin[b]) continue;
+
+				bool placed = false;
+				for (uint32_t d = 0; d < table_size && true != placed; ++d)
+				{
+					uint32_t k = 0;
+					for (; k < size; ++k)
+					{
+						const uint32_t s = slot(m[order[begin[b] + k]], d);
+						if (-1 != _slots[s]) break;
+						_slots[s] = (int)order[begin[b] + k];
+					}
+
+					if (k == size)
+					{
+						_displacements[b] = d;
+						placed = true;
+					}
+					else
+					{
+						// ̹ displacement  ä slot  ǵ.
+						while (0 < k)
+						{
+							--k;
+							_slots[slot(m[order[begin[b] + k]], d)] = -1;
+						}
+					}
+				}
+
+				if (true != placed) return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	const CharT*	_keys[N];
+	size_t			_lengths[N];
+	uint32_t		_hashes[N];
+	uint32_t		_displacements[bucket_count];
+	int				_slots[table_size];
+	uint32_t		_seed;
+};
+
+#endif//_constexpr_hash_h_
@@ -38,6 +38,8 @@
  * POSSIBILITY OF SUCH DAMAGE. */
 #include <stdafx.h>
 #include <stdint.h>
+#include <string.h>
+#include "crc64.h"
 
 static const uint64_t crc64_tab[256] = {
     UINT64_C(0x0000000000000000), UINT64_C(0x7ad870c830358979),
@@ -170,7 +172,129 @@ static const uint64_t crc64_tab[256] = {
     UINT64_C(0x536fa08fdfd90e51), UINT64_C(0x29b7d047efec8728),
 };
 
-uint64_t crc64(uint64_t crc, const unsigned char *s, uint64_t l) {
+/* crc64_tab[] processes one byte per lookup. The faster versions below
+ * all compute the same reflected CRC-64/Jones update:
+ *
+ *   - slicing-by-8/16: 8 or 16 tables (generated from crc64_tab on first
+ *     use) process 8 or 16 bytes per step.
+ *   - PCLMULQDQ: 64 bytes per step are folded into four 128-bit
+ *     accumulators with carry-less multiplication, the folded 16 bytes and
+ *     the tail then go through the slicing-by-8 tables.
+ *
+ * The polynomial math in the reflected domain: bit 0 of a 64-bit value is
+ * the coefficient of x^63, so shifting right by one multiplies by x.
+ */
+
+#define CRC64_POLY_REFLECTED UINT64_C(0x95ac9329ac4bc9b5)
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define CRC64_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+#if defined(__GNUC__)
+#  define CRC64_TARGET(x) __attribute__((target(x)))
+#else
+#  define CRC64_TARGET(x)
+#endif
+
+/* r * x mod P */
+static inline uint64_t crc64_mulx(uint64_t r) {
+    return (r >> 1) ^ ((r & 1) ? CRC64_POLY_REFLECTED : 0);
+}
+
+/* a * b mod P */
+static uint64_t crc64_mulmod(uint64_t a, uint64_t b) {
+    uint64_t r = 0;
+    int i;
+
+    /* Horner from the highest degree (bit 0) of a */
+    for (i = 0; i < 64; i++) {
+        r = crc64_mulx(r);
+        if ((a >> i) & 1) r ^= b;
+    }
+    return r;
+}
+
+/* x^n mod P */
+static uint64_t crc64_xpow(uint64_t n) {
+    uint64_t r = UINT64_C(1) << 63;     /* x^0 */
+
+    while (n--) r = crc64_mulx(r);
+    return r;
+}
+
+typedef struct {
+    uint64_t slice[16][256];    /* slice[0] == crc64_tab */
+    uint64_t xpow8[64];         /* x^(8 * 2^k) mod P, for crc64_combine() */
+    uint64_t fold128[2];        /* x^(128 + 63), x^(128 - 1) mod P */
+    uint64_t fold512[2];        /* x^(512 + 63), x^(512 - 1) mod P */
+    int impl;
+} crc64_tables_t;
+
+static inline uint64_t crc64_load64(const unsigned char *s) {
+#if defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64) || \
+    (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+    uint64_t v;
+    memcpy(&v, s, sizeof(v));
+    return v;
+#else
+    return (uint64_t)s[0] | ((uint64_t)s[1] << 8) | ((uint64_t)s[2] << 16) |
+        ((uint64_t)s[3] << 24) | ((uint64_t)s[4] << 32) | ((uint64_t)s[5] << 40) |
+        ((uint64_t)s[6] << 48) | ((uint64_t)s[7] << 56);
+#endif
+}
+
+static int crc64_cpu_has_clmul(void) {
+#if defined(CRC64_X86)
+#  if defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 1);
+    return (r[2] & (1 << 1)) != 0;
+#  else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    if (!__get_cpuid(1, &a, &b, &c, &d)) return 0;
+    return (c & (1 << 1)) != 0;
+#  endif
+#else
+    return 0;
+#endif
+}
+
+static crc64_tables_t *crc64_tables(void) {
+    static crc64_tables_t tables = []() {
+        crc64_tables_t t;
+        int i, k;
+
+        for (i = 0; i < 256; i++) t.slice[0][i] = crc64_tab[i];
+        for (k = 1; k < 16; k++) {
+            for (i = 0; i < 256; i++) {
+                uint64_t crc = t.slice[k - 1][i];
+                t.slice[k][i] = t.slice[0][crc & 0xff] ^ (crc >> 8);
+            }
+        }
+
+        t.xpow8[0] = crc64_xpow(8);
+        for (k = 1; k < 64; k++)
+            t.xpow8[k] = crc64_mulmod(t.xpow8[k - 1], t.xpow8[k - 1]);
+
+        t.fold128[0] = crc64_xpow(128 + 63);
+        t.fold128[1] = crc64_xpow(128 - 1);
+        t.fold512[0] = crc64_xpow(512 + 63);
+        t.fold512[1] = crc64_xpow(512 - 1);
+
+        t.impl = crc64_cpu_has_clmul() ? CRC64_IMPL_CLMUL : CRC64_IMPL_SLICE16;
+        return t;
+    }();
+    return &tables;
+}
+
+static uint64_t crc64_byte(uint64_t crc, const unsigned char *s, uint64_t l) {
     uint64_t j;
 
     for (j = 0; j < l; j++) {
@@ -180,6 +304,152 @@ uint64_t crc64(uint64_t crc, const unsigned char *s, uint64_t l) {
     return crc;
 }
 
+static uint64_t crc64_slice8(const crc64_tables_t *t, uint64_t crc,
+                             const unsigned char *s, uint64_t l) {
+    const uint64_t (*T)[256] = t->slice;
+
+    while (l >= 8) {
+        crc ^= crc64_load64(s);
+        crc = T[7][crc & 0xff] ^ T[6][(crc >> 8) & 0xff] ^
+              T[5][(crc >> 16) & 0xff] ^ T[4][(crc >> 24) & 0xff] ^
+              T[3][(crc >> 32) & 0xff] ^ T[2][(crc >> 40) & 0xff] ^
+              T[1][(crc >> 48) & 0xff] ^ T[0][crc >> 56];
+        s += 8;
+        l -= 8;
+    }
+    return crc64_byte(crc, s, l);
+}
+
+static uint64_t crc64_slice16(const crc64_tables_t *t, uint64_t crc,
+                              const unsigned char *s, uint64_t l) {
+    const uint64_t (*T)[256] = t->slice;
+
+    while (l >= 16) {
+        uint64_t hi = crc64_load64(s + 8);
+        crc ^= crc64_load64(s);
+        crc = T[15][crc & 0xff] ^ T[14][(crc >> 8) & 0xff] ^
+              T[13][(crc >> 16) & 0xff] ^ T[12][(crc >> 24) & 0xff] ^
+              T[11][(crc >> 32) & 0xff] ^ T[10][(crc >> 40) & 0xff] ^
+              T[9][(crc >> 48) & 0xff] ^ T[8][crc >> 56] ^
+              T[7][hi & 0xff] ^ T[6][(hi >> 8) & 0xff] ^
+              T[5][(hi >> 16) & 0xff] ^ T[4][(hi >> 24) & 0xff] ^
+              T[3][(hi >> 32) & 0xff] ^ T[2][(hi >> 40) & 0xff] ^
+              T[1][(hi >> 48) & 0xff] ^ T[0][hi >> 56];
+        s += 16;
+        l -= 16;
+    }
+    return crc64_slice8(t, crc, s, l);
+}
+
+#if defined(CRC64_X86)
+/* Folds 16 byte chunks: with the chunk X = H * x^64 + L (H is the low
+ * qword, the earlier bytes), X * x^d = H * x^(d + 64) + L * x^d. The
+ * carry-less product of two reflected values comes out multiplied by x,
+ * so the constants are x^(d + 63) and x^(d - 1). */
+CRC64_TARGET("pclmul,sse2")
+static inline __m128i crc64_fold(__m128i x, __m128i k) {
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00),
+                         _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+CRC64_TARGET("pclmul,sse2")
+static uint64_t crc64_clmul(const crc64_tables_t *t, uint64_t crc,
+                            const unsigned char *s, uint64_t l) {
+    if (l < 128) return crc64_slice16(t, crc, s, l);
+
+    const __m128i k128 = _mm_set_epi64x((long long)t->fold128[1], (long long)t->fold128[0]);
+    const __m128i k512 = _mm_set_epi64x((long long)t->fold512[1], (long long)t->fold512[0]);
+    unsigned char folded[16];
+
+    /* the crc is xor'ed into the first 8 bytes */
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)s),
+                               _mm_set_epi64x(0, (long long)crc));
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(s + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(s + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(s + 48));
+    s += 64;
+    l -= 64;
+
+    while (l >= 64) {
+        x0 = _mm_xor_si128(crc64_fold(x0, k512), _mm_loadu_si128((const __m128i *)s));
+        x1 = _mm_xor_si128(crc64_fold(x1, k512), _mm_loadu_si128((const __m128i *)(s + 16)));
+        x2 = _mm_xor_si128(crc64_fold(x2, k512), _mm_loadu_si128((const __m128i *)(s + 32)));
+        x3 = _mm_xor_si128(crc64_fold(x3, k512), _mm_loadu_si128((const __m128i *)(s + 48)));
+        s += 64;
+        l -= 64;
+    }
+
+    x0 = _mm_xor_si128(crc64_fold(x0, k128), x1);
+    x0 = _mm_xor_si128(crc64_fold(x0, k128), x2);
+    x0 = _mm_xor_si128(crc64_fold(x0, k128), x3);
+    while (l >= 16) {
+        x0 = _mm_xor_si128(crc64_fold(x0, k128), _mm_loadu_si128((const __m128i *)s));
+        s += 16;
+        l -= 16;
+    }
+
+    /* the folded 16 bytes are congruent to the whole input so far */
+    _mm_storeu_si128((__m128i *)folded, x0);
+    crc = crc64_slice8(t, 0, folded, sizeof(folded));
+    return crc64_slice8(t, crc, s, l);
+}
+#endif
+
+uint64_t crc64(uint64_t crc, const unsigned char *s, uint64_t l) {
+    const crc64_tables_t *t = crc64_tables();
+
+    switch (t->impl) {
+#if defined(CRC64_X86)
+    case CRC64_IMPL_CLMUL: return crc64_clmul(t, crc, s, l);
+#endif
+    case CRC64_IMPL_SLICE16: return crc64_slice16(t, crc, s, l);
+    case CRC64_IMPL_SLICE8: return crc64_slice8(t, crc, s, l);
+    }
+    return crc64_byte(crc, s, l);
+}
+
+int crc64_get_impl(void) {
+    return crc64_tables()->impl;
+}
+
+/* not thread safe, crc64() must not run while switching */
+int crc64_set_impl(int impl) {
+    switch (impl) {
+    case CRC64_IMPL_BYTE:
+    case CRC64_IMPL_SLICE8:
+    case CRC64_IMPL_SLICE16:
+        break;
+    case CRC64_IMPL_CLMUL:
+        if (!crc64_cpu_has_clmul()) return 0;
+        break;
+    default:
+        return 0;
+    }
+    crc64_tables()->impl = impl;
+    return 1;
+}
+
+const char *crc64_impl_name(int impl) {
+    switch (impl) {
+    case CRC64_IMPL_BYTE: return "byte";
+    case CRC64_IMPL_SLICE8: return "slice8";
+    case CRC64_IMPL_SLICE16: return "slice16";
+    case CRC64_IMPL_CLMUL: return "pclmulqdq";
+    }
+    return "unknown";
+}
+
+uint64_t crc64_combine(uint64_t crc_a, uint64_t crc_b, uint64_t len_b) {
+    const crc64_tables_t *t = crc64_tables();
+    int k;
+
+    /* crc_a * x^(8 * len_b) mod P, xor crc_b */
+    for (k = 0; len_b != 0; k++, len_b >>= 1) {
+        if (len_b & 1) crc_a = crc64_mulmod(crc_a, t->xpow8[k]);
+    }
+    return crc_a ^ crc_b;
+}
+
 /* Test main */
 #ifdef REDIS_TEST
 #include <stdio.h>
@@ -5,6 +5,23 @@
 
 uint64_t crc64(uint64_t crc, const unsigned char *s, uint64_t l);
 
+/* crc64 of A + B from crc64(0, A), crc64(0, B) and the length of B, so
+ * chunks of a buffer can be checksummed in parallel and merged:
+ * crc64(crc, A + B, ...) == crc64_combine(crc64(crc, A, len_a), crc64(0, B, len_b), len_b) */
+uint64_t crc64_combine(uint64_t crc_a, uint64_t crc_b, uint64_t len_b);
+
+/* implementations of crc64(), all produce identical results. The fastest
+ * one the CPU supports is selected on first use, crc64_set_impl() can
+ * force another one (for testing) and returns 0 if it is not supported. */
+#define CRC64_IMPL_BYTE     0   /* one table lookup per byte */
+#define CRC64_IMPL_SLICE8   1   /* slicing-by-8 */
+#define CRC64_IMPL_SLICE16  2   /* slicing-by-16 */
+#define CRC64_IMPL_CLMUL    3   /* x86 PCLMULQDQ folding */
+
+int crc64_get_impl(void);
+int crc64_set_impl(int impl);
+const char *crc64_impl_name(int impl);
+
 #ifdef REDIS_TEST
 int crc64Test(int argc, char *argv[]);
 #endif
@@ -0,0 +1,855 @@
+/**
+ * @file    hash_mb.cpp
+ * @brief   multi-buffer sha256 / md5 / sha384 / sha512
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+
+#include "stdafx.h"
+#include <string.h>
+#include <algorithm>
+#include "hash_mb.h"
+#include "md5.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define hash_mb_x86
+#include <immintrin.h>
+#endif
+
+/// @brief	GCC/clang  SIMD   Լ target  ؾ Ѵ.
+#if defined(__GNUC__)
+#define hash_mb_target(x)	__attribute__((target(x)))
+#else
+#define hash_mb_target(x)
+#endif
+
+/// @brief	md5  (RFC 1321)
+static const uint32_t _md5_k[64] = {
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+	0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+	0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+	0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+	0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+	0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+	0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+/// @brief	md5 round  rotate  message word index
+static const uint32_t _md5_r[64] = {
+	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+	5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static const uint32_t _md5_m[64] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	1, 6, 11, 0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12,
+	5, 8, 11, 14, 1, 4, 7, 10, 13, 0, 3, 6, 9, 12, 15, 2,
+	0, 7, 14, 5, 12, 3, 10, 1, 8, 15, 6, 13, 4, 11, 2, 9
+};
+
+static const uint32_t _md5_iv[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+/// @brief	little endian 32 bit load (ĵ  ּ)
+static inline uint32_t mb_load32(_In_ const unsigned char* p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t mb_load64(_In_ const unsigned char* p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/// @brief	sha384/sha512 kernel  state  [word][lane] 64 bit  Ѵ.
+typedef uint64_t (*mb_state64)[hash_mb_lanes_max / 2];
+
+
+// ============================================================================
+//
+//	kernels
+//
+//	state[word][lane]  data[lane]  blocks  block  Ѵ.
+//	(sha384/sha512  state64[word][lane])
+//	active   lane  bitmask ̸,  ʴ lane  data 
+//	  ִ ּҿ Ѵ. (vector kernel   lane  Ѵ)
+//
+// ============================================================================
+
+/// @brief	sha256, lane  ϳ sha256_compile_blocks()  óѴ.
+static void
+sha256_mb_scalar(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	for (uint32_t lane = 0; lane < 4; ++lane)
+	{
+		if (0 == (active & (1 << lane))) continue;
+
+		sha2_32t hash[8];
+		for (int i = 0; i < 8; ++i) { hash[i] = state[i][lane]; }
+		sha256_compile_blocks(hash, data[lane], (unsigned long)blocks);
+		for (int i = 0; i < 8; ++i) { state[i][lane] = hash[i]; }
+	}
+}
+
+/// @brief	md5, lane  ϳ MD5Blocks()  óѴ.
+static void
+md5_mb_scalar(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	for (uint32_t lane = 0; lane < 4; ++lane)
+	{
+		if (0 == (active & (1 << lane))) continue;
+
+		uint32_t hash[4];
+		for (int i = 0; i < 4; ++i) { hash[i] = state[i][lane]; }
+		MD5Blocks(hash, data[lane], blocks);
+		for (int i = 0; i < 4; ++i) { state[i][lane] = hash[i]; }
+	}
+}
+
+/// @brief	sha384/sha512, lane  ϳ sha512_compile_blocks()  óѴ.
+static void
+sha512_mb_scalar(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	mb_state64 state64 = (mb_state64)state;
+	for (uint32_t lane = 0; lane < 4; ++lane)
+	{
+		if (0 == (active & (1 << lane))) continue;
+
+		sha2_64t hash[8];
+		for (int i = 0; i < 8; ++i) { hash[i] = state64[i][lane]; }
+		sha512_compile_blocks(hash, data[lane], (unsigned long)blocks);
+		for (int i = 0; i < 8; ++i) { state64[i][lane] = hash[i]; }
+	}
+}
+
+#if defined(hash_mb_x86)
+
+//
+//	AVX2, 8 lane
+//
+
+#define v8_rotr(x, n)	_mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define v8_rotl_var(x, n) \
+	_mm256_or_si256(_mm256_sll_epi32((x), _mm_cvtsi32_si128(n)), _mm256_srl_epi32((x), _mm_cvtsi32_si128(32 - (n))))
+#define v8_xor3(a, b, c)	_mm256_xor_si256(_mm256_xor_si256((a), (b)), (c))
+
+/// @brief	lane  data[lane] + offset  32 bit word  ϳ vector  .
+#define v8_gather(data, offset) \
+	_mm256_set_epi32((int)mb_load32(data[7] + (offset)), (int)mb_load32(data[6] + (offset)), \
+					 (int)mb_load32(data[5] + (offset)), (int)mb_load32(data[4] + (offset)), \
+					 (int)mb_load32(data[3] + (offset)), (int)mb_load32(data[2] + (offset)), \
+					 (int)mb_load32(data[1] + (offset)), (int)mb_load32(data[0] + (offset)))
+
+hash_mb_target("avx2")
+static void
+sha256_mb_avx2(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	UNREFERENCED_PARAMETER(active);
+	const __m256i bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+											0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m256i s[8];
+	for (int i = 0; i < 8; ++i) { s[i] = _mm256_loadu_si256((const __m256i*)state[i]); }
+
+	for (size_t offset = 0; offset < blocks * SHA256_BLOCK_SIZE; offset += SHA256_BLOCK_SIZE)
+	{
+		__m256i w[16];
+		for (int t = 0; t < 16; ++t)
+		{
+			w[t] = _mm256_shuffle_epi8(v8_gather(data, offset + 4 * t), bswap);
+		}
+
+		__m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+		for (int t = 0; t < 64; ++t)
+		{
+			if (t >= 16)
+			{
+				__m256i w2 = w[(t - 2) & 15];
+				__m256i w15 = w[(t - 15) & 15];
+				__m256i g1 = v8_xor3(v8_rotr(w2, 17), v8_rotr(w2, 19), _mm256_srli_epi32(w2, 10));
+				__m256i g0 = v8_xor3(v8_rotr(w15, 7), v8_rotr(w15, 18), _mm256_srli_epi32(w15, 3));
+				w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], g0),
+											 _mm256_add_epi32(g1, w[(t - 7) & 15]));
+			}
+
+			__m256i s1 = v8_xor3(v8_rotr(e, 6), v8_rotr(e, 11), v8_rotr(e, 25));
+			__m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+			__m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1),
+										  _mm256_add_epi32(ch, _mm256_add_epi32(w[t & 15], _mm256_set1_epi32((int)k256[t]))));
+			__m256i s0 = v8_xor3(v8_rotr(a, 2), v8_rotr(a, 13), v8_rotr(a, 22));
+			__m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+			__m256i t2 = _mm256_add_epi32(s0, maj);
+
+			h = g; g = f; f = e;
+			e = _mm256_add_epi32(d, t1);
+			d = c; c = b; b = a;
+			a = _mm256_add_epi32(t1, t2);
+		}
+
+		s[0] = _mm256_add_epi32(s[0], a); s[1] = _mm256_add_epi32(s[1], b);
+		s[2] = _mm256_add_epi32(s[2], c); s[3] = _mm256_add_epi32(s[3], d);
+		s[4] = _mm256_add_epi32(s[4], e); s[5] = _mm256_add_epi32(s[5], f);
+		s[6] = _mm256_add_epi32(s[6], g); s[7] = _mm256_add_epi32(s[7], h);
+	}
+
+	for (int i = 0; i < 8; ++i) { _mm256_storeu_si256((__m256i*)state[i], s[i]); }
+}
+
+hash_mb_target("avx2")
+static void
+md5_mb_avx2(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	UNREFERENCED_PARAMETER(active);
+	const __m256i ones = _mm256_set1_epi32(-1);
+	__m256i s[4];
+	for (int i = 0; i < 4; ++i) { s[i] = _mm256_loadu_si256((const __m256i*)state[i]); }
+
+	for (size_t offset = 0; offset < blocks * 64; offset += 64)
+	{
+		__m256i m[16];
+		for (int i = 0; i < 16; ++i) { m[i] = v8_gather(data, offset + 4 * i); }
+
+		__m256i a = s[0], b = s[1], c = s[2], d = s[3];
+		for (int i = 0; i < 64; ++i)
+		{
+			__m256i f;
+			if (i < 16)			f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d));
+			else if (i < 32)	f = _mm256_or_si256(_mm256_and_si256(d, b), _mm256_andnot_si256(d, c));
+			else if (i < 48)	f = v8_xor3(b, c, d);
+			else				f = _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, ones)));
+
+			f = _mm256_add_epi32(_mm256_add_epi32(f, a),
+								 _mm256_add_epi32(m[_md5_m[i]], _mm256_set1_epi32((int)_md5_k[i])));
+			a = d; d = c; c = b;
+			b = _mm256_add_epi32(b, v8_rotl_var(f, (int)_md5_r[i]));
+		}
+
+		s[0] = _mm256_add_epi32(s[0], a); s[1] = _mm256_add_epi32(s[1], b);
+		s[2] = _mm256_add_epi32(s[2], c); s[3] = _mm256_add_epi32(s[3], d);
+	}
+
+	for (int i = 0; i < 4; ++i) { _mm256_storeu_si256((__m256i*)state[i], s[i]); }
+}
+
+//
+//	AVX2, sha384/sha512 4 lane
+//
+
+#define v4_rotr(x, n)	_mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+
+#define v4_gather(data, offset) \
+	_mm256_set_epi64x((long long)mb_load64(data[3] + (offset)), (long long)mb_load64(data[2] + (offset)), \
+					  (long long)mb_load64(data[1] + (offset)), (long long)mb_load64(data[0] + (offset)))
+
+hash_mb_target("avx2")
+static void
+sha512_mb_avx2(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	UNREFERENCED_PARAMETER(active);
+	mb_state64 state64 = (mb_state64)state;
+	const __m256i bswap = _mm256_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL,
+											0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+	__m256i s[8];
+	for (int i = 0; i < 8; ++i) { s[i] = _mm256_loadu_si256((const __m256i*)state64[i]); }
+
+	for (size_t offset = 0; offset < blocks * SHA512_BLOCK_SIZE; offset += SHA512_BLOCK_SIZE)
+	{
+		__m256i w[16];
+		for (int t = 0; t < 16; ++t)
+		{
+			w[t] = _mm256_shuffle_epi8(v4_gather(data, offset + 8 * t), bswap);
+		}
+
+		__m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+		for (int t = 0; t < 80; ++t)
+		{
+			if (t >= 16)
+			{
+				__m256i w2 = w[(t - 2) & 15];
+				__m256i w15 = w[(t - 15) & 15];
+				__m256i g1 = v8_xor3(v4_rotr(w2, 19), v4_rotr(w2, 61), _mm256_srli_epi64(w2, 6));
+				__m256i g0 = v8_xor3(v4_rotr(w15, 1), v4_rotr(w15, 8), _mm256_srli_epi64(w15, 7));
+				w[t & 15] = _mm256_add_epi64(_mm256_add_epi64(w[t & 15], g0),
+											 _mm256_add_epi64(g1, w[(t - 7) & 15]));
+			}
+
+			__m256i s1 = v8_xor3(v4_rotr(e, 14), v4_rotr(e, 18), v4_rotr(e, 41));
+			__m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+			__m256i t1 = _mm256_add_epi64(_mm256_add_epi64(h, s1),
+										  _mm256_add_epi64(ch, _mm256_add_epi64(w[t & 15], _mm256_set1_epi64x((long long)k512[t]))));
+			__m256i s0 = v8_xor3(v4_rotr(a, 28), v4_rotr(a, 34), v4_rotr(a, 39));
+			__m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+			__m256i t2 = _mm256_add_epi64(s0, maj);
+
+			h = g; g = f; f = e;
+			e = _mm256_add_epi64(d, t1);
+			d = c; c = b; b = a;
+			a = _mm256_add_epi64(t1, t2);
+		}
+
+		s[0] = _mm256_add_epi64(s[0], a); s[1] = _mm256_add_epi64(s[1], b);
+		s[2] = _mm256_add_epi64(s[2], c); s[3] = _mm256_add_epi64(s[3], d);
+		s[4] = _mm256_add_epi64(s[4], e); s[5] = _mm256_add_epi64(s[5], f);
+		s[6] = _mm256_add_epi64(s[6], g); s[7] = _mm256_add_epi64(s[7], h);
+	}
+
+	for (int i = 0; i < 8; ++i) { _mm256_storeu_si256((__m256i*)state64[i], s[i]); }
+}
+
+//
+//	AVX-512, 16 lane (sha384/sha512 8 lane)
+//	rotate  (vprord), ternary logic (vpternlogd)  Ѵ.
+//
+
+#define v16_gather(data, offset) \
+	_mm512_set_epi32((int)mb_load32(data[15] + (offset)), (int)mb_load32(data[14] + (offset)), \
+					 (int)mb_load32(data[13] + (offset)), (int)mb_load32(data[12] + (offset)), \
+					 (int)mb_load32(data[11] + (offset)), (int)mb_load32(data[10] + (offset)), \
+					 (int)mb_load32(data[9] + (offset)),  (int)mb_load32(data[8] + (offset)), \
+					 (int)mb_load32(data[7] + (offset)),  (int)mb_load32(data[6] + (offset)), \
+					 (int)mb_load32(data[5] + (offset)),  (int)mb_load32(data[4] + (offset)), \
+					 (int)mb_load32(data[3] + (offset)),  (int)mb_load32(data[2] + (offset)), \
+					 (int)mb_load32(data[1] + (offset)),  (int)mb_load32(data[0] + (offset)))
+
+#define v16_xor3(a, b, c)	_mm512_ternarylogic_epi32((a), (b), (c), 0x96)
+#define v16_ch(x, y, z)		_mm512_ternarylogic_epi32((x), (y), (z), 0xca)	// x ? y : z
+#define v16_maj(x, y, z)	_mm512_ternarylogic_epi32((x), (y), (z), 0xe8)
+#define v16_md5_i(x, y, z)	_mm512_ternarylogic_epi32((x), (y), (z), 0x39)	// y ^ (x | ~z)
+
+hash_mb_target("avx512f,avx512bw")
+static void
+sha256_mb_avx512(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	UNREFERENCED_PARAMETER(active);
+	const __m512i bswap = _mm512_broadcast_i32x4(_mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL));
+	__m512i s[8];
+	for (int i = 0; i < 8; ++i) { s[i] = _mm512_loadu_si512((const void*)state[i]); }
+
+	for (size_t offset = 0; offset < blocks * SHA256_BLOCK_SIZE; offset += SHA256_BLOCK_SIZE)
+	{
+		__m512i w[16];
+		for (int t = 0; t < 16; ++t)
+		{
+			w[t] = _mm512_shuffle_epi8(v16_gather(data, offset + 4 * t), bswap);
+		}
+
+		__m512i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+		for (int t = 0; t < 64; ++t)
+		{
+			if (t >= 16)
+			{
+				__m512i w2 = w[(t - 2) & 15];
+				__m512i w15 = w[(t - 15) & 15];
+				__m512i g1 = v16_xor3(_mm512_ror_epi32(w2, 17), _mm512_ror_epi32(w2, 19), _mm512_srli_epi32(w2, 10));
+				__m512i g0 = v16_xor3(_mm512_ror_epi32(w15, 7), _mm512_ror_epi32(w15, 18), _mm512_srli_epi32(w15, 3));
+				w[t & 15] = _mm512_add_epi32(_mm512_add_epi32(w[t & 15], g0),
+											 _mm512_add_epi32(g1, w[(t - 7) & 15]));
+			}
+
+			__m512i s1 = v16_xor3(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25));
+			__m512i t1 = _mm512_add_epi32(_mm512_add_epi32(h, s1),
+										  _mm512_add_epi32(v16_ch(e, f, g), _mm512_add_epi32(w[t & 15], _mm512_set1_epi32((int)k256[t]))));
+			__m512i s0 = v16_xor3(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22));
+			__m512i t2 = _mm512_add_epi32(s0, v16_maj(a, b, c));
+
+			h = g; g = f; f = e;
+			e = _mm512_add_epi32(d, t1);
+			d = c; c = b; b = a;
+			a = _mm512_add_epi32(t1, t2);
+		}
+
+		s[0] = _mm512_add_epi32(s[0], a); s[1] = _mm512_add_epi32(s[1], b);
+		s[2] = _mm512_add_epi32(s[2], c); s[3] = _mm512_add_epi32(s[3], d);
+		s[4] = _mm512_add_epi32(s[4], e); s[5] = _mm512_add_epi32(s[5], f);
+		s[6] = _mm512_add_epi32(s[6], g); s[7] = _mm512_add_epi32(s[7], h);
+	}
+
+	for (int i = 0; i < 8; ++i) { _mm512_storeu_si512((void*)state[i], s[i]); }
+}
+
+hash_mb_target("avx512f,avx512bw")
+static void
+md5_mb_avx512(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	UNREFERENCED_PARAMETER(active);
+	__m512i s[4];
+	for (int i = 0; i < 4; ++i) { s[i] = _mm512_loadu_si512((const void*)state[i]); }
+
+	for (size_t offset = 0; offset < blocks * 64; offset += 64)
+	{
+		__m512i m[16];
+		for (int i = 0; i < 16; ++i) { m[i] = v16_gather(data, offset + 4 * i); }
+
+		__m512i a = s[0], b = s[1], c = s[2], d = s[3];
+		for (int i = 0; i < 64; ++i)
+		{
+			__m512i f;
+			if (i < 16)			f = v16_ch(b, c, d);
+			else if (i < 32)	f = v16_ch(d, b, c);
+			else if (i < 48)	f = v16_xor3(b, c, d);
+			else				f = v16_md5_i(b, c, d);
+
+			f = _mm512_add_epi32(_mm512_add_epi32(f, a),
+								 _mm512_add_epi32(m[_md5_m[i]], _mm512_set1_epi32((int)_md5_k[i])));
+			a = d; d = c; c = b;
+			b = _mm512_add_epi32(b, _mm512_rolv_epi32(f, _mm512_set1_epi32((int)_md5_r[i])));
+		}
+
+		s[0] = _mm512_add_epi32(s[0], a); s[1] = _mm512_add_epi32(s[1], b);
+		s[2] = _mm512_add_epi32(s[2], c); s[3] = _mm512_add_epi32(s[3], d);
+	}
+
+	for (int i = 0; i < 4; ++i) { _mm512_storeu_si512((void*)state[i], s[i]); }
+}
+
+#define v8q_gather(data, offset) \
+	_mm512_set_epi64((long long)mb_load64(data[7] + (offset)), (long long)mb_load64(data[6] + (offset)), \
+					 (long long)mb_load64(data[5] + (offset)), (long long)mb_load64(data[4] + (offset)), \
+					 (long long)mb_load64(data[3] + (offset)), (long long)mb_load64(data[2] + (offset)), \
+					 (long long)mb_load64(data[1] + (offset)), (long long)mb_load64(data[0] + (offset)))
+
+#define v8q_xor3(a, b, c)	_mm512_ternarylogic_epi64((a), (b), (c), 0x96)
+#define v8q_ch(x, y, z)		_mm512_ternarylogic_epi64((x), (y), (z), 0xca)
+#define v8q_maj(x, y, z)	_mm512_ternarylogic_epi64((x), (y), (z), 0xe8)
+
+hash_mb_target("avx512f,avx512bw")
+static void
+sha512_mb_avx512(
+	_Inout_ uint32_t state[][hash_mb_lanes_max],
+	_In_ const unsigned char* data[hash_mb_lanes_max],
+	_In_ uint32_t active,
+	_In_ size_t blocks
+	)
+{
+	UNREFERENCED_PARAMETER(active);
+	mb_state64 state64 = (mb_state64)state;
+	const __m512i bswap = _mm512_broadcast_i32x4(_mm_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL));
+	__m512i s[8];
+	for (int i = 0; i < 8; ++i) { s[i] = _mm512_loadu_si512((const void*)state64[i]); }
+
+	for (size_t offset = 0; offset < blocks * SHA512_BLOCK_SIZE; offset += SHA512_BLOCK_SIZE)
+	{
+		__m512i w[16];
+		for (int t = 0; t < 16; ++t)
+		{
+			w[t] = _mm512_shuffle_epi8(v8q_gather(data, offset + 8 * t), bswap);
+		}
+
+		__m512i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+		for (int t = 0; t < 80; ++t)
+		{
+			if (t >= 16)
+			{
+				__m512i w2 = w[(t - 2) & 15];
+				__m512i w15 = w[(t - 15) & 15];
+				__m512i g1 = v8q_xor3(_mm512_ror_epi64(w2, 19), _mm512_ror_epi64(w2, 61), _mm512_srli_epi64(w2, 6));
+				__m512i g0 = v8q_xor3(_mm512_ror_epi64(w15, 1), _mm512_ror_epi64(w15, 8), _mm512_srli_epi64(w15, 7));
+				w[t & 15] = _mm512_add_epi64(_mm512_add_epi64(w[t & 15], g0),
+											 _mm512_add_epi64(g1, w[(t - 7) & 15]));
+			}
+
+			__m512i s1 = v8q_xor3(_mm512_ror_epi64(e, 14), _mm512_ror_epi64(e, 18), _mm512_ror_epi64(e, 41));
+			__m512i t1 = _mm512_add_epi64(_mm512_add_epi64(h, s1),
+										  _mm512_add_epi64(v8q_ch(e, f, g), _mm512_add_epi64(w[t & 15], _mm512_set1_epi64((long long)k512[t]))));
+			__m512i s0 = v8q_xor3(_mm512_ror_epi64(a, 28), _mm512_ror_epi64(a, 34), _mm512_ror_epi64(a, 39));
+			__m512i t2 = _mm512_add_epi64(s0, v8q_maj(a, b, c));
+
+			h = g; g = f; f = e;
+			e = _mm512_add_epi64(d, t1);
+			d = c; c = b; b = a;
+			a = _mm512_add_epi64(t1, t2);
+		}
+
+		s[0] = _mm512_add_epi64(s[0], a); s[1] = _mm512_add_epi64(s[1], b);
+		s[2] = _mm512_add_epi64(s[2], c); s[3] = _mm512_add_epi64(s[3], d);
+		s[4] = _mm512_add_epi64(s[4], e); s[5] = _mm512_add_epi64(s[5], f);
+		s[6] = _mm512_add_epi64(s[6], g); s[7] = _mm512_add_epi64(s[7], h);
+	}
+
+	for (int i = 0; i < 8; ++i) { _mm512_storeu_si512((void*)state64[i], s[i]); }
+}
+
+#endif//hash_mb_x86
+
+
+// ============================================================================
+//
+//	job manager
+//
+// ============================================================================
+
+/// @brief	algorithm, lanes  ´ kernel  Ѵ. (  nullptr)
+static hash_mb_kernel
+hash_mb_select_kernel(
+	_In_ int algorithm,
+	_In_ uint32_t lanes
+	)
+{
+	const sha2_32t features = sha2_cpu_features();
+	const bool avx2 = (0 != (features & SHA2_CPU_AVX2));
+	const bool avx512 = ((SHA2_CPU_AVX512F | SHA2_CPU_AVX512BW) == (features & (SHA2_CPU_AVX512F | SHA2_CPU_AVX512BW)));
+	UNREFERENCED_PARAMETER(avx2);
+	UNREFERENCED_PARAMETER(avx512);
+
+	switch (algorithm)
+	{
+	case hash_mb_sha256:
+	case hash_mb_md5:
+	{
+		const bool sha256 = (hash_mb_sha256 == algorithm);
+		if (4 == lanes) return (sha256) ? sha256_mb_scalar : md5_mb_scalar;
+#if defined(hash_mb_x86)
+		if (8 == lanes && avx2) return (sha256) ? sha256_mb_avx2 : md5_mb_avx2;
+		if (16 == lanes && avx512) return (sha256) ? sha256_mb_avx512 : md5_mb_avx512;
+#endif
+		break;
+	}
+	case hash_mb_sha384:
+	case hash_mb_sha512:
+#if defined(hash_mb_x86)
+		if (4 == lanes && avx2) return sha512_mb_avx2;
+		if (8 == lanes && avx512) return sha512_mb_avx512;
+#endif
+		if (4 == lanes) return sha512_mb_scalar;
+		break;
+	}
+	return nullptr;
+}
+
+/// @brief
+bool
+hash_mb_init(
+	_Out_ phash_mb_mgr mgr,
+	_In_ int algorithm,
+	_In_ uint32_t lanes
+	)
+{
+	_ASSERTE(nullptr != mgr);
+	_ASSERTE(hash_mb_sha256 <= algorithm && hash_mb_sha512 >= algorithm);
+	if (nullptr == mgr) return false;
+	if (hash_mb_sha256 > algorithm || hash_mb_sha512 < algorithm) return false;
+
+	memset(mgr, 0x00, sizeof(hash_mb_mgr));
+	mgr->algorithm = algorithm;
+	mgr->block_size = (hash_mb_sha384 == algorithm || hash_mb_sha512 == algorithm) ? SHA512_BLOCK_SIZE
+																					: SHA256_BLOCK_SIZE;
+
+	if (hash_mb_lanes_auto == lanes)
+	{
+		//  lane 
+		const uint32_t candidates[] = { 16, 8, 4 };
+		for (auto candidate : candidates)
+		{
+			mgr->kernel = hash_mb_select_kernel(algorithm, candidate);
+			if (nullptr != mgr->kernel) { mgr->lanes = candidate; break; }
+		}
+	}
+	else
+	{
+		mgr->kernel = hash_mb_select_kernel(algorithm, lanes);
+		mgr->lanes = lanes;
+	}
+	return (nullptr != mgr->kernel);
+}
+
+/// @brief	job  lane  ϰ, ʱ state  padding  tail  غѴ.
+static void
+hash_mb_start(
+	_In_ phash_mb_mgr mgr,
+	_In_ uint32_t index,
+	_In_ phash_mb_job job
+	)
+{
+	phash_mb_lane lane = &mgr->lane[index];
+	lane->job = job;
+	lane->data = job->data;
+	lane->blocks = job->len / mgr->block_size;
+
+	//
+	//	 block:  bytes + 0x80 + 0 ... + bit 
+	//	md5  little endian 64 bit, sha256  big endian 64 bit,
+	//	sha384/sha512  big endian 128 bit ( 64 bit  0)
+	//
+	const bool md5 = (hash_mb_md5 == mgr->algorithm);
+	const size_t length_size = (SHA512_BLOCK_SIZE == mgr->block_size) ? 16 : 8;
+	size_t remain = job->len % mgr->block_size;
+	lane->tail_blocks = (remain + 1 + length_size <= mgr->block_size) ? 1 : 2;
+	size_t tail_size = lane->tail_blocks * mgr->block_size;
+
+	memset(lane->tail, 0x00, tail_size);
+	if (0 < remain) memcpy(lane->tail, job->data + (job->len - remain), remain);
+	lane->tail[remain] = 0x80;
+
+	uint64_t bits = (uint64_t)job->len * 8;
+	for (int i = 0; i < 8; ++i)
+	{
+		unsigned char byte = (unsigned char)(bits >> (8 * i));
+		if (true == md5)
+		{
+			lane->tail[tail_size - 8 + i] = byte;
+		}
+		else
+		{
+			lane->tail[tail_size - 1 - i] = byte;
+		}
+	}
+
+	if (0 == lane->blocks)
+	{
+		lane->data = lane->tail;
+		lane->blocks = lane->tail_blocks;
+		lane->in_tail = true;
+	}
+	else
+	{
+		lane->in_tail = false;
+	}
+
+	switch (mgr->algorithm)
+	{
+	case hash_mb_sha256:
+	{
+		sha256_ctx ctx;
+		sha256_begin(&ctx);
+		for (int i = 0; i < 8; ++i) { mgr->state[i][index] = ctx.hash[i]; }
+		break;
+	}
+	case hash_mb_md5:
+		for (int i = 0; i < 4; ++i) { mgr->state[i][index] = _md5_iv[i]; }
+		break;
+	case hash_mb_sha384:
+	case hash_mb_sha512:
+	{
+		sha512_ctx ctx;
+		if (hash_mb_sha384 == mgr->algorithm)
+		{
+			sha384_begin(&ctx);
+		}
+		else
+		{
+			sha512_begin(&ctx);
+		}
+		for (int i = 0; i < 8; ++i) { mgr->state64[i][index] = ctx.hash[i]; }
+		break;
+	}
+	}
+}
+
+/// @brief	lane  ؽø job->digest  , lane  .
+static void
+hash_mb_complete(
+	_In_ phash_mb_mgr mgr,
+	_In_ uint32_t index
+	)
+{
+	phash_mb_lane lane = &mgr->lane[index];
+	phash_mb_job job = lane->job;
+
+	switch (mgr->algorithm)
+	{
+	case hash_mb_sha256:
+		for (int i = 0; i < SHA256_DIGEST_SIZE; ++i)
+		{
+			job->digest[i] = (unsigned char)(mgr->state[i >> 2][index] >> (8 * (3 - (i & 3))));
+		}
+		break;
+	case hash_mb_md5:
+		for (int i = 0; i < MD5_DIGEST_SIZE; ++i)
+		{
+			job->digest[i] = (unsigned char)(mgr->state[i >> 2][index] >> (8 * (i & 3)));
+		}
+		break;
+	case hash_mb_sha384:
+	case hash_mb_sha512:
+	{
+		const int size = (hash_mb_sha384 == mgr->algorithm) ? SHA384_DIGEST_SIZE : SHA512_DIGEST_SIZE;
+		for (int i = 0; i < size; ++i)
+		{
+			job->digest[i] = (unsigned char)(mgr->state64[i >> 3][index] >> (8 * (7 - (i & 7))));
+		}
+		break;
+	}
+	}
+
+	lane->job = nullptr;
+	--mgr->active;
+
+	_ASSERTE(mgr->completed_count < hash_mb_lanes_max);
+	mgr->completed[(mgr->completed_head + mgr->completed_count) % hash_mb_lanes_max] = job;
+	++mgr->completed_count;
+}
+
+/// @brief	job ϳ ̻    lane  ؽѴ.
+static void hash_mb_run(_In_ phash_mb_mgr mgr)
+{
+	while (0 == mgr->completed_count && 0 < mgr->active)
+	{
+		//
+		//	 lane   ó  ִ block ŭ óѴ.
+		//	 lane   lane  data   д´.
+		//
+		const unsigned char* data[hash_mb_lanes_max];
+		const unsigned char* busy_data = nullptr;
+		uint32_t active = 0;
+		size_t blocks = SIZE_MAX;
+		for (uint32_t i = 0; i < mgr->lanes; ++i)
+		{
+			if (nullptr == mgr->lane[i].job) continue;
+			active |= (1 << i);
+			blocks = std::min(blocks, mgr->lane[i].blocks);
+			busy_data = mgr->lane[i].data;
+		}
+		for (uint32_t i = 0; i < mgr->lanes; ++i)
+		{
+			data[i] = (nullptr != mgr->lane[i].job) ? mgr->lane[i].data : busy_data;
+		}
+
+		mgr->kernel(mgr->state, data, active, blocks);
+
+		for (uint32_t i = 0; i < mgr->lanes; ++i)
+		{
+			phash_mb_lane lane = &mgr->lane[i];
+			if (nullptr == lane->job) continue;
+
+			lane->data += blocks * mgr->block_size;
+			lane->blocks -= blocks;
+			if (0 < lane->blocks) continue;
+
+			if (true == lane->in_tail)
+			{
+				hash_mb_complete(mgr, i);
+			}
+			else
+			{
+				lane->data = lane->tail;
+				lane->blocks = lane->tail_blocks;
+				lane->in_tail = true;
+			}
+		}
+	}
+}
+
+/// @brief	 job ϳ .
+static phash_mb_job hash_mb_pop(_In_ phash_mb_mgr mgr)
+{
+	if (0 == mgr->completed_count) return nullptr;
+
+	phash_mb_job job = mgr->completed[mgr->completed_head];
+	mgr->completed_head = (mgr->completed_head + 1) % hash_mb_lanes_max;
+	--mgr->completed_count;
+	return job;
+}
+
+/// @brief
+phash_mb_job
+hash_mb_submit(
+	_In_ phash_mb_mgr mgr,
+	_In_ phash_mb_job job
+	)
+{
+	_ASSERTE(nullptr != mgr);
+	_ASSERTE(nullptr != mgr->kernel);
+	_ASSERTE(nullptr != job);
+	if (nullptr == mgr || nullptr == mgr->kernel || nullptr == job) return nullptr;
+
+	for (uint32_t i = 0; i < mgr->lanes; ++i)
+	{
+		if (nullptr == mgr->lane[i].job)
+		{
+			hash_mb_start(mgr, i, job);
+			++mgr->active;
+			break;
+		}
+	}
+
+	if (mgr->active == mgr->lanes)
+	{
+		hash_mb_run(mgr);
+	}
+	return hash_mb_pop(mgr);
+}
+
+/// @brief
+phash_mb_job hash_mb_flush(_In_ phash_mb_mgr mgr)
+{
+	_ASSERTE(nullptr != mgr);
+	if (nullptr == mgr || nullptr == mgr->kernel) return nullptr;
+
+	hash_mb_run(mgr);
+	return hash_mb_pop(mgr);
+}
+
+/// @brief
+bool
+hash_mb_jobs(
+	_In_ int algorithm,
+	_Inout_updates_(count) phash_mb_job jobs,
+	_In_ size_t count
+	)
+{
+	hash_mb_mgr mgr;
+	if (true != hash_mb_init(&mgr, algorithm)) return false;
+
+	//   job  digest  Ƿ ϰ Ѵ.
+	for (size_t i = 0; i < count; ++i)
+	{
+		hash_mb_submit(&mgr, &jobs[i]);
+	}
+	while (nullptr != hash_mb_flush(&mgr)) {}
+	return true;
+}
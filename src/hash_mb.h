@@ -0,0 +1,122 @@
+/**
+ * @file    hash_mb.h
+ * @brief   multi-buffer sha256 / md5 / sha384 / sha512
+ *
+ *			  ޼ SIMD lane ϳ ϳ ؼ ÿ
+ *			ؽѴ. (AVX-512 16 lane, AVX2 8 lane,    4 lane 
+ *			 ó)
+ *			sha384/sha512  64 bit word  lane  ̴. (AVX-512 8 lane,
+ *			AVX2 4 lane)
+ *
+ *			sha256_compile(), MD5Update()  block    ޼
+ *			ϳδ SIMD lane  ä  Ƿ,    ؽϴ
+ *			쿡 Ѵ.
+ *
+ *			hash_mb_mgr mgr;
+ *			hash_mb_init(&mgr, hash_mb_sha256);
+ *			for (auto& job : jobs)
+ *			{
+ *				//  job   ϵȴ. (   ٸ)
+ *				phash_mb_job done = hash_mb_submit(&mgr, &job);
+ *				if (nullptr != done) { ... done->digest ... }
+ *			}
+ *			for (phash_mb_job done = hash_mb_flush(&mgr);
+ *				 nullptr != done;
+ *				 done = hash_mb_flush(&mgr))
+ *			{
+ *				...
+ *			}
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+
+#ifndef _hash_mb_h_
+#define _hash_mb_h_
+
+#include <cstdint>
+#include "sha2.h"
+
+#define hash_mb_sha256			1
+#define hash_mb_md5				2
+#define hash_mb_sha384			3
+#define hash_mb_sha512			4
+
+/// @brief	lane , hash_mb_lanes_auto  CPU  ϴ   lane 
+#define hash_mb_lanes_auto		0
+#define hash_mb_lanes_max		16
+
+/// @brief	ؽ ޼ ϳ
+///			hash_mb_submit()  hash_mb_submit()  hash_mb_flush() 
+///			  data  job  ȿؾ Ѵ.
+typedef struct hash_mb_job
+{
+	const unsigned char*	data;		///< [in]
+	size_t					len;		///< [in]
+	void*					context;	///< [in] ȣ 
+	unsigned char			digest[SHA512_DIGEST_SIZE];	///< [out] տ md5 16, sha256 32, sha384 48 bytes
+} *phash_mb_job;
+
+/// @brief	lane ϳ  
+typedef struct hash_mb_lane
+{
+	phash_mb_job			job;		///< nullptr ̸  lane
+	const unsigned char*	data;		///<  ó block
+	size_t					blocks;		///< data   block 
+	size_t					tail_blocks;
+	bool					in_tail;	///< data  tail  Ű
+	unsigned char			tail[2 * SHA512_BLOCK_SIZE];	///<  block + padding
+} *phash_mb_lane;
+
+typedef void (*hash_mb_kernel)(uint32_t state[][hash_mb_lanes_max],
+							   const unsigned char* data[hash_mb_lanes_max],
+							   uint32_t active,
+							   size_t blocks);
+
+typedef struct hash_mb_mgr
+{
+	int				algorithm;			///< hash_mb_sha256, hash_mb_md5, ...
+	uint32_t		lanes;
+	size_t			block_size;			///< 64, sha384/sha512  128
+	hash_mb_kernel	kernel;
+
+	uint32_t		active;				///<  lane 
+	union
+	{
+		uint32_t	state[8][hash_mb_lanes_max];		///< [word][lane]
+		uint64_t	state64[8][hash_mb_lanes_max / 2];	///< sha384, sha512
+	};
+	hash_mb_lane	lane[hash_mb_lanes_max];
+
+	phash_mb_job	completed[hash_mb_lanes_max];	///<     job
+	uint32_t		completed_head;
+	uint32_t		completed_count;
+} *phash_mb_mgr;
+
+/// @brief	algorithm, lanes (4, 8, 16, sha384/sha512  4, 8)  mgr  ʱȭѴ.
+///			CPU  lanes    false  Ѵ.
+bool
+hash_mb_init(
+	_Out_ phash_mb_mgr mgr,
+	_In_ int algorithm,
+	_In_ uint32_t lanes = hash_mb_lanes_auto
+	);
+
+/// @brief	job   lane  ִ´.  lane   job ϳ  
+///			ؽϰ,  job  Ѵ. ( nullptr)
+phash_mb_job hash_mb_submit(_In_ phash_mb_mgr mgr, _In_ phash_mb_job job);
+
+/// @brief	ó  job ϳ   ؽϰ  job  Ѵ.
+///			 ̻ job   nullptr  Ѵ.
+phash_mb_job hash_mb_flush(_In_ phash_mb_mgr mgr);
+
+/// @brief	jobs   ؽѴ.
+bool
+hash_mb_jobs(
+	_In_ int algorithm,
+	_Inout_updates_(count) phash_mb_job jobs,
+	_In_ size_t count
+	);
+
+#endif//_hash_mb_h_
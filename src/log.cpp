@@ -15,25 +15,113 @@
 **/
 
 #include "stdafx.h"
+#include <intrin.h>
+#include <algorithm>
 #include "log.h"
+#include "log_format.h"
 
 /**
  * @brief
 **/
 static boost::mutex     _logger_lock;
-static slogger*		    _logger = nullptr;
+static std::atomic<slogger*> _logger(nullptr);
+
 static bool				_show_current_time = false;
 static bool			    _show_process_name = true;
 static bool			    _show_pid_tid = true;
 static bool			    _show_function_name = false;
 
-static uint32_t         _log_mask = log_mask_all;
+uint32_t				_log_mask = log_mask_all;		// log.h  log_enabled()  
 #ifdef _DEBUG
-static uint32_t			_log_level = log_level_debug;
+uint32_t				_log_level = log_level_debug;
 #else
-static uint32_t			_log_level = log_level_info;
+uint32_t				_log_level = log_level_info;
 #endif
 static uint32_t			_log_to = log_to_ods;
+static uint32_t			_log_format_mode = log_format_text;
+static uint32_t			_log_batch_size = _log_batch_size_def;
+static uint32_t			_log_flush_interval = _log_flush_interval_def;
+static uint32_t			_log_sync_policy = log_sync_never;
+static bool				_log_compress_rotated = false;
+
+/// @brief	slogger νϽ ȣ 
+///			( slogger   ּҿ  slogger    Ƿ)
+static std::atomic<uint64_t> _slogger_instance(0);
+
+class thread_log_ring;
+
+/// @brief	α׸   ִ  thread_log_ring  
+///			finalize_log()    slogger  Ȯ  Ѵ.
+static boost::mutex		_thread_rings_lock;
+static std::vector<thread_log_ring*> _thread_rings;
+
+/// @brief	  ring buffer
+///			尡 Ǹ ring buffer  retired  ǥؼ 
+///			logger thread   α׸  ϵ Ѵ.
+///
+///			logger  _logger_lock    slogger ̴. (hazard pointer)
+///			finalize_log()  _logger  nullptr  ٲ ,   
+///			logger   slogger  Ű   ٸ. 
+///			帶  ϹǷ producer  cache line   ʴ´.
+class thread_log_ring
+{
+public:
+	thread_log_ring() : instance(0), logger(nullptr), registered(false) {}
+	~thread_log_ring() 
+	{ 
+		if (true == registered)
+		{
+			boost::lock_guard< boost::mutex > lock(_thread_rings_lock);
+			_thread_rings.erase(std::remove(_thread_rings.begin(), 
+											_thread_rings.end(), 
+											this), 
+								_thread_rings.end());
+		}
+		retire(); 
+	}
+
+	/// @brief	_logger  о logger  ϰ Ѵ. 
+	///			 Ŀ _logger  ٲ ʾҴ Ȯؾ Ѵ. (seq_cst)
+	slogger* enter()
+	{
+		if (true != registered)
+		{
+			boost::lock_guard< boost::mutex > lock(_thread_rings_lock);
+			_thread_rings.push_back(this);
+			registered = true;
+		}
+
+		slogger* current = _logger.load();
+		for (;;)
+		{
+			logger.store(current);
+			slogger* latest = _logger.load();
+			if (latest == current) return current;
+			current = latest;
+		}
+	}
+
+	void leave()
+	{
+		logger.store(nullptr, std::memory_order_release);
+	}
+
+	void retire()
+	{
+		if (ring)
+		{
+			ring->retired = true;
+			ring.reset();
+		}
+		instance = 0;
+	}
+
+	uint64_t instance;
+	std::shared_ptr<log_ring> ring;
+	std::atomic<slogger*> logger;
+	bool registered;
+};
+static thread_local thread_log_ring _thread_ring;
 
 /**
  * @brief	log  ʱȭѴ.
@@ -66,13 +154,18 @@ initialize_log(
 
 	{
 		boost::lock_guard< boost::mutex > lock(_logger_lock);
-		if (NULL != _logger) return true;
+		if (nullptr != _logger.load()) return true;
 
 		slogger* local_slogger = new slogger(log_level, 
 											 log_to, 
 											 log_file_path, 
 											 max_log_count, 
-											 max_log_files);
+											 max_log_files,
+											 log_format_binary == _log_format_mode,
+											 _log_batch_size,
+											 _log_flush_interval,
+											 _log_sync_policy,
+											 _log_compress_rotated);
 		if (NULL == local_slogger)
 		{
 			OutputDebugStringA("[ERR ] initialize_log(), insufficient resource for slogger.\n");
@@ -90,7 +183,7 @@ initialize_log(
 		// exchange instance
 		// 
 
-		_logger = local_slogger;
+		_logger.store(local_slogger);
 		local_slogger = NULL;
 	}
 
@@ -128,9 +221,26 @@ finalize_log(
 )
 {
 	boost::lock_guard< boost::mutex > lock(_logger_lock);
-	if (NULL == _logger) return;
-	_logger->slog_stop();
-	delete _logger;  _logger = NULL;
+	slogger* logger = _logger.exchange(nullptr);
+	if (NULL == logger) return;
+
+	//
+	// ̹ logger  о producer  commit  ĥ  ٸ. 
+	//  producer  nullptr  Ƿ ٷ Ѵ.
+	// 
+	{
+		boost::lock_guard< boost::mutex > users_lock(_thread_rings_lock);
+		for (const thread_log_ring* user : _thread_rings)
+		{
+			while (logger == user->logger.load())
+			{
+				boost::this_thread::yield();
+			}
+		}
+	}
+
+	logger->slog_stop();
+	delete logger;
 }
 
 /**
@@ -172,6 +282,82 @@ get_log_format(
 	show_function_name = _show_function_name;
 }
 
+/// @brief	log  
+void set_log_format_mode(_In_ uint32_t mode)
+{
+	_ASSERTE(log_format_text == mode ||
+			 log_format_deferred == mode ||
+			 log_format_binary == mode ||
+			 log_format_json == mode);
+
+	boost::lock_guard< boost::mutex > lock(_logger_lock);
+	_log_format_mode = mode;
+}
+
+uint32_t get_log_format_mode()
+{
+	return _log_format_mode;
+}
+
+/// @brief	logger 
+bool get_log_stats(_Out_ log_stats& stats)
+{
+	boost::lock_guard< boost::mutex > lock(_logger_lock);
+	slogger* logger = _logger.load();
+	if (NULL == logger) return false;
+
+	stats.queue_depth = logger->queue_depth();
+	stats.dropped = logger->dropped_count();
+	stats.delayed = logger->delayed_count();
+	stats.file_writes = logger->file_write_count();
+	stats.file_syncs = logger->file_sync_count();
+	return true;
+}
+
+/// @brief	  α   
+void set_log_compress_rotated(_In_ bool compress)
+{
+	boost::lock_guard< boost::mutex > lock(_logger_lock);
+	_log_compress_rotated = compress;
+}
+
+bool get_log_compress_rotated()
+{
+	return _log_compress_rotated;
+}
+
+/// @brief	 α group commit 
+void 
+set_log_commit_policy(
+	_In_ uint32_t batch_size, 
+	_In_ uint32_t flush_interval, 
+	_In_ uint32_t sync
+)
+{
+	_ASSERTE(0 < batch_size);
+	_ASSERTE(log_sync_never == sync || 
+			 log_sync_batch == sync || 
+			 log_sync_error == sync);
+
+	boost::lock_guard< boost::mutex > lock(_logger_lock);
+	_log_batch_size = (0 < batch_size) ? batch_size : _log_batch_size_def;
+	_log_flush_interval = flush_interval;
+	_log_sync_policy = sync;
+}
+
+void 
+get_log_commit_policy(
+	_Out_ uint32_t& batch_size, 
+	_Out_ uint32_t& flush_interval, 
+	_Out_ uint32_t& sync
+)
+{
+	boost::lock_guard< boost::mutex > lock(_logger_lock);
+	batch_size = _log_batch_size;
+	flush_interval = _log_flush_interval;
+	sync = _log_sync_policy;
+}
+
 /// @brief	log  
 void
 set_log_env(
@@ -200,9 +386,10 @@ set_log_env(
 		update_logger = true;
 	}
 
-	if (nullptr != _logger && true == update_logger)
+	slogger* logger = _logger.load();
+	if (nullptr != logger && true == update_logger)
 	{
-		_logger->set_log_env(log_level, log_to);
+		logger->set_log_env(log_level, log_to);
 	}
 }
 
@@ -235,9 +422,10 @@ void set_log_level(_In_ uint32_t log_level)
 	{
 		_log_level = log_level;
 
-		if (nullptr != _logger)
+		slogger* logger = _logger.load();
+		if (nullptr != logger)
 		{
-			_logger->set_log_env(log_level, _logger->log_to());
+			logger->set_log_env(log_level, logger->log_to());
 		}
 	}
 }
@@ -256,9 +444,10 @@ void set_log_to(_In_ uint32_t log_to)
 	{
 		_log_to = log_to;
 
-		if (nullptr != _logger)
+		slogger* logger = _logger.load();
+		if (nullptr != logger)
 		{
-			_logger->set_log_env(_logger->log_level(), log_to);
+			logger->set_log_env(logger->log_level(), log_to);
 		}
 	}
 }
@@ -293,96 +482,132 @@ const char* log_to_to_str(_In_ uint32_t log_to)
 }
 
 
-/**
- * @brief
- * @param
- * @see
- * @remarks
- * @code
- * @endcode
- * @return
-**/
-#ifndef _NO_LOG_
-
-void
-log_write_fmt(
-	_In_ uint32_t log_mask,
-	_In_ uint32_t log_level,
-	_In_z_ const char* function,
-	_In_z_ const char* fmt,
-	_In_ ...
-)
+/// @brief	μ ̸ (α׸     ʵ ѹ Ѵ)
+static const std::wstring& current_process_name()
 {
-	// check log mask & level
-	if (log_mask != (_log_mask & log_mask)) return;
-	if (log_level > _log_level) return;
-
-	if (NULL == fmt) return;
+	static const std::wstring process_name = get_current_module_fileEx();
+	return process_name;
+}
 
-	char log_buffer[2048];
-	size_t remain = sizeof(log_buffer);
-	char* pos = log_buffer;
-	va_list args;
+/// @brief	  log decoration (log_deco_xxx)
+static uint32_t decoration_flags()
+{
+	uint32_t flags = log_deco_level;
+	if (true == _show_current_time) flags |= log_deco_time;
+	if (true == _show_process_name) flags |= log_deco_process_name;
+	if (true == _show_pid_tid) flags |= log_deco_pid_tid;
+	if (true == _show_function_name) flags |= log_deco_function_name;
+	return flags;
+}
 
-	if (true == _show_current_time)
-	{
-		StringCbPrintfExA(
-			pos,
-			remain,
-			&pos,
-			&remain,
-			0,
-			"%s ",
-			time_now_to_str(true, false).c_str()
-		);
-	}
+/// @brief	 ð (FILETIME, UTC)
+static uint64_t current_file_time()
+{
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	return file_time_to_int(&now);
+}
 
-	// log level
-	switch (log_level)
-	{
-	case log_level_debug: StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[DEBG] "); break;
-	case log_level_info:  StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[INFO] "); break;
-	case log_level_warn:  StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[WARN] "); break;
-	case log_level_error: StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[EROR] "); break;
-	default:
-		_ASSERTE(!"never reach here!");
-		return;
-	}
+/// @brief	json 忡 ޼     buffer
+static thread_local char _json_message[_max_log_message_size];
 
-	//> show process name
-	if (true == _show_process_name)
+/// @brief	log_format_json  ޼ JSON object  Ѵ.
+///			printf  ޼ ѹ ϰ,   ڵѴ.
+static
+size_t
+format_log_json(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t log_level,
+	_In_opt_z_ const char* function,
+	_In_reads_opt_(field_count) const log_field* fields,
+	_In_ size_t field_count,
+	_In_z_ const char* fmt,
+	_In_ va_list args
+)
+{
+	char* end = _json_message;
+	size_t remain = sizeof(_json_message);
+	HRESULT hRes = StringCbVPrintfExA(_json_message,
+									  sizeof(_json_message),
+									  &end,
+									  &remain,
+									  0,
+									  fmt,
+									  args);
+	if (S_OK != hRes && STRSAFE_E_INSUFFICIENT_BUFFER != hRes)
 	{
-		StringCbPrintfExA(pos,
-						  remain,
-						  &pos,
+		// invalid character  ִ  ߻   
+		StringCbPrintfExA(_json_message,
+						  sizeof(_json_message),
+						  &end,
 						  &remain,
 						  0,
-						  "%ws",
-						  get_current_module_fileEx().c_str()
-		);
+						  "invalid function call parameters");
 	}
 
-	//> show pid, tid
-	if (true == _show_pid_tid)
+	return log_format_json_record(buffer,
+						   size,
+						   log_level,
+						   current_file_time(),
+						   GetCurrentProcessId(),
+						   GetCurrentThreadId(),
+						   current_process_name().c_str(),
+						   function,
+						   _json_message,
+						   (size_t)(end - _json_message),
+						   fields,
+						   field_count);
+}
+
+/// @brief	log_write_fmt(), log_write_fmt_without_deco()  ޼ Ѵ.
+///			buffer    (NULL )  Ѵ.
+static
+size_t
+format_log(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ bool decorate,
+	_In_ uint32_t log_level,
+	_In_opt_z_ const char* function,
+	_In_reads_opt_(field_count) const log_field* fields,
+	_In_ size_t field_count,
+	_In_z_ const char* fmt,
+	_In_ va_list args
+)
+{
+	if (log_format_json == _log_format_mode)
 	{
-		StringCbPrintfExA(pos,
-						  remain,
-						  &pos,
-						  &remain,
-						  0,
-						  "(%+5u:%+5u) : ",
-						  GetCurrentProcessId(),
-						  GetCurrentThreadId()
-		);
+		return format_log_json(buffer, 
+							   size, 
+							   log_level, 
+							   function, 
+							   fields, 
+							   field_count, 
+							   fmt, 
+							   args);
 	}
 
-	//> show function name
-	if (true == _show_function_name)
+	size_t remain = size;
+	char* pos = buffer;
+
+	if (true == decorate)
 	{
-		StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s : ", function);
+		uint32_t flags = decoration_flags();
+		size_t length = log_format_decoration(pos,
+											  remain,
+											  flags,
+											  log_level,
+											  FlagOn(flags, log_deco_time) ? current_file_time() : 0,
+											  GetCurrentProcessId(),
+											  GetCurrentThreadId(),
+											  current_process_name().c_str(),
+											  function);
+		if (0 == length) return 0;
+		pos += length;
+		remain -= length;
 	}
 
-	va_start(args, fmt);
 	HRESULT hRes = StringCbVPrintfExA(pos,
 									  remain,
 									  &pos,
@@ -402,52 +627,184 @@ log_write_fmt(
 						  "invalid function call parameters"
 		);
 	}
-	va_end(args);
+
+	// key/value
+	if (0 < field_count && 1 < remain)
+	{
+		size_t length = log_format_fields(pos, remain, fields, field_count);
+		pos += length;
+		remain -= length;
+	}
 
 	// line feed
 	StringCbPrintfExA(pos, remain, &pos, &remain, 0, "\n");
+	return (size_t)(pos - buffer);
+}
 
-	// Let's write logs.
+/// @brief	logger    (initialize_log() ȣ ) ٷ Ѵ.
+static
+void
+write_log_direct(
+	_In_ uint32_t log_level,
+	_In_z_ const char* log_buffer
+)
+{
+	if (FlagOn(_log_to, log_to_con))
 	{
-		if (NULL != _logger)
+		switch (log_level)
 		{
-			_logger->slog_write(log_level, log_buffer);
+		case log_level_error: // same as log_level_critical
+			write_to_console(fc_red, log_buffer);
+			break;
+		case log_level_info:
+		case log_level_warn:
+			write_to_console(fc_green, log_buffer);
+			break;
+		default:
+			write_to_console(fc_none, log_buffer);
 		}
-		else
+	}
+
+	if (FlagOn(_log_to, log_to_ods))
+	{
+		OutputDebugStringA(log_buffer);
+	}
+}
+
+/// @brief	write_log()  _logger  о   finalize_log()  
+///			slogger   ϵ  thread_log_ring  Ѵ.
+class logger_user
+{
+public:
+	logger_user() : _current(_thread_ring.enter()) {}
+	~logger_user() { _thread_ring.leave(); }
+
+	slogger* current() const { return _current; }
+
+private:
+	slogger* _current;
+};
+
+/// @brief	logger   ̸ ȣ  ring buffer  ٷ 
+///			ϰ, ƴϸ ٷ Ѵ. 
+///			deferrable ̸ fmt, function  ڿ ̹Ƿ deferred, binary 
+///			忡  logger thread  ̷  ִ.
+static
+void
+write_log(
+	_In_ uint32_t log_level,
+	_In_ bool decorate,
+	_In_ bool deferrable,
+	_In_opt_z_ const char* function,
+	_In_reads_opt_(field_count) const log_field* fields,
+	_In_ size_t field_count,
+	_In_z_ const char* fmt,
+	_In_ va_list args
+)
+{
+	logger_user user;
+	slogger* logger = user.current();
+	if (NULL != logger)
+	{
+		plog_record record = logger->slog_reserve(log_level);
+		if (nullptr == record) return;
+
+		//
+		// deferred 忡 ڸ ϰ,  logger thread  Ѵ. 
+		//    ڰ  (%n ) ٷ Ѵ.
+		// key/value ʵ ȣ ޸𸮸 ŰǷ ٷ Ѵ.
+		// 
+		if ((log_format_deferred == _log_format_mode || 
+			 log_format_binary == _log_format_mode) &&
+			true == deferrable &&
+			0 == field_count)
 		{
-			if (FlagOn(_log_to, log_to_con))
-			{
-				switch (log_level)
-				{
-				case log_level_error: // same as log_level_critical
-					write_to_console(fc_red, log_buffer);
-					break;
-				case log_level_info:
-				case log_level_warn:
-					write_to_console(fc_green, log_buffer);
-					break;
-				default:
-					write_to_console(fc_none, log_buffer);
-				}
-			}
+			va_list args_copy;
+			va_copy(args_copy, args);
+			uint32_t length = 0;
+			bool packed = log_pack_args(record->msg, sizeof(record->msg), fmt, args_copy, length);
+			va_end(args_copy);
 
-			if (FlagOn(_log_to, log_to_ods))
+			if (true == packed)
 			{
-				OutputDebugStringA(log_buffer);
+				record->flags = log_record_deferred | ((true == decorate) ? decoration_flags() : 0);
+				record->length = length;
+				record->tid = GetCurrentThreadId();
+				record->time = current_file_time();
+				record->fmt = fmt;
+				record->function = function;
+				logger->slog_commit(record);
+				return;
 			}
 		}
+
+		record->length = (uint32_t)format_log(record->msg,
+											  sizeof(record->msg),
+											  decorate,
+											  log_level,
+											  function,
+											  fields,
+											  field_count,
+											  fmt,
+											  args);
+		logger->slog_commit(record);
+	}
+	else
+	{
+		char log_buffer[_max_log_message_size];
+		if (0 < format_log(log_buffer,
+						   sizeof(log_buffer),
+						   decorate,
+						   log_level,
+						   function,
+						   fields,
+						   field_count,
+						   fmt,
+						   args))
+		{
+			write_log_direct(log_level, log_buffer);
+		}
 	}
 }
-#endif// _NO_LOG_
 
+/**
+ * @brief
+ * @param
+ * @see
+ * @remarks
+ * @code
+ * @endcode
+ * @return
+**/
+#ifndef _NO_LOG_
 
+void
+log_write_fmt(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* function,
+	_In_z_ const char* fmt,
+	_In_ ...
+)
+{
+	// check log mask & level
+	if (log_mask != (_log_mask & log_mask)) return;
+	if (log_level > _log_level) return;
 
+	if (NULL == fmt) return;
 
-/// @brief  Writes log without decoration
+	va_list args;
+	va_start(args, fmt);
+	write_log(log_level, true, false, function, nullptr, 0, fmt, args);
+	va_end(args);
+}
+
+/// @brief	log_xxx ũο, fmt  function  ڿ  Ѵ.
 void
-log_write_fmt_without_deco(
+log_write_fmt_static(
 	_In_ uint32_t log_mask,
 	_In_ uint32_t log_level,
+	_In_z_ const char* function,
 	_In_z_ const char* fmt,
 	_In_ ...
 )
@@ -458,73 +815,215 @@ log_write_fmt_without_deco(
 
 	if (NULL == fmt) return;
 
-	char log_buffer[2048];
-	size_t remain = sizeof(log_buffer);
-	char* pos = log_buffer;
 	va_list args;
-
 	va_start(args, fmt);
-	HRESULT hRes = StringCbVPrintfExA(pos,
-									  remain,
-									  &pos,
-									  &remain,
-									  0,
-									  fmt,
-									  args
-	);
-
-	if (S_OK != hRes)
-	{
-		// invalid character  ִ  ߻   
-		StringCbPrintfExA(pos,
-						  remain,
-						  &pos,
-						  &remain,
-						  0,
-						  "invalid function call parameters"
-		);
-	}
+	write_log(log_level, true, true, function, nullptr, 0, fmt, args);
 	va_end(args);
+}
+#endif// _NO_LOG_
 
-	// line feed
-	StringCbPrintfExA(pos, remain, &pos, &remain, 0, "\n");
 
-	// Let's write logs.
-	{
-		boost::lock_guard< boost::mutex > lock(_logger_lock);
 
-		if (NULL != _logger)
-		{
-			_logger->slog_write(log_level, log_buffer);
-		}
-		else
-		{
-			if (FlagOn(_log_to, log_to_con))
-			{
-				switch (log_level)
-				{
-				case log_level_error: // same as log_level_critical
-					write_to_console(fc_red, log_buffer);
-					break;
-				case log_level_info:
-				case log_level_warn:
-					write_to_console(fc_green, log_buffer);
-					break;
-				default:
-					write_to_console(fc_none, log_buffer);
-				}
-			}
 
-			if (FlagOn(_log_to, log_to_ods))
-			{
-				OutputDebugStringA(log_buffer);
-			}
-		}
-	}
+/// @brief  Writes log without decoration
+void
+log_write_fmt_without_deco(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* fmt,
+	_In_ ...
+)
+{
+	// check log mask & level
+	if (log_mask != (_log_mask & log_mask)) return;
+	if (log_level > _log_level) return;
+
+	if (NULL == fmt) return;
 
+	va_list args;
+	va_start(args, fmt);
+	write_log(log_level, false, false, NULL, nullptr, 0, fmt, args);
+	va_end(args);
 }
 
-/*****************************************************************************/
+/// @brief	log_msg ũο, fmt  ڿ  Ѵ.
+void
+log_write_fmt_without_deco_static(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* fmt,
+	_In_ ...
+)
+{
+	// check log mask & level
+	if (log_mask != (_log_mask & log_mask)) return;
+	if (log_level > _log_level) return;
+
+	if (NULL == fmt) return;
+
+	va_list args;
+	va_start(args, fmt);
+	write_log(log_level, false, true, NULL, nullptr, 0, fmt, args);
+	va_end(args);
+}
+
+/// @brief	key/value ʵ带  α
+void
+log_write_kv(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* function,
+	_In_reads_(field_count) const log_field* fields,
+	_In_ size_t field_count,
+	_In_z_ const char* fmt,
+	_In_ ...
+)
+{
+	// check log mask & level
+	if (log_mask != (_log_mask & log_mask)) return;
+	if (log_level > _log_level) return;
+
+	if (NULL == fmt) return;
+
+	va_list args;
+	va_start(args, fmt);
+	write_log(log_level, true, false, function, fields, field_count, fmt, args);
+	va_end(args);
+}
+
+/// @brief	log_xxx_ratelimited   α  Ѵ. 
+void
+log_write_suppressed(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* function,
+	_In_ uint32_t suppressed
+	)
+{
+	log_write_fmt_static(log_mask, 
+						 log_level, 
+						 function, 
+						 "%u messages suppressed by rate limit", 
+						 suppressed);
+}
+
+std::atomic<log_rate_limiter*> log_rate_limiter::_sites(nullptr);
+
+/// @brief	fetch_add   (state)  interval  now  ٸ  
+///			 ü 尡  interval   α  Ѵ. 
+///
+///			 interval  ȣ Ƚ 迡 ÿ  interval   
+///			 ȣ⵵ ԵǹǷ  α   ŭ   ִ.
+bool 
+log_rate_limiter::next_interval(
+	_In_ uint32_t now, 
+	_In_ uint64_t state, 
+	_In_ uint32_t log_mask, 
+	_In_ uint32_t log_level, 
+	_In_z_ const char* function
+	)
+{
+	// now   Ŀ ٸ 尡  interval  üߴ.
+	if (0 < (int32_t)((uint32_t)(state >> 32) - now))
+	{
+		return ((uint32_t)state < _burst);
+	}
+
+	uint64_t expected = state + 1;
+	uint64_t next = ((uint64_t)now << 32) | 1;
+	while (0 > (int32_t)((uint32_t)(expected >> 32) - now))
+	{
+		if (true == _state.compare_exchange_weak(expected, next, std::memory_order_relaxed))
+		{
+			// ڽ ȣ  interval  .
+			uint32_t count = (uint32_t)expected;
+			if ((expected >> 32) == (state >> 32)) --count;
+
+			if (count > _burst)
+			{
+				log_write_suppressed(log_mask, log_level, function, count - _burst);
+			}
+			return true;
+		}
+	}
+
+	// ٸ 尡 ü
+	return allow(log_mask, log_level, function);
+}
+
+/// @brief	flush_sites() Ͽ Ѵ. 
+void 
+log_rate_limiter::register_site(
+	_In_ uint32_t log_mask, 
+	_In_ uint32_t log_level, 
+	_In_z_ const char* function
+	)
+{
+	if (true == _registered.load(std::memory_order_relaxed) ||
+		true == _registered.exchange(true, std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	_log_mask = log_mask;
+	_log_level = log_level;
+	_function = function;
+
+	log_rate_limiter* head = _sites.load(std::memory_order_relaxed);
+	do
+	{
+		_next = head;
+	} while (true != _sites.compare_exchange_weak(head, 
+												  this, 
+												  std::memory_order_release, 
+												  std::memory_order_relaxed));
+}
+
+/// @brief	interval    α  ϰ, 
+///			  Ѵ. 
+///			 interval  ȣ Ƚ 0  Ѵ.
+uint32_t 
+log_rate_limiter::flush_suppressed(
+	_In_ uint32_t log_mask, 
+	_In_ uint32_t log_level, 
+	_In_z_ const char* function
+	)
+{
+	uint32_t now = (uint32_t)(GetTickCount64() / _interval);
+	uint64_t state = _state.load(std::memory_order_relaxed);
+	while (0 > (int32_t)((uint32_t)(state >> 32) - now))
+	{
+		uint32_t count = (uint32_t)state;
+		if (count <= _burst) return 0;
+
+		if (true == _state.compare_exchange_weak(state, 
+												 (uint64_t)now << 32, 
+												 std::memory_order_relaxed))
+		{
+			log_write_suppressed(log_mask, log_level, function, count - _burst);
+			return count - _burst;
+		}
+	}
+	return 0;
+}
+
+/// @brief	ϵ  limiter   α  ϰ, 
+///			   Ѵ. 
+uint32_t log_rate_limiter::flush_sites()
+{
+	uint32_t suppressed = 0;
+	for (log_rate_limiter* site = _sites.load(std::memory_order_acquire); 
+		 nullptr != site; 
+		 site = site->_next)
+	{
+		suppressed += site->flush_suppressed(site->_log_mask, 
+											 site->_log_level, 
+											 site->_function);
+	}
+	return suppressed;
+}
+
+/*****************************************************************************/
 /*					slogger class implementation							 */
 /*****************************************************************************/
 
@@ -535,13 +1034,41 @@ slogger::slogger(_In_ uint32_t log_level,
 				 _In_ uint32_t log_to,
 				 _In_opt_z_ const wchar_t* log_file_path,
 				 _In_ uint32_t max_log_count,
-				 _In_ uint32_t max_log_files) :
+				 _In_ uint32_t max_log_files,
+				 _In_ bool binary_file,
+				 _In_ uint32_t batch_size,
+				 _In_ uint32_t flush_interval,
+				 _In_ uint32_t sync_policy,
+				 _In_ bool compress_rotated) :
 	_stop_logger(true),
 	_log_level(log_level),
 	_log_to(log_to),
 	_max_log_count(max_log_count),
 	_max_log_files(max_log_files),
+	_instance(++_slogger_instance),
+	_rings_version(0),
+	_dropped(0),
+	_delayed(0),
+	_consumer_idle(false),
+	_wakeup(false),
+	_drain_version(0),
+	_batch_size(((size_t)batch_size + _log_batch_align - 1) & ~((size_t)_log_batch_align - 1)),
+	_flush_interval(flush_interval),
+	_sync_policy(sync_policy),
+	_batch(nullptr, &_aligned_free),
+	_batch_length(0),
+	_batch_tick(0),
+	_batch_error(false),
+	_file_writes(0),
+	_file_syncs(0),
+	_binary_file(binary_file),
+	_file_header_pending(false),
 	_logger_thread(NULL),
+	_compress_rotated(compress_rotated),
+	_maintenance_thread(NULL),
+	_stop_maintenance(false),
+	_next_log_file_handle(INVALID_HANDLE_VALUE),
+	_next_log_file_wanted(false),
 	_log_count(0),
 	_log_file_path(nullptr != log_file_path ? log_file_path : L""),	
 	_log_file_handle(INVALID_HANDLE_VALUE)
@@ -570,6 +1097,14 @@ bool slogger::slog_start()
 		return false;
 	}
 
+	_batch.reset((char*)_aligned_malloc(_batch_size, _log_batch_align));
+	_batch_length = 0;
+	if (nullptr == _batch)
+	{
+		OutputDebugStringA("[ERR ] slog_start(), insufficient resource for batch buffer.\n");
+		return false;
+	}
+
 	if (FlagOn(_log_to, log_to_file) && !_log_file_path.empty())
 	{
 		//
@@ -602,9 +1137,12 @@ bool slogger::slog_start()
 		_ASSERTE(INVALID_HANDLE_VALUE != _log_file_handle);
 
 		//
-		//  α  ִٸ Ѵ. 
+		//  α  ,  α  غ maintenance thread  Ѵ.
 		//
-		remove_old_log_files();
+		_next_log_file_path = _log_file_path + L".next";
+		_next_log_file_wanted = true;
+		_stop_maintenance = false;
+		_maintenance_thread = new boost::thread(boost::bind(&slogger::slog_maintenance_thread, this));
 	}
 	
 	_stop_logger = false;
@@ -621,6 +1159,7 @@ void slogger::slog_stop()
 	if (true == _stop_logger) return;
 
 	_stop_logger = true;
+	wakeup_consumer();
 
 	if (NULL != _logger_thread)
 	{
@@ -635,13 +1174,26 @@ void slogger::slog_stop()
 		_log_file_handle = INVALID_HANDLE_VALUE;
 	}
 
-	_ASSERTE(true == _log_queue.empty());
+	//
+	// maintenance thread   ۾ ġ Ѵ.
+	// 
+	if (NULL != _maintenance_thread)
+	{
+		{
+			boost::lock_guard< boost::mutex > lock(_maintenance_lock);
+			_stop_maintenance = true;
+		}
+		_maintenance_cond.notify_one();
+		_maintenance_thread->join();
+		delete _maintenance_thread; _maintenance_thread = NULL;
+	}
+
 	_ASSERTE(INVALID_HANDLE_VALUE == _log_file_handle);
 	_ASSERTE(nullptr == _logger_thread);
 }
 
 /**
- * @brief	log ť α׸ push Ѵ.
+ * @brief	log  ring buffer  push Ѵ.
 */
 void
 slogger::slog_write(
@@ -652,14 +1204,133 @@ slogger::slog_write(
 	_ASSERTE(NULL != log_message);
 	if (NULL == log_message) return;
 
+	plog_record record = slog_reserve(level);
+	if (nullptr == record) return;
+
+	size_t length = strlen(log_message);
+	if (length >= sizeof(record->msg))
+	{
+		length = sizeof(record->msg) - 1;
+	}
+	memcpy(record->msg, log_message, length);
+	record->msg[length] = '\0';
+	record->length = (uint32_t)length;
+
+	slog_commit(record);
+}
+
+/**
+ * @brief	ȣ  ring buffer  record  ϳ ҴѴ.
+*/
+plog_record slogger::slog_reserve(_In_ uint32_t level)
+{
 	// check log level
-	if (level > log_level()) return;
+	if (level > log_level()) return nullptr;
+
+	if (true == _stop_logger)
+	{
+		++_dropped;
+		return nullptr;
+	}
+
+	log_ring* ring = producer_ring();
+	void* slot = ring->records.try_reserve();
+	if (nullptr == slot) ++_delayed;
+	while (nullptr == slot)
+	{
+		//
+		// ring buffer     logger thread    
+		// ٸ. (α׸  ʴ´)
+		// 
+		if (true == _stop_logger)
+		{
+			++_dropped;
+			return nullptr;
+		}
+
+		if (true == _consumer_idle.load()) { wakeup_consumer(); }
+		boost::this_thread::yield();
+		slot = ring->records.try_reserve();
+	}
+
+	plog_record record = new (slot) log_record;
+	record->stamp = __rdtsc();
+	record->level = level;
+	record->length = 0;
+	record->flags = 0;
+	return record;
+}
+
+/**
+ * @brief	 ring buffer  ׿ִ α  
+ *			(logger thread    α )
+*/
+size_t slogger::queue_depth()
+{
+	boost::lock_guard< boost::mutex > lock(_rings_lock);
+	size_t depth = 0;
+	for (const auto& ring : _rings)
+	{
+		depth += ring->records.size();
+	}
+	return depth;
+}
+
+/**
+ * @brief	slog_reserve()  Ҵ record  logger thread  ѱ.
+*/
+void slogger::slog_commit(_In_ plog_record record)
+{
+	_ASSERTE(nullptr != record);
+	UNREFERENCED_PARAMETER(record);
+
+	producer_ring()->records.commit_push();
+
+	//
+	// logger thread   ִ 쿡 . 
+	// fence   logger thread    push  α׸ 
+	// ĥ  ִ. (slog_thread() )
+	// 
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (true == _consumer_idle.load(std::memory_order_relaxed))
+	{
+		wakeup_consumer();
+	}
+}
 
-	// enqueue log
-	plog_entry le = new log_entry(level, log_message);
+/// @brief	ȣ  ring buffer  Ѵ. 
+///			忡 ó α׸   ring buffer  ؼ Ѵ.
+log_ring* slogger::producer_ring()
+{
+	if (_thread_ring.instance == _instance)
+	{
+		return _thread_ring.ring.get();
+	}
+
+	//
+	//  logger  ring buffer   ִ  
+	//  logger    ֵ retired  ǥѴ. 
+	// 
+	_thread_ring.retire();
+
+	std::shared_ptr<log_ring> ring = std::make_shared<log_ring>(_log_ring_size_def);
+	{
+		boost::lock_guard< boost::mutex > lock(_rings_lock);
+		_rings.push_back(ring);
+		++_rings_version;
+	}
+
+	_thread_ring.instance = _instance;
+	_thread_ring.ring = ring;
+	return ring.get();
+}
 
-	boost::lock_guard< boost::mutex > lock(_lock);
-	_log_queue.push(le);
+/// @brief	 ִ logger thread  .
+void slogger::wakeup_consumer()
+{
+	boost::lock_guard< boost::mutex > lock(_wakeup_lock);
+	_wakeup = true;
+	_wakeup_cond.notify_one();
 }
 
 /// @brief	
@@ -674,18 +1345,22 @@ bool slogger::rotate_log_file(_In_ const wchar_t* log_file_path)
 		std::wstring ext;
 		get_file_extensionw(log_file_path, ext);
 
+		//
+		// ϰ  1 ʿ     Ƿ msec  δ.
+		// 
 		wchar_t buf[128];
 		SYSTEMTIME time; GetLocalTime(&time);
 		_ASSERTE(true != ext.empty());		
 		if (!SUCCEEDED(StringCbPrintfW(buf,
 										sizeof(buf),
-										L"%04u-%02u-%02u_%02u-%02u-%02u.%s",
+										L"%04u-%02u-%02u_%02u-%02u-%02u_%03u.%s",
 										time.wYear,
 										time.wMonth,
 										time.wDay,
 										time.wHour,
 										time.wMinute,
 										time.wSecond,
+										time.wMilliseconds,
 										ext.c_str())))
 		{
 			_ASSERTE(!"oops! need more buffer");
@@ -694,12 +1369,44 @@ bool slogger::rotate_log_file(_In_ const wchar_t* log_file_path)
 		
 		if (INVALID_HANDLE_VALUE != _log_file_handle)
 		{
-			write_to_filea(_log_file_handle, "> log rotated -> %s", WcsToMbsEx(buf).c_str());
-
-			CloseHandle(_log_file_handle);
-			_log_file_handle = INVALID_HANDLE_VALUE;
+			if (true == _binary_file)
+			{
+				std::string msg = "> log rotated -> " + WcsToMbsEx(buf);
+				log_bin_text text = { log_bin_type_text, log_level_info, (uint32_t)msg.size() };
+				append_batch(&text, sizeof(text));
+				append_batch(msg.c_str(), msg.size());
+				flush_batch();
+			}
+			else if (log_format_json == _log_format_mode)
+			{
+				// α    JSON object  ǵ Ѵ.
+				std::string msg = "> log rotated -> " + WcsToMbsEx(buf);
+				char line[512];
+				if (0 < log_format_json_record(line,
+										sizeof(line),
+										log_level_info,
+										current_file_time(),
+										GetCurrentProcessId(),
+										GetCurrentThreadId(),
+										current_process_name().c_str(),
+										nullptr,
+										msg.c_str(),
+										msg.size(),
+										nullptr,
+										0))
+				{
+					write_to_filea(_log_file_handle, "%s", line);
+				}
+			}
+			else
+			{
+				write_to_filea(_log_file_handle, "> log rotated -> %s", WcsToMbsEx(buf).c_str());
+			}
 		}
 
+		//
+		// α  FILE_SHARE_DELETE  Ƿ  ʰ ̸ ٲ  ִ.
+		// 
 		std::wstringstream path;
 		path << extract_last_tokenExW(log_file_path, L".", true) << L"." << buf;
 		if (!MoveFileW(log_file_path, path.str().c_str()))
@@ -708,14 +1415,11 @@ bool slogger::rotate_log_file(_In_ const wchar_t* log_file_path)
 		}
 
 		//
-		// Ʈ   Ͽ ߰Ѵ.
-		// _log_files Ʈ     Ƿ
-		//   ϴ  (enum_old_log_files()Լ)  
-		// file  ctime  Ȯ  ʿ. 
+		//  α  ݰ, ϰ, _log_files  ߰ϴ ۾ 
+		// maintenance thread  Ѵ. 
 		// 
-		FILETIME now; GetSystemTimeAsFileTime(&now);		
-		log_file_and_ctime fc(path.str().c_str(), now);
-		_log_files.push_back(fc);
+		queue_rotated_log_file(_log_file_handle, path.str().c_str());
+		_log_file_handle = INVALID_HANDLE_VALUE;
 	}
 
 	
@@ -725,20 +1429,30 @@ bool slogger::rotate_log_file(_In_ const wchar_t* log_file_path)
 		return false;
 	}
 
+	//
+	// ̸   α   ̸ ٲ㼭 ϰ, 
+	//  (maintenance thread     )  .
+	// 
 	_ASSERTE(INVALID_HANDLE_VALUE == _log_file_handle);
-	_log_file_handle = CreateFileW(log_file_path,
-								   GENERIC_ALL,
-								   FILE_SHARE_WRITE | FILE_SHARE_READ | FILE_SHARE_DELETE,
-								   NULL,
-								   CREATE_NEW,
-								   FILE_ATTRIBUTE_NORMAL,
-								   NULL);
+	_log_file_handle = take_next_log_file(log_file_path);
 	if (INVALID_HANDLE_VALUE == _log_file_handle)
 	{
-		return false;
+		_log_file_handle = CreateFileW(log_file_path,
+									   GENERIC_ALL,
+									   FILE_SHARE_WRITE | FILE_SHARE_READ | FILE_SHARE_DELETE,
+									   NULL,
+									   CREATE_NEW,
+									   FILE_ATTRIBUTE_NORMAL,
+									   NULL);
+		if (INVALID_HANDLE_VALUE == _log_file_handle)
+		{
+			return false;
+		}
 	}
 
 	_log_count = 0;	///<!
+	_file_header_pending = _binary_file;
+	_bin_strings.clear();
 	return true;
 }
 
@@ -822,6 +1536,203 @@ bool slogger::enum_old_log_files()
 	return true;
 }
 
+/// @brief	  α  maintenance thread  ѱ. 
+void 
+slogger::queue_rotated_log_file(
+	_In_ HANDLE handle, 
+	_In_opt_z_ const wchar_t* path
+)
+{
+	rotated_log_file rotated;
+	rotated.handle = handle;
+	if (nullptr != path) rotated.path = path;
+
+	if (NULL == _maintenance_thread)
+	{
+		//
+		// slog_start()   ϴ  (maintenance thread  )
+		// 
+		if (INVALID_HANDLE_VALUE != handle) CloseHandle(handle);
+		if (true != rotated.path.empty())
+		{
+			FILETIME now; GetSystemTimeAsFileTime(&now);
+			_log_files.push_back(log_file_and_ctime(rotated.path.c_str(), now));
+			if (true == _compress_rotated) compress_log_file(rotated.path.c_str());
+		}
+		return;
+	}
+
+	{
+		boost::lock_guard< boost::mutex > lock(_maintenance_lock);
+		_rotated_files.push_back(rotated);
+	}
+	_maintenance_cond.notify_one();
+}
+
+/// @brief	maintenance thread  ̸   α  ̸ 
+///			log_file_path  ٲٰ, handle  Ѵ. 
+///			ų ̸ ٲ ϸ INVALID_HANDLE_VALUE  Ѵ.
+HANDLE slogger::take_next_log_file(_In_z_ const wchar_t* log_file_path)
+{
+	HANDLE next_file = INVALID_HANDLE_VALUE;
+	{
+		//
+		// ̸ ٲ Ŀ maintenance thread    鵵 
+		// lock  ä ̸ ٲ۴. 
+		// 
+		boost::lock_guard< boost::mutex > lock(_maintenance_lock);
+		next_file = _next_log_file_handle;
+		_next_log_file_handle = INVALID_HANDLE_VALUE;
+		_next_log_file_wanted = true;
+
+		if (INVALID_HANDLE_VALUE != next_file && 
+			TRUE != MoveFileW(_next_log_file_path.c_str(), log_file_path))
+		{
+			CloseHandle(next_file);
+			next_file = INVALID_HANDLE_VALUE;
+		}
+	}
+	_maintenance_cond.notify_one();
+	return next_file;
+}
+
+/// @brief	  α  NTFS Ѵ. 
+void slogger::compress_log_file(_In_z_ const wchar_t* path)
+{
+	handle_ptr file(CreateFileW(path,
+								GENERIC_READ | GENERIC_WRITE,
+								FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+								NULL,
+								OPEN_EXISTING,
+								FILE_ATTRIBUTE_NORMAL,
+								NULL),
+					[](HANDLE file_handle) {
+		if (INVALID_HANDLE_VALUE != file_handle)
+		{
+			CloseHandle(file_handle);
+		}
+	});
+	if (INVALID_HANDLE_VALUE == file.get()) return;
+
+	USHORT format = COMPRESSION_FORMAT_DEFAULT;
+	DWORD bytes_returned = 0;
+	if (TRUE != DeviceIoControl(file.get(),
+								FSCTL_SET_COMPRESSION,
+								&format,
+								sizeof(format),
+								NULL,
+								0,
+								&bytes_returned,
+								NULL))
+	{
+		// FAT    ʴ  ý
+		OutputDebugStringA("[ERR ] compress_log_file(), FSCTL_SET_COMPRESSION failed.\n");
+	}
+}
+
+///	@brief	log maintenance thread 
+///			 α  ݱ, ,  α  ,  α  
+///			⸦ logger thread  Ѵ. 
+void slogger::slog_maintenance_thread()
+{
+	// CPU, I/O 켱  .
+	SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+	remove_old_log_files();
+
+	uint64_t flush_tick = GetTickCount64();
+	boost::unique_lock< boost::mutex > lock(_maintenance_lock);
+	for (;;)
+	{
+		//
+		//  α  ̸  д. 
+		// (logger thread   쿡, ص ٽ õ ʴ´)
+		// 
+		if (true == _next_log_file_wanted && true != _stop_maintenance)
+		{
+			_next_log_file_wanted = false;
+			lock.unlock();
+			HANDLE next_file = CreateFileW(_next_log_file_path.c_str(),
+										   GENERIC_ALL,
+										   FILE_SHARE_WRITE | FILE_SHARE_READ | FILE_SHARE_DELETE,
+										   NULL,
+										   CREATE_ALWAYS,
+										   FILE_ATTRIBUTE_NORMAL,
+										   NULL);
+			lock.lock();
+			_ASSERTE(INVALID_HANDLE_VALUE == _next_log_file_handle);
+			_next_log_file_handle = next_file;
+			continue;
+		}
+
+		if (true == _rotated_files.empty())
+		{
+			if (true == _stop_maintenance) break;
+
+			//
+			//  αװ  µ   α  
+			// rate limit interval  Ѵ. (log_xxx_ratelimited)
+			// 
+			uint64_t elapsed = GetTickCount64() - flush_tick;
+			if (elapsed >= _log_ratelimit_interval_def)
+			{
+				flush_tick = GetTickCount64();
+				lock.unlock();
+				log_rate_limiter::flush_sites();
+				lock.lock();
+				continue;
+			}
+
+			_maintenance_cond.wait_for(lock, 
+									   boost::chrono::milliseconds(_log_ratelimit_interval_def - elapsed));
+			continue;
+		}
+
+		rotated_log_file rotated = _rotated_files.front();
+		_rotated_files.pop_front();
+		lock.unlock();
+
+		if (INVALID_HANDLE_VALUE != rotated.handle)
+		{
+			CloseHandle(rotated.handle);
+		}
+
+		if (true != rotated.path.empty())
+		{
+			if (true == _compress_rotated)
+			{
+				compress_log_file(rotated.path.c_str());
+			}
+
+			//
+			// Ʈ   Ͽ ߰Ѵ.
+			// _log_files Ʈ     Ƿ
+			//   ϴ  (enum_old_log_files()Լ)  
+			// file  ctime  Ȯ  ʿ. 
+			// 
+			FILETIME now; GetSystemTimeAsFileTime(&now);
+			log_file_and_ctime fc(rotated.path.c_str(), now);
+			_log_files.push_back(fc);
+
+			//
+			//  α  ִٸ Ѵ.
+			//
+			remove_old_log_files();
+		}
+		lock.lock();
+	}
+
+	//
+	//    α  Ѵ.
+	// 
+	if (INVALID_HANDLE_VALUE != _next_log_file_handle)
+	{
+		CloseHandle(_next_log_file_handle);
+		_next_log_file_handle = INVALID_HANDLE_VALUE;
+		DeleteFileW(_next_log_file_path.c_str());
+	}
+}
+
 /// @brief	log          αϺ Ѵ.
 void slogger::remove_old_log_files()
 {
@@ -836,176 +1747,408 @@ void slogger::remove_old_log_files()
 }
 
 ///	@brief	logger worker thread
-///			pops log entry from log queue and writes log to output
+///			ring buffer  αװ ִ   ϰ, 
+///			αװ  producer    .
 void slogger::slog_thread()
 {
 	while (true != _stop_logger)
 	{
-		if (true == _log_queue.empty())
+		if (0 < drain_rings()) continue;
+
+		//
+		// idle  ǥ  ѹ  Ȯؾ Ѵ. 
+		// producer  α׸ push   idle  Ȯϰ (slog_commit()), 
+		// logger thread  idle ǥ  α׸ ȮϹǷ 
+		//   ϳ ݵ   ȴ. 
+		// 
+		_consumer_idle = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (0 < drain_rings())
 		{
-			Sleep(100);
+			_consumer_idle = false;
 			continue;
 		}
 
-		plog_entry log = NULL;
+		//
+		// Ͽ   αװ  flush_interval    . 
+		// 
+		uint32_t flush_wait = batch_flush_due();
+		if (0 < _batch_length && 0 == flush_wait)
 		{
-			boost::lock_guard< boost::mutex > lock(_lock);
-			log = _log_queue.pop();
+			flush_batch();
 		}
-		
-		if (FlagOn(_log_to, log_to_con))
+
 		{
-			switch (log->_log_level)
+			boost::unique_lock< boost::mutex > lock(_wakeup_lock);
+			while (true != _wakeup)
 			{
-			case log_level_error: // same as log_level_critical
-				write_to_console(fc_red, log->_msg.c_str());
-				break;
-			case log_level_info:
-			case log_level_warn:
-				write_to_console(fc_green, log->_msg.c_str());
-				break;
-			default:
-				write_to_console(fc_none, log->_msg.c_str());
+				if (0 == _batch_length)
+				{
+					_wakeup_cond.wait(lock);
+				}
+				else if (boost::cv_status::timeout == 
+						 _wakeup_cond.wait_for(lock, boost::chrono::milliseconds(flush_wait)))
+				{
+					break;
+				}
 			}
+			_wakeup = false;
 		}
+		_consumer_idle = false;
+	}
+
+	// flush all logs to target media.
+	while (0 < drain_rings());
+	flush_batch();
+}
+
+/// @brief	 ring buffer  α׸ stamp  Ѵ. 
+///			 α  Ѵ.
+size_t slogger::drain_rings()
+{
+	//
+	// ring buffer   쿡 lock    ٽ ´.
+	//
+	if (_drain_version != _rings_version.load())
+	{
+		boost::lock_guard< boost::mutex > lock(_rings_lock);
+		_drain_version = _rings_version;
+		_drain_rings = _rings;
+		_drain_cursors.assign(_drain_rings.size(), 0);
+	}
+
+	//
+	//  ring buffer   տ ִ α׵ stamp  min heap   
+	//   ͺ Ѵ. (k-way merge)
+	// write_record()  record  batch buffer  ϹǷ  record  
+	// _log_ring_release_chunk   ٷ ȯؼ producer  ٸ ʰ Ѵ. 
+	// ȯϴ  producer   ä  Ƿ ѹ ϴ α 
+	//  ring buffer ũ  Ѵ. 
+	// 
+	const auto later = [](const std::pair<uint64_t, size_t>& lhs, 
+						  const std::pair<uint64_t, size_t>& rhs) {
+		return lhs > rhs;
+	};
+
+	_drain_heap.clear();
+	for (size_t i = 0; i < _drain_rings.size(); ++i)
+	{
+		plog_record record = _drain_rings[i]->records.peek(0);
+		if (nullptr != record) _drain_heap.emplace_back(record->stamp, i);
+	}
+	std::make_heap(_drain_heap.begin(), _drain_heap.end(), later);
+
+	const size_t max_count = _drain_rings.size() * _log_ring_size_def;
+	size_t count = 0;
+	while (true != _drain_heap.empty() && count < max_count)
+	{
+		std::pop_heap(_drain_heap.begin(), _drain_heap.end(), later);
+		size_t index = _drain_heap.back().second;
+		_drain_heap.pop_back();
+
+		log_ring& ring = *_drain_rings[index];
+		write_record(*ring.records.peek(_drain_cursors[index]));
+		++count;
 
-		if (FlagOn(_log_to, log_to_ods))
+		if (_log_ring_release_chunk == ++_drain_cursors[index])
 		{
-			OutputDebugStringA(log->_msg.c_str());
+			ring.records.consume(_drain_cursors[index]);
+			_drain_cursors[index] = 0;
 		}
 
-		if (FlagOn(_log_to, log_to_file))
+		plog_record next = ring.records.peek(_drain_cursors[index]);
+		if (nullptr != next)
 		{
-			_ASSERTE(INVALID_HANDLE_VALUE != _log_file_handle);
+			_drain_heap.emplace_back(next->stamp, index);
+			std::push_heap(_drain_heap.begin(), _drain_heap.end(), later);
+		}
+	}
 
-			if (_log_count >= _max_log_count)
-			{
-				//
-				//	rotate_log_file()  ϸ _log_count  ʱȭ ʴ´. 
-				//	 ε rotate_log_file()   _log_count  
-				//	ʱȭ  ʾұ    õϰ ȴ. 
-				// 
-				//	rotate_log_file()  Ҷ  file log Ѱ ǵ
-				//	 ׳ Ѵ.
-				// 
-
-				if (true != rotate_log_file(_log_file_path.c_str()))
-				{
-					if (FlagOn(_log_to, log_to_con))
-					{
-						write_to_console(fc_red, "[ERR ] rotate_log_file() failed.");
-					}					
-					OutputDebugStringA("[ERR ] rotate_log_file() failed.");
-				}
-				else
-				{
-					//
-					//  α  ִٸ Ѵ.
-					//
-					remove_old_log_files();
-
-					//
-					// ο α Ͽ α׸ .
-					//
-					_log_count++;
-					write_to_filea(_log_file_handle, "%s", log->_msg.c_str());
-				}
-			}
-			else
-			{
-				//
-				//   _log_file_handle  ׻ ȿϴ. 
-				//
-				_ASSERTE(INVALID_HANDLE_VALUE != _log_file_handle);
-				_log_count++;
-				write_to_filea(_log_file_handle, "%s", log->_msg.c_str());
-			}
+	if (0 == batch_flush_due())
+	{
+		flush_batch();
+	}
+
+	bool retired = false;
+	for (size_t i = 0; i < _drain_rings.size(); ++i)
+	{
+		log_ring& ring = *_drain_rings[i];
+		ring.records.consume(_drain_cursors[i]);
+		_drain_cursors[i] = 0;
+
+		//   ring buffer    Ѵ.
+		if (true == ring.retired && nullptr == ring.records.peek(0))
+		{
+			retired = true;
+		}
+	}
+
+	if (true == retired)
+	{
+		boost::lock_guard< boost::mutex > lock(_rings_lock);
+		_rings.erase(std::remove_if(_rings.begin(),
+									_rings.end(),
+									[](const std::shared_ptr<log_ring>& ring) {
+			return (true == ring->retired && nullptr == ring->records.peek(0));
+		}), _rings.end());
+		++_rings_version;
+	}
+
+	return count;
+}
+
+/// @brief	α ϳ Ѵ.  α״ batch buffer  .
+void slogger::write_record(_In_ const log_record& record)
+{
+	const char* msg = record.msg;
+	size_t length = record.length;
+	bool binary_file = (true == _binary_file && FlagOn(_log_to, log_to_file));
+
+	//
+	// deferred record  ⼭ Ѵ. 
+	// binary α Ͽ  쿡   ʿ䰡 .
+	// 
+	if (FlagOn(record.flags, log_record_deferred))
+	{
+		if (FlagOn(_log_to, log_to_con | log_to_ods) ||
+			(FlagOn(_log_to, log_to_file) && true != binary_file))
+		{
+			length = log_format_deferred_record(_text,
+										 sizeof(_text),
+										 record.flags,
+										 record.level,
+										 record.time,
+										 GetCurrentProcessId(),
+										 record.tid,
+										 current_process_name().c_str(),
+										 record.function,
+										 record.fmt,
+										 record.msg,
+										 record.length);
+			msg = _text;
 		}
+	}
+	else if (0 == length)
+	{
+		return;
+	}
+
+	if (FlagOn(_log_to, log_to_con) && 0 < length)
+	{
+		switch (record.level)
+		{
+		case log_level_error: // same as log_level_critical
+			write_to_console(fc_red, msg);
+			break;
+		case log_level_info:
+		case log_level_warn:
+			write_to_console(fc_green, msg);
+			break;
+		default:
+			write_to_console(fc_none, msg);
+		}
+	}
 
-		delete log;
+	if (FlagOn(_log_to, log_to_ods) && 0 < length)
+	{
+		OutputDebugStringA(msg);
 	}
 
-	// flush all logs to target media only file.
-	//write_to_console(wtc_green, "[INFO] finalizing logs...");
+	if (FlagOn(_log_to, log_to_file))
 	{
-		boost::lock_guard< boost::mutex > lock(_lock);
+		if (log_level_error == record.level) _batch_error = true;
 
-		while (true != _log_queue.empty())
+		if (true == binary_file && FlagOn(record.flags, log_record_deferred))
 		{
-			plog_entry log = _log_queue.pop();
-			if (FlagOn(_log_to, log_to_file))
-			{
-				if (_log_count >= _max_log_count)
-				{
-					//
-					//	rotate_log_file()  ϸ _log_count  ʱȭ ʴ´. 
-					//	 ε rotate_log_file()   _log_count  
-					//	ʱȭ  ʾұ    õϰ ȴ. 
-					// 
-					//	rotate_log_file()  Ҷ  file log Ѱ ǵ
-					//	 ׳ Ѵ.
-					// 
-
-					if (true != rotate_log_file(_log_file_path.c_str()))
-					{
-						if (FlagOn(_log_to, log_to_con))
-						{
-							write_to_console(fc_red, "[ERR ] rotate_log_file() failed.\n");
-						}
-						OutputDebugStringA("[ERR ] rotate_log_file() failed.\n");
-					}
-					else
-					{
-						//
-						//  α  ִٸ Ѵ.
-						//
-						remove_old_log_files();
-						
-						//
-						// ο α Ͽ α׸ .
-						//
-						_log_count++;
-						write_to_filea(_log_file_handle, "%s", log->_msg.c_str());
-					}
-				}
-				else
-				{
-					//
-					//   _log_file_handle  ׻ ȿϴ. 
-					//
-					_ASSERTE(INVALID_HANDLE_VALUE != _log_file_handle);
-					_log_count++;
-					write_to_filea(_log_file_handle, "%s", log->_msg.c_str());
-				}
-			}
+			write_to_binary_file(record);
+		}
+		else if (0 < length)
+		{
+			write_to_file(record.level, msg, length);
+		}
+	}
+}
+
+/// @brief	Ͽ α׸   ʿϸ α  ϰ, 
+///			binary α   . 
+///			α׸    false  Ѵ.
+bool slogger::prepare_file_write()
+{
+	if (_log_count >= _max_log_count)
+	{
+		//
+		//	rotate_log_file()  ϸ _log_count  ʱȭ ʴ´. 
+		//	 ε rotate_log_file()   _log_count  
+		//	ʱȭ  ʾұ    õϰ ȴ. 
+		// 
+		//	rotate_log_file()  Ҷ  file log Ѱ ǵ
+		//	 ׳ Ѵ.
+		// 
+		//	rotate  Ƶ α״  α Ͽ .
+		// 
+		flush_batch();
 
+		if (true != rotate_log_file(_log_file_path.c_str()))
+		{
 			if (FlagOn(_log_to, log_to_con))
 			{
-				switch (log->_log_level)
-				{
-				case log_level_error: // same as log_level_critical
-					write_to_console(fc_red, log->_msg.c_str());
-					break;
-				case log_level_info:
-				case log_level_warn:
-					write_to_console(fc_green, log->_msg.c_str());
-					break;
-				default:
-					write_to_console(fc_none, log->_msg.c_str());
-				}
+				write_to_console(fc_red, "[ERR ] rotate_log_file() failed.\n");
 			}
+			OutputDebugStringA("[ERR ] rotate_log_file() failed.\n");
+			return false;
+		}
+	}
 
-			if (FlagOn(_log_to, log_to_ods))
-			{
-				OutputDebugStringA(log->_msg.c_str());
-			}
+	if (true == _file_header_pending)
+	{
+		const std::wstring& process_name = current_process_name();
+
+		log_bin_header header;
+		memcpy(header.magic, log_bin_magic, sizeof(header.magic));
+		header.version = log_bin_version;
+		header.pid = GetCurrentProcessId();
+		header.name_length = (uint32_t)process_name.size();
+		append_batch(&header, sizeof(header));
+		append_batch(process_name.c_str(), process_name.size() * sizeof(wchar_t));
+		_file_header_pending = false;
+	}
+	return true;
+}
+
+/// @brief	ؽƮ α׸ batch buffer  ߰Ѵ. 
+///			Ͽ flush_batch()  WriteFile() ѹ .
+void 
+slogger::write_to_file(
+	_In_ uint32_t level, 
+	_In_reads_(length) const char* msg, 
+	_In_ size_t length
+)
+{
+	_ASSERTE(INVALID_HANDLE_VALUE != _log_file_handle);
+	if (true != prepare_file_write()) return;
+
+	if (true == _binary_file)
+	{
+		log_bin_text text = { log_bin_type_text, (uint8_t)level, (uint32_t)length };
+		append_batch(&text, sizeof(text));
+	}
+	append_batch(msg, length);
+	_log_count++;
+}
+
+/// @brief	deferred record   ʰ binary α Ͽ .
+void slogger::write_to_binary_file(_In_ const log_record& record)
+{
+	_ASSERTE(INVALID_HANDLE_VALUE != _log_file_handle);
+	if (true != prepare_file_write()) return;
+
+	log_bin_record bin;
+	bin.type = log_bin_type_record;
+	bin.level = (uint8_t)record.level;
+	bin.flags = (uint16_t)(record.flags & ~log_record_deferred);
+	bin.tid = record.tid;
+	bin.time = record.time;
+	bin.fmt_id = binary_string_id(record.fmt);
+	bin.function_id = binary_string_id(record.function);
+	bin.length = record.length;
+	append_batch(&bin, sizeof(bin));
+	append_batch(record.msg, record.length);
+	_log_count++;
+}
+
+/// @brief	format string, Լ id  Ѵ. 
+///			 α Ͽ ó Ǵ ڿ̸ Ǹ  .
+///			str  ڿ ̹Ƿ (log_write_fmt_static())   Ѵ.
+uint32_t slogger::binary_string_id(_In_opt_z_ const char* str)
+{
+	if (nullptr == str) return 0;
+
+	auto it = _bin_strings.find(str);
+	if (it != _bin_strings.end()) return it->second;
+
+	uint32_t id = (uint32_t)_bin_strings.size() + 1;
+	_bin_strings[str] = id;
+
+	log_bin_string_def def;
+	def.type = log_bin_type_string;
+	def.id = id;
+	def.length = (uint32_t)strlen(str);
+	append_batch(&def, sizeof(def));
+	append_batch(str, def.length);
+	return id;
+}
+
+/// @brief	batch buffer  ߰Ѵ.  ϸ  Ͽ .
+void 
+slogger::append_batch(
+	_In_reads_bytes_(length) const void* data, 
+	_In_ size_t length
+)
+{
+	if (_batch_length + length > _batch_size)
+	{
+		flush_batch();
+	}
 
-			delete log;
+	//
+	// batch buffer  ū ʹ ٷ .
+	// 
+	if (length > _batch_size)
+	{
+		DWORD written = 0;
+		if (INVALID_HANDLE_VALUE != _log_file_handle)
+		{
+			WriteFile(_log_file_handle, data, (DWORD)length, &written, NULL);
+			++_file_writes;
 		}
-		//write_to_console(wtc_green, "done.\n");
-		//std::cout << boost::format("tid=0x%08x, %s logger thread terminated \n") % GetCurrentThreadId() % __FUNCTION__;
+		return;
+	}
 
-		_ASSERTE(true == _log_queue.empty());
+	if (0 == _batch_length)
+	{
+		_batch_tick = GetTickCount64();
 	}
+	memcpy(_batch.get() + _batch_length, data, length);
+	_batch_length += length;
+}
+
+/// @brief	batch buffer  Ͽ    ð (msec)  Ѵ. 
+///			0 ̸ ٷ  Ѵ. 
+uint32_t slogger::batch_flush_due()
+{
+	if (0 == _batch_length || 0 == _flush_interval) return 0;
+
+	// error α״  ʴ´.
+	if (true == _batch_error && log_sync_error == _sync_policy) return 0;
+
+	uint64_t elapsed = GetTickCount64() - _batch_tick;
+	if (elapsed >= _flush_interval) return 0;
+	return (uint32_t)(_flush_interval - elapsed);
 }
 
+/// @brief	batch buffer  Ƶ α׸ Ͽ . (group commit)
+///			sync å  FlushFileBuffers()  ȣѴ.
+void slogger::flush_batch()
+{
+	if (0 == _batch_length) return;
+
+	if (INVALID_HANDLE_VALUE != _log_file_handle)
+	{
+		DWORD written = 0;
+		WriteFile(_log_file_handle,
+				  _batch.get(),
+				  (DWORD)_batch_length,
+				  &written,
+				  NULL);
+		++_file_writes;
+
+		if (log_sync_batch == _sync_policy ||
+			(log_sync_error == _sync_policy && true == _batch_error))
+		{
+			FlushFileBuffers(_log_file_handle);
+			++_file_syncs;
+		}
+	}
+	_batch_length = 0;
+	_batch_error = false;
+}
@@ -6,6 +6,8 @@
  *			log format / 
  *
  *			multi thread ȯ濡 serialization  
+ *			α׸   lock  ڽ ring buffer  α׸ , 
+ *			logger thread  Ƽ Ѵ.
  *
  *			log_err, log_err  ũθ ϸ debugger, console  ޼  
  * @ref     
@@ -27,8 +29,14 @@
 #pragma warning(default:4005)
 #include <boost/format.hpp>
 
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <unordered_map>
 #include "Win32Utils.h"
-#include "Queue.h"
+#include "ring_queue.h"
 
 /// @brief log level
 #define log_level_debug         3
@@ -56,6 +64,125 @@
 ///			  α Ѵ. 
 #define _max_log_files_def 20
 
+/// @brief	α ޼ ִ  (line feed, NULL )
+#define _max_log_message_size	2048
+
+/// @brief	α׸    ҴǴ ring buffer  record 
+#define _log_ring_size_def		64
+
+/// @brief	logger thread  ring buffer   record  ȯϴ 
+#define _log_ring_release_chunk	8
+
+/// @brief	logger thread  Ͽ ѹ  ִ ũ
+#define _log_batch_size_def		(64 * 1024)
+
+/// @brief	batch buffer  (page ũ)
+#define _log_batch_align		4096
+
+/// @brief	 α׸ batch buffer  Ƶδ ִ ð (msec)
+///			batch buffer  ų  ð  Ͽ .
+#define _log_flush_interval_def	100
+
+/// @brief	 α fsync (FlushFileBuffers) å
+#define log_sync_never			0	// ȣ ʴ´. (⺻)
+#define log_sync_batch			1	// batch     ȣѴ.
+#define log_sync_error			2	// error α״  ʰ ٷ , ȣѴ.
+
+/// @brief	log  
+#define log_format_text			0	// α׸  忡  (⺻)
+#define log_format_deferred		1	// ڸ ϰ logger thread  
+#define log_format_binary		2	// deferred +  α׸ binary   
+									// (decode_log_file()  ؽƮ ȯ)
+#define log_format_json			3	// α  ٿ JSON object ϳ (JSON lines)
+									// decoration   time, level, 
+									// pid, tid, process, function, msg   .
+
+/// @brief	log decoration (log_record::flags)
+#define log_deco_level			0x0001
+#define log_deco_time			0x0002
+#define log_deco_process_name	0x0004
+#define log_deco_pid_tid		0x0008
+#define log_deco_function_name	0x0010
+#define log_record_deferred		0x8000
+
+/// @brief	ȭ α key/value ʵ (log_xxx_kv ũ)
+///			json 忡 JSON object  , ٸ 忡 ޼ 
+///			ڿ ` key=value` · µȴ. 
+///			key, ڿ   Ƿ α׸   ȿؾ Ѵ.
+typedef struct log_field
+{
+	typedef enum value_type
+	{
+		type_int,
+		type_uint,
+		type_double,
+		type_bool,
+		type_str,
+		type_wstr
+	} value_type;
+
+	const char*		key;
+	value_type		type;
+	union
+	{
+		int64_t			int_value;
+		uint64_t		uint_value;
+		double			double_value;
+		bool			bool_value;
+		const char*		str_value;
+		const wchar_t*	wstr_value;
+	};
+
+	template <typename T>
+	log_field(_In_z_ const char* key, 
+			  _In_ T value, 
+			  typename std::enable_if<std::is_integral<T>::value>::type* = nullptr) :
+		key(key)
+	{
+		if (true == std::is_signed<T>::value)
+		{
+			type = type_int; int_value = (int64_t)value;
+		}
+		else
+		{
+			type = type_uint; uint_value = (uint64_t)value;
+		}
+	}
+
+	template <typename T>
+	log_field(_In_z_ const char* key, 
+			  _In_ T value, 
+			  typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr) :
+		key(key), type(type_double), double_value((double)value)
+	{
+	}
+
+	log_field(_In_z_ const char* key, _In_ bool value) : 
+		key(key), type(type_bool), bool_value(value)
+	{
+	}
+
+	log_field(_In_z_ const char* key, _In_opt_z_ const char* value) : 
+		key(key), type(type_str), str_value(value)
+	{
+	}
+
+	log_field(_In_z_ const char* key, _In_opt_z_ const wchar_t* value) :
+		key(key), type(type_wstr), wstr_value(value)
+	{
+	}
+
+	log_field(_In_z_ const char* key, _In_ const std::string& value) :
+		key(key), type(type_str), str_value(value.c_str())
+	{
+	}
+
+	log_field(_In_z_ const char* key, _In_ const std::wstring& value) :
+		key(key), type(type_wstr), wstr_value(value.c_str())
+	{
+	}
+} *plog_field;
+
 //
 // C like APIs
 //
@@ -90,6 +217,61 @@ get_log_format(
 	_Out_ bool& show_function_name
 	);
 
+/// @brief	log   (log_format_text, log_format_deferred, log_format_binary, 
+///			log_format_json)
+///			log_format_binary  initialize_log()  ؾ Ͽ ȴ.
+///
+///			deferred, binary 忡  ̷  log_err, log_info  
+///			ũ (log_write_fmt_static())   α ̴. logger thread  
+///			fmt, function ͸ ߿ а, binary α״   
+///			ڿ ϱ ̴. log_write_fmt()   ȣ α״ 
+///			׻ ȣ 忡 Ѵ.
+void set_log_format_mode(_In_ uint32_t mode);
+uint32_t get_log_format_mode();
+
+/// @brief	 α group commit  
+///			batch_size  page ũ  øϰ, flush_interval  0 ̸ 
+///			logger thread    ׻ Ͽ . 
+///			initialize_log()  ؾ ȴ.
+void 
+set_log_commit_policy(
+	_In_ uint32_t batch_size, 
+	_In_ uint32_t flush_interval, 
+	_In_ uint32_t sync
+	);
+
+void 
+get_log_commit_policy(
+	_Out_ uint32_t& batch_size, 
+	_Out_ uint32_t& flush_interval, 
+	_Out_ uint32_t& sync
+	);
+
+/// @brief	logger  (get_log_stats())
+typedef struct log_stats
+{
+	uint64_t	queue_depth;	///< ring buffer  ׿ִ α 
+	uint64_t	dropped;		///< logger  Ǵ ̶  α 
+	uint64_t	delayed;		///< ring buffer    ٸ α 
+	uint64_t	file_writes;	///< α Ͽ  (WriteFile) Ƚ
+	uint64_t	file_syncs;		///< FlushFileBuffers ȣ Ƚ
+} *plog_stats;
+
+/// @brief	logger ¸ Ѵ. logger   false  Ѵ.
+bool get_log_stats(_Out_ log_stats& stats);
+
+/// @brief	  α  NTFS   
+///			initialize_log()  ؾ ȴ.
+void set_log_compress_rotated(_In_ bool compress);
+bool get_log_compress_rotated();
+
+/// @brief	log_format_binary  ϵ α  ؽƮ α Ϸ ȯѴ.
+bool
+decode_log_file(
+	_In_z_ const wchar_t* binary_log_path,
+	_In_z_ const wchar_t* text_log_path
+	);
+
 void
 set_log_env(
 	_In_ uint32_t mask,
@@ -112,6 +294,14 @@ const char* log_level_to_str(_In_ uint32_t log_level);
 const char* log_to_to_str(_In_ uint32_t log_to);
 
 
+/// @brief	fmt, function  ȣ 忡 ٷ ϹǷ ̳  
+///			ڿ̾ ȴ.
+///
+///			log_write_fmt_static(), log_write_fmt_without_deco_static()  
+///			log_xxx ũο̴. deferred, binary 忡 ͸ ϰ 
+///			logger thread  ߿ Ƿ, fmt  function  μ 
+///			   ȿϰ ٲ ʴ ڿ (ڿ , __FUNCTION__) 
+///			̾ Ѵ.
 #ifdef _NO_LOG_
 
 inline
@@ -126,6 +316,18 @@ log_write_fmt(
 {
 }
 
+inline
+void
+log_write_fmt_static(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,	
+	_In_z_ const char* function,
+	_In_z_ const char* fmt,
+	_In_ ...
+)
+{
+}
+
 #else
 
 void
@@ -137,6 +339,15 @@ log_write_fmt(
 	_In_ ...
 );
 
+void
+log_write_fmt_static(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,	
+	_In_z_ const char* function,
+	_In_z_ const char* fmt,
+	_In_ ...
+);
+
 #endif // _NO_LOG_
 
 void
@@ -147,19 +358,290 @@ log_write_fmt_without_deco(
     _In_ ...
     );
 
+void
+log_write_fmt_without_deco_static(
+    _In_ uint32_t log_mask, 
+    _In_ uint32_t log_level,    
+    _In_z_ const char* fmt,
+    _In_ ...
+    );
+
+/// @brief	key/value ʵ带  α׸ . 
+///			deferred, binary 忡 ʵ ٷ Ѵ.
+void
+log_write_kv(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* function,
+	_In_reads_(field_count) const log_field* fields,
+	_In_ size_t field_count,
+	_In_z_ const char* fmt,
+	_In_ ...
+	);
+
+/// @brief	 Ǵ α ִ level, mask
+///			   level ̰ų mask  Ե ʴ log_xxx ũδ 
+///			ȣ ڵ尡  ʴ´. (ڵ 򰡵 )
+///			e.g. release 忡 log_dbg  Ϸ 
+///				 /D_compiled_log_level=log_level_info
+#ifndef _compiled_log_level
+#define _compiled_log_level		log_level_debug
+#endif
+
+#ifndef _compiled_log_mask
+#define _compiled_log_mask		log_mask_all
+#endif
+
+/// @brief	  log mask, level (set_log_env()  )
+extern uint32_t _log_mask;
+extern uint32_t _log_level;
+
+/// @brief	mask, level  αװ  Ǵ 
+template <uint32_t mask, uint32_t level>
+struct log_compiled
+{
+	static const bool value = (level <= _compiled_log_level) &&
+							  (mask == (mask & (uint32_t)_compiled_log_mask));
+};
+
+/// @brief	mask, level  α׸  ϴ ȮѴ. 
+///			log_xxx ũδ ڸ ϱ   Լ  ȮϹǷ 
+///			ִ α״  ѹ 븸 . 
+///			  ʴ α״  false ̹Ƿ ȣ ڵ尡 ŵȴ.
+template <uint32_t mask, uint32_t level>
+inline bool log_enabled()
+{
+	return (true == log_compiled<mask, level>::value) &&
+		   (level <= _log_level) &&
+		   (mask == (_log_mask & mask));
+}
+
 //
 // define macro for convenience
 //
-#define log_err		log_write_fmt( log_mask_sys, log_level_error, __FUNCTION__, 
-#define log_warn	log_write_fmt( log_mask_sys, log_level_warn, __FUNCTION__,  
-#define log_info	log_write_fmt( log_mask_sys, log_level_info, __FUNCTION__, 
-#define log_dbg		log_write_fmt( log_mask_sys, log_level_debug, __FUNCTION__, 
-#define log_msg     log_write_fmt_without_deco( log_mask_sys, log_level_warn,
+// `if (!enabled) {} else` ̹Ƿ if/else ȿ ص ϴ. 
+// 
+#define log_write_if(mask, level)	if (true != log_enabled<mask, level>()) {} else
+#define log_err		log_write_if(log_mask_sys, log_level_error) log_write_fmt_static( log_mask_sys, log_level_error, __FUNCTION__, 
+#define log_warn	log_write_if(log_mask_sys, log_level_warn) log_write_fmt_static( log_mask_sys, log_level_warn, __FUNCTION__,  
+#define log_info	log_write_if(log_mask_sys, log_level_info) log_write_fmt_static( log_mask_sys, log_level_info, __FUNCTION__, 
+#define log_dbg		log_write_if(log_mask_sys, log_level_debug) log_write_fmt_static( log_mask_sys, log_level_debug, __FUNCTION__, 
+#define log_msg     log_write_if(log_mask_sys, log_level_warn) log_write_fmt_without_deco_static( log_mask_sys, log_level_warn,
+
+/// @brief	key/value ʵ带  α 
+///			e.g. 
+///				log_field fields[] = { log_field("path", path), log_field("gle", GetLastError()) };
+///				log_err_kv(fields) "file_util_get_hash() failed" log_end;
+#define log_err_kv(fields)	log_write_if(log_mask_sys, log_level_error) log_write_kv( log_mask_sys, log_level_error, __FUNCTION__, fields, _countof(fields), 
+#define log_warn_kv(fields)	log_write_if(log_mask_sys, log_level_warn) log_write_kv( log_mask_sys, log_level_warn, __FUNCTION__, fields, _countof(fields), 
+#define log_info_kv(fields)	log_write_if(log_mask_sys, log_level_info) log_write_kv( log_mask_sys, log_level_info, __FUNCTION__, fields, _countof(fields), 
+#define log_dbg_kv(fields)	log_write_if(log_mask_sys, log_level_debug) log_write_kv( log_mask_sys, log_level_debug, __FUNCTION__, fields, _countof(fields), 
 
 #define log_end		);
 
 
+/// @brief	call site  α  
+///
+///			log_xxx_ratelimited	: interval  burst   ϰ  
+///								  .  α   interval  ó 
+///								  µ , Ǵ log maintenance thread  
+///								  ֱ Ѵ. 
+///			log_xxx_once		: ó ѹ Ѵ. 
+///
+///			e.g. 
+///				for (...)
+///				{
+///					if (true != file_util_get_hash(...))
+///					{
+///						log_err_ratelimited "file_util_get_hash() failed. file=%ws", path log_end;
+///					}
+///				}
+#define _log_ratelimit_burst_def		10
+#define _log_ratelimit_interval_def		1000	// msec
+
+/// @brief	 α  Ѵ. 
+void
+log_write_suppressed(
+	_In_ uint32_t log_mask,
+	_In_ uint32_t log_level,
+	_In_z_ const char* function,
+	_In_ uint32_t suppressed
+	);
+
+/// @brief	interval  burst  token  ä token bucket
+///			 32 bit  interval ȣ,  32 bit  ȣ Ƚ̹Ƿ 
+///			 interval ȿ fetch_add ѹ ȮѴ. 
+///			 α    ʰ interval  ٲ  
+///			(ȣ Ƚ - burst)  Ѵ. 
+///
+///			flush_on_timer ̸ ó α׸   Ͽ ϵǰ, 
+///			log maintenance thread  flush_sites()   interval  
+///			 α  Ѵ. Ͽ ŵ Ƿ 
+///			static ü ؾ Ѵ. (log_site_rate_limiter)
+class log_rate_limiter
+{
+public:
+	constexpr log_rate_limiter(_In_ uint32_t burst = _log_ratelimit_burst_def,
+					 _In_ uint32_t interval = _log_ratelimit_interval_def, 
+					 _In_ bool flush_on_timer = false) :
+		_state(0), 
+		_burst(burst), 
+		_interval(interval), 
+		_flush_on_timer(flush_on_timer), 
+		_registered(false), 
+		_next(nullptr), 
+		_log_mask(0), 
+		_log_level(0), 
+		_function(nullptr)
+	{
+	}
+
+	bool allow(_In_ uint32_t log_mask, _In_ uint32_t log_level, _In_z_ const char* function)
+	{
+		uint32_t now = (uint32_t)(GetTickCount64() / _interval);
+		uint64_t state = _state.fetch_add(1, std::memory_order_relaxed);
+		if ((uint32_t)(state >> 32) != now)
+		{
+			return next_interval(now, state, log_mask, log_level, function);
+		}
+
+		uint32_t count = (uint32_t)state;
+		if (count < _burst) return true;
+
+		// interval  ó  常 ȮѴ.
+		if (count == _burst && true == _flush_on_timer)
+		{
+			register_site(log_mask, log_level, function);
+		}
+		return false;
+	}
+
+	/// @brief	interval    α  ϰ, 
+	///			  Ѵ. 
+	uint32_t 
+	flush_suppressed(
+		_In_ uint32_t log_mask, 
+		_In_ uint32_t log_level, 
+		_In_z_ const char* function
+		);
+
+	/// @brief	ϵ  limiter   α  ϰ, 
+	///			   Ѵ. 
+	static uint32_t flush_sites();
+
+private:
+	bool 
+	next_interval(
+		_In_ uint32_t now, 
+		_In_ uint64_t state, 
+		_In_ uint32_t log_mask, 
+		_In_ uint32_t log_level, 
+		_In_z_ const char* function
+		);
+
+	void 
+	register_site(
+		_In_ uint32_t log_mask, 
+		_In_ uint32_t log_level, 
+		_In_z_ const char* function
+		);
+
+private:
+	std::atomic<uint64_t>	_state;
+	const uint32_t			_burst;
+	const uint32_t			_interval;
+	const bool				_flush_on_timer;
+
+	// flush_sites() ,  Ŀ  ʴ´.
+	std::atomic<bool>		_registered;
+	log_rate_limiter*		_next;
+	uint32_t				_log_mask;
+	uint32_t				_log_level;
+	const char*				_function;
+
+	static std::atomic<log_rate_limiter*> _sites;
+};
+
+/// @brief	log_xxx_ratelimited  call site  limiter 
+class log_site_rate_limiter : public log_rate_limiter
+{
+public:
+	constexpr log_site_rate_limiter() : 
+		log_rate_limiter(_log_ratelimit_burst_def, _log_ratelimit_interval_def, true)
+	{
+	}
+};
+
+/// @brief	ó ѹ Ѵ. 
+class log_once_flag
+{
+public:
+	constexpr log_once_flag() : _done(false)
+	{
+	}
+
+	bool allow(_In_ uint32_t, _In_ uint32_t, _In_z_ const char*)
+	{
+		return (true != _done.load(std::memory_order_relaxed) &&
+				true != _done.exchange(true, std::memory_order_relaxed));
+	}
+
+private:
+	std::atomic<bool>		_done;
+};
+
+/// @brief	call site  ϳ Ǵ static ü 
+///			lambda  call site  Ÿ ٸǷ static   . 
+///			constexpr ̹Ƿ ʱȭ guard   ʱȭ ȴ. 
+#define log_site_static(type)	([]() -> type& { static type _log_site; return _log_site; }())
+
+#define log_write_limited(mask, level, limiter) \
+	log_write_if(mask, level) if (true != (limiter).allow(mask, level, __FUNCTION__)) {} else
+
+#define log_err_ratelimited		log_write_limited(log_mask_sys, log_level_error, log_site_static(log_site_rate_limiter)) log_write_fmt_static( log_mask_sys, log_level_error, __FUNCTION__, 
+#define log_warn_ratelimited	log_write_limited(log_mask_sys, log_level_warn, log_site_static(log_site_rate_limiter)) log_write_fmt_static( log_mask_sys, log_level_warn, __FUNCTION__, 
+#define log_info_ratelimited	log_write_limited(log_mask_sys, log_level_info, log_site_static(log_site_rate_limiter)) log_write_fmt_static( log_mask_sys, log_level_info, __FUNCTION__, 
+#define log_dbg_ratelimited		log_write_limited(log_mask_sys, log_level_debug, log_site_static(log_site_rate_limiter)) log_write_fmt_static( log_mask_sys, log_level_debug, __FUNCTION__, 
+
+#define log_err_once			log_write_limited(log_mask_sys, log_level_error, log_site_static(log_once_flag)) log_write_fmt_static( log_mask_sys, log_level_error, __FUNCTION__, 
+#define log_warn_once			log_write_limited(log_mask_sys, log_level_warn, log_site_static(log_once_flag)) log_write_fmt_static( log_mask_sys, log_level_warn, __FUNCTION__, 
+#define log_info_once			log_write_limited(log_mask_sys, log_level_info, log_site_static(log_once_flag)) log_write_fmt_static( log_mask_sys, log_level_info, __FUNCTION__, 
+#define log_dbg_once			log_write_limited(log_mask_sys, log_level_debug, log_site_static(log_once_flag)) log_write_fmt_static( log_mask_sys, log_level_debug, __FUNCTION__, 
+
+
+/// @brief	 ũ log record
+///			α׸   ڽ ring buffer  ִ record  
+///			޼  Ѵ. 
+///			deferred 忡 msg    ڸ ϰ, 
+///			logger thread  Ѵ. (log_format.h )
+typedef struct log_record
+{
+	uint64_t	stamp;		///< 尣   (tsc)
+	uint32_t	level;
+	uint32_t	length;		///< msg  (NULL ), ؽƮ αװ 0 ̸  
+	uint32_t	flags;		///< log_deco_xxx, log_record_deferred
+	uint32_t	tid;		///< deferred
+	uint64_t	time;		///< deferred, FILETIME (UTC)
+	const char*	fmt;		///< deferred, ڿ 
+	const char*	function;	///< deferred, ڿ 
+	char		msg[_max_log_message_size];
+} *plog_record;
+
+/// @brief	α׸   ϳ ring buffer (single producer, single consumer)
+///			尡 Ǹ retired  ǥõǰ, logger thread   
+///			α׸    Ѵ. 
+typedef struct log_ring
+{
+	explicit log_ring(_In_ uint32_t size) : records(size), retired(false) {}
+
+	ring_queue<log_record, ring_spsc> records;
+	std::atomic<bool> retired;
+} *plog_ring;
+
 /// @brief	logger_impl class
+///			α ޼   ring buffer  lock  ̰, 
+///			logger thread  αװ    ring buffer  
+///			α׸ ð   ѹ . 
 typedef class slogger: private boost::noncopyable
 {
 public:
@@ -167,7 +649,12 @@ public:
 					 _In_ uint32_t log_to, 
 					 _In_opt_z_ const wchar_t*log_file_path,
 					 _In_ uint32_t max_log_count = _max_log_count_def, 
-					 _In_ uint32_t max_log_files = _max_log_files_def);
+					 _In_ uint32_t max_log_files = _max_log_files_def,
+					 _In_ bool binary_file = false,
+					 _In_ uint32_t batch_size = _log_batch_size_def,
+					 _In_ uint32_t flush_interval = _log_flush_interval_def,
+					 _In_ uint32_t sync_policy = log_sync_never,
+					 _In_ bool compress_rotated = false);
     ~slogger();
 
     bool slog_start();
@@ -183,8 +670,29 @@ public:
 	uint32_t log_level() { return _log_level; }
 	uint32_t log_to() { return _log_to; }
 	void slog_write(_In_ uint32_t level, _In_z_ const char* log_message);
+
+	/// @brief	ȣ  ring buffer  record  ϳ ҴѴ. 
+	///			record->msg, record->length  ä  slog_commit()  
+	///			logger thread  ѱ. 
+	///			level   ʰų logger    nullptr  Ѵ.
+	plog_record slog_reserve(_In_ uint32_t level);
+	void slog_commit(_In_ plog_record record);
+
+	/// @brief	logger  Ǵ ̶  α 
+	uint64_t dropped_count() const { return _dropped; }
+
+	/// @brief	ring buffer    logger thread  ٸ α 
+	uint64_t delayed_count() const { return _delayed; }
+
+	/// @brief	 ring buffer  ׿ִ α  
+	size_t queue_depth();
+
+	/// @brief	α Ͽ  (WriteFile) Ƚ, FlushFileBuffers ȣ Ƚ
+	uint64_t file_write_count() const { return _file_writes; }
+	uint64_t file_sync_count() const { return _file_syncs; }
+
 private:
-    bool volatile _stop_logger;
+    std::atomic<bool> _stop_logger;
     uint32_t volatile _log_level;
 	uint32_t volatile _log_to;
 	uint32_t volatile _max_log_count;
@@ -205,20 +713,81 @@ private:
 	};
 	std::list<log_file_and_ctime> _log_files;
 
-	typedef class log_entry
-	{
-	public:
-		log_entry(_In_ uint32_t log_level, const char* log_message)
-            : _log_level(log_level), _msg(log_message)
-        {
-        }
+	//
+	// producer  ring buffer 
+	// 
+	const uint64_t _instance;
+	boost::mutex _rings_lock;
+	std::vector<std::shared_ptr<log_ring>> _rings;
+	std::atomic<uint32_t> _rings_version;
+	std::atomic<uint64_t> _dropped;
+	std::atomic<uint64_t> _delayed;
+
+	//
+	// logger thread  αװ  , 
+	// producer  logger thread   쿡 . 
+	// 
+	std::atomic<bool> _consumer_idle;
+	boost::mutex _wakeup_lock;
+	boost::condition_variable _wakeup_cond;
+	bool _wakeup;
+
+	//
+	// logger thread 
+	// 
+	std::vector<std::shared_ptr<log_ring>> _drain_rings;
+	std::vector<size_t> _drain_cursors;
+	std::vector<std::pair<uint64_t, size_t>> _drain_heap;	///< (stamp, ring index) min heap
+	uint32_t _drain_version;
+	char _text[_max_log_message_size];
+
+	//
+	//  α group commit 
+	// batch buffer  page  ؼ ҴѴ.
+	// 
+	const size_t _batch_size;
+	const uint32_t _flush_interval;
+	const uint32_t _sync_policy;
+	std::unique_ptr<char, void(*)(void*)> _batch;
+	size_t _batch_length;
+	uint64_t _batch_tick;			///< batch  ó ߰ ð (GetTickCount64)
+	bool _batch_error;				///< batch  error αװ 
+	std::atomic<uint64_t> _file_writes;
+	std::atomic<uint64_t> _file_syncs;
+
+	//
+	// binary α  (log_format_binary)
+	// format string, Լ id     ҴѴ.
+	// ڿ  deferred  ϵǹǷ (log_write_fmt_static()) ͸ Ű .
+	// 
+	const bool _binary_file;
+	bool _file_header_pending;
+	std::unordered_map<const char*, uint32_t> _bin_strings;
 
-        uint32_t    _log_level;
-        std::string _msg;
-	} *plog_entry;
-
-	Queue<plog_entry>	_log_queue;
     boost::thread*		_logger_thread;
+
+	//
+	// α   
+	// logger thread  ̸   α Ϸ ̸ ٲ㼭 üϰ, 
+	//  α  ݱ, ,  α  ,  α  غ 
+	//  켱 maintenance thread  Ѵ. 
+	// _log_files  slog_start() Ŀ maintenance thread  Ѵ.
+	// 
+	typedef struct rotated_log_file
+	{
+		HANDLE			handle;		///< ݾƾ  handle ( INVALID_HANDLE_VALUE)
+		std::wstring	path;		///<    ( empty)
+	} *protated_log_file;
+
+	const bool _compress_rotated;
+	boost::thread* _maintenance_thread;
+	boost::mutex _maintenance_lock;
+	boost::condition_variable _maintenance_cond;
+	bool _stop_maintenance;
+	std::list<rotated_log_file> _rotated_files;
+	std::wstring _next_log_file_path;
+	HANDLE _next_log_file_handle;
+	bool _next_log_file_wanted;
 		
 	int64_t _log_count;
 	std::wstring _log_file_path;
@@ -228,6 +797,22 @@ private:
 	bool rotate_log_file(_In_ const wchar_t* log_file_path);
 	bool enum_old_log_files();
 	void remove_old_log_files();
+	void queue_rotated_log_file(_In_ HANDLE handle, _In_opt_z_ const wchar_t* path);
+	HANDLE take_next_log_file(_In_z_ const wchar_t* log_file_path);
+	void compress_log_file(_In_z_ const wchar_t* path);
+	void slog_maintenance_thread();
+
+	log_ring* producer_ring();
+	void wakeup_consumer();
+	size_t drain_rings();
+	void write_record(_In_ const log_record& record);
+	bool prepare_file_write();
+	void write_to_file(_In_ uint32_t level, _In_reads_(length) const char* msg, _In_ size_t length);
+	void write_to_binary_file(_In_ const log_record& record);
+	uint32_t binary_string_id(_In_opt_z_ const char* str);
+	void append_batch(_In_reads_bytes_(length) const void* data, _In_ size_t length);
+	uint32_t batch_flush_due();
+	void flush_batch();
 
     void slog_thread();
 	
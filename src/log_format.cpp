@@ -0,0 +1,1259 @@
+/**
+ * @file    log_format.cpp
+ * @brief   log record , binary α  decoder
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+
+#include "stdafx.h"
+#include <map>
+#include <vector>
+#include "log.h"
+#include "log_format.h"
+
+/// @brief	printf  Ÿ
+typedef enum log_arg_type
+{
+	log_arg_none,		// %%
+	log_arg_int32,
+	log_arg_int64,
+	log_arg_double,
+	log_arg_pointer,
+	log_arg_string,
+	log_arg_wstring,
+	log_arg_invalid		// %n   ʴ conversion
+} *plog_arg_type;
+
+/// @brief	format string  conversion spec ϳ
+typedef struct log_arg_spec
+{
+	const char*		begin;			///< '%'
+	size_t			length;
+	uint32_t		stars;			///< '*'   width, precision  
+	log_arg_type	type;
+	bool			long_double;	///< %Lf (double  /Ѵ)
+} *plog_arg_spec;
+
+/// @brief	fmt   conversion spec  ãƼ spec  ä,
+///			fmt  spec  ű.  ̻  false  Ѵ.
+static
+bool
+next_arg_spec(
+	_Inout_ const char*& fmt,
+	_Out_ log_arg_spec& spec
+)
+{
+	const char* p = strchr(fmt, '%');
+	if (nullptr == p)
+	{
+		fmt += strlen(fmt);
+		return false;
+	}
+
+	spec.begin = p++;
+	spec.stars = 0;
+	spec.long_double = false;
+
+	if ('%' == *p)
+	{
+		spec.type = log_arg_none;
+		spec.length = 2;
+		fmt = p + 1;
+		return true;
+	}
+
+	// flags
+	while ('\0' != *p && nullptr != strchr("-+ #0", *p)) ++p;
+
+	// width
+	if ('*' == *p) { ++spec.stars; ++p; }
+	else while (isdigit((unsigned char)*p)) ++p;
+
+	// precision
+	if ('.' == *p)
+	{
+		++p;
+		if ('*' == *p) { ++spec.stars; ++p; }
+		else while (isdigit((unsigned char)*p)) ++p;
+	}
+
+	// length modifier
+	size_t int_size = sizeof(int);
+	bool wide = false;
+	switch (*p)
+	{
+	case 'h':
+		++p;
+		if ('h' == *p) ++p;
+		break;
+	case 'l':
+		++p;
+		if ('l' == *p) { ++p; int_size = sizeof(long long); }
+		else { int_size = sizeof(long); wide = true; }
+		break;
+	case 'L':
+		++p;
+		spec.long_double = true;
+		break;
+	case 'w':
+		++p;
+		wide = true;
+		break;
+	case 'j':
+		++p;
+		int_size = sizeof(intmax_t);
+		break;
+	case 'z':
+	case 't':
+		++p;
+		int_size = sizeof(size_t);
+		break;
+	case 'I':
+		++p;
+		if ('6' == p[0] && '4' == p[1]) { p += 2; int_size = sizeof(int64_t); }
+		else if ('3' == p[0] && '2' == p[1]) { p += 2; int_size = sizeof(int32_t); }
+		else { int_size = sizeof(size_t); }
+		break;
+	}
+
+	switch (*p)
+	{
+	case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+		spec.type = (sizeof(int64_t) == int_size) ? log_arg_int64 : log_arg_int32;
+		break;
+	case 'c': case 'C':
+		spec.type = log_arg_int32;		// char, wchar_t  int  ޵ȴ.
+		break;
+	case 's':
+		spec.type = (true == wide) ? log_arg_wstring : log_arg_string;
+		break;
+	case 'S':
+		spec.type = log_arg_wstring;
+		break;
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+		spec.type = log_arg_double;
+		break;
+	case 'p':
+		spec.type = log_arg_pointer;
+		break;
+	default:
+		spec.type = log_arg_invalid;
+		break;
+	}
+
+	if ('\0' != *p) ++p;
+	spec.length = (size_t)(p - spec.begin);
+	fmt = p;
+	return true;
+}
+
+/// @brief	buffer  data  ߰Ѵ.  ϸ false
+static
+bool
+put_arg(
+	_Inout_ char*& pos,
+	_In_ const char* end,
+	_In_reads_bytes_(size) const void* data,
+	_In_ size_t size
+)
+{
+	if ((size_t)(end - pos) < size) return false;
+	memcpy(pos, data, size);
+	pos += size;
+	return true;
+}
+
+/// @brief	args  data  д´.  Ͱ ϸ false
+static
+bool
+get_arg(
+	_Inout_ const char*& pos,
+	_In_ const char* end,
+	_Out_writes_bytes_(size) void* data,
+	_In_ size_t size
+)
+{
+	if ((size_t)(end - pos) < size) return false;
+	memcpy(data, pos, size);
+	pos += size;
+	return true;
+}
+
+/// @brief
+bool
+log_pack_args(
+	_Out_writes_bytes_(size) char* buffer,
+	_In_ size_t size,
+	_In_z_ const char* fmt,
+	_In_ va_list args,
+	_Out_ uint32_t& length
+)
+{
+	_ASSERTE(nullptr != buffer);
+	_ASSERTE(nullptr != fmt);
+
+	char* pos = buffer;
+	const char* end = buffer + size;
+	log_arg_spec spec;
+	while (true == next_arg_spec(fmt, spec))
+	{
+		for (uint32_t i = 0; i < spec.stars; ++i)
+		{
+			int star = va_arg(args, int);
+			if (true != put_arg(pos, end, &star, sizeof(star))) return false;
+		}
+
+		bool ret = true;
+		switch (spec.type)
+		{
+		case log_arg_none:
+			break;
+		case log_arg_int32:
+		{
+			int32_t value = va_arg(args, int32_t);
+			ret = put_arg(pos, end, &value, sizeof(value));
+			break;
+		}
+		case log_arg_int64:
+		{
+			int64_t value = va_arg(args, int64_t);
+			ret = put_arg(pos, end, &value, sizeof(value));
+			break;
+		}
+		case log_arg_double:
+		{
+			double value = (true == spec.long_double) ?
+				(double)va_arg(args, long double) :
+				va_arg(args, double);
+			ret = put_arg(pos, end, &value, sizeof(value));
+			break;
+		}
+		case log_arg_pointer:
+		{
+			uint64_t value = (uint64_t)(uintptr_t)va_arg(args, void*);
+			ret = put_arg(pos, end, &value, sizeof(value));
+			break;
+		}
+		case log_arg_string:
+		{
+			const char* value = va_arg(args, const char*);
+			uint32_t value_length = (nullptr == value) ? log_bin_null_string : (uint32_t)strlen(value);
+			ret = put_arg(pos, end, &value_length, sizeof(value_length));
+			if (true == ret && nullptr != value)
+			{
+				ret = put_arg(pos, end, value, value_length);
+			}
+			break;
+		}
+		case log_arg_wstring:
+		{
+			const wchar_t* value = va_arg(args, const wchar_t*);
+			uint32_t value_length = (nullptr == value) ? log_bin_null_string : (uint32_t)wcslen(value);
+			ret = put_arg(pos, end, &value_length, sizeof(value_length));
+			if (true == ret && nullptr != value)
+			{
+				ret = put_arg(pos, end, value, value_length * sizeof(wchar_t));
+			}
+			break;
+		}
+		default:
+			return false;
+		}
+
+		if (true != ret) return false;
+	}
+
+	length = (uint32_t)(pos - buffer);
+	return true;
+}
+
+/// @brief	 ϳ Ѵ.
+template <typename T>
+static
+HRESULT
+format_arg(
+	_Inout_ char*& pos,
+	_Inout_ size_t& remain,
+	_In_z_ const char* spec,
+	_In_ uint32_t stars,
+	_In_ const int* star,
+	_In_ T value
+)
+{
+	switch (stars)
+	{
+	case 0: return StringCbPrintfExA(pos, remain, &pos, &remain, 0, spec, value);
+	case 1: return StringCbPrintfExA(pos, remain, &pos, &remain, 0, spec, star[0], value);
+	default: return StringCbPrintfExA(pos, remain, &pos, &remain, 0, spec, star[0], star[1], value);
+	}
+}
+
+/// @brief
+size_t
+log_format_args(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_z_ const char* fmt,
+	_In_reads_bytes_(length) const char* args,
+	_In_ size_t length
+)
+{
+	_ASSERTE(nullptr != buffer);
+	_ASSERTE(0 < size);
+	if (nullptr == buffer || 0 == size) return 0;
+
+	char* pos = buffer;
+	size_t remain = size;
+	*pos = '\0';
+
+	const char* arg = args;
+	const char* arg_end = args + length;
+	HRESULT hRes = S_OK;
+	while (S_OK == hRes && '\0' != *fmt)
+	{
+		//
+		// conversion spec  ڿ
+		//
+		const char* literal = fmt;
+		log_arg_spec spec;
+		bool has_spec = next_arg_spec(fmt, spec);
+		size_t literal_length = (size_t)(((true == has_spec) ? spec.begin : fmt) - literal);
+		if (0 < literal_length)
+		{
+			hRes = StringCbCatNExA(pos, remain, literal, literal_length, &pos, &remain, 0);
+		}
+		if (S_OK != hRes || true != has_spec) break;
+
+		if (log_arg_none == spec.type)
+		{
+			hRes = StringCbCatNExA(pos, remain, "%", 1, &pos, &remain, 0);
+			continue;
+		}
+
+		//
+		// conversion spec  Ѵ. (%Lf  %f )
+		//
+		char spec_fmt[32];
+		size_t spec_length = 0;
+		for (size_t i = 0; i < spec.length && spec_length < sizeof(spec_fmt) - 1; ++i)
+		{
+			if (true == spec.long_double && 'L' == spec.begin[i]) continue;
+			spec_fmt[spec_length++] = spec.begin[i];
+		}
+		spec_fmt[spec_length] = '\0';
+		if (log_arg_invalid == spec.type || sizeof(spec_fmt) - 1 <= spec.length)
+		{
+			hRes = E_INVALIDARG;
+			break;
+		}
+
+		int star[2] = { 0 };
+		for (uint32_t i = 0; i < spec.stars; ++i)
+		{
+			if (true != get_arg(arg, arg_end, &star[i], sizeof(int))) { hRes = E_INVALIDARG; }
+		}
+		if (S_OK != hRes) break;
+
+		switch (spec.type)
+		{
+		case log_arg_int32:
+		{
+			int32_t value;
+			hRes = (true == get_arg(arg, arg_end, &value, sizeof(value))) ?
+				format_arg(pos, remain, spec_fmt, spec.stars, star, value) : E_INVALIDARG;
+			break;
+		}
+		case log_arg_int64:
+		{
+			int64_t value;
+			hRes = (true == get_arg(arg, arg_end, &value, sizeof(value))) ?
+				format_arg(pos, remain, spec_fmt, spec.stars, star, value) : E_INVALIDARG;
+			break;
+		}
+		case log_arg_double:
+		{
+			double value;
+			hRes = (true == get_arg(arg, arg_end, &value, sizeof(value))) ?
+				format_arg(pos, remain, spec_fmt, spec.stars, star, value) : E_INVALIDARG;
+			break;
+		}
+		case log_arg_pointer:
+		{
+			uint64_t value;
+			hRes = (true == get_arg(arg, arg_end, &value, sizeof(value))) ?
+				format_arg(pos, remain, spec_fmt, spec.stars, star, (void*)(uintptr_t)value) : E_INVALIDARG;
+			break;
+		}
+		case log_arg_string:
+		{
+			uint32_t value_length;
+			if (true != get_arg(arg, arg_end, &value_length, sizeof(value_length)))
+			{
+				hRes = E_INVALIDARG;
+				break;
+			}
+			if (log_bin_null_string == value_length)
+			{
+				hRes = format_arg(pos, remain, spec_fmt, spec.stars, star, (const char*)nullptr);
+				break;
+			}
+
+			char value[_max_log_message_size];
+			if (value_length >= sizeof(value) ||
+				true != get_arg(arg, arg_end, value, value_length))
+			{
+				hRes = E_INVALIDARG;
+				break;
+			}
+			value[value_length] = '\0';
+			hRes = format_arg(pos, remain, spec_fmt, spec.stars, star, (const char*)value);
+			break;
+		}
+		case log_arg_wstring:
+		{
+			uint32_t value_length;
+			if (true != get_arg(arg, arg_end, &value_length, sizeof(value_length)))
+			{
+				hRes = E_INVALIDARG;
+				break;
+			}
+			if (log_bin_null_string == value_length)
+			{
+				hRes = format_arg(pos, remain, spec_fmt, spec.stars, star, (const wchar_t*)nullptr);
+				break;
+			}
+
+			wchar_t value[_max_log_message_size];
+			if (value_length >= _countof(value) ||
+				true != get_arg(arg, arg_end, value, value_length * sizeof(wchar_t)))
+			{
+				hRes = E_INVALIDARG;
+				break;
+			}
+			value[value_length] = L'\0';
+			hRes = format_arg(pos, remain, spec_fmt, spec.stars, star, (const wchar_t*)value);
+			break;
+		}
+		default:
+			hRes = E_INVALIDARG;
+			break;
+		}
+	}
+
+	if (S_OK != hRes)
+	{
+		// invalid character  ִ  ߻   
+		StringCbPrintfExA(pos,
+						  remain,
+						  &pos,
+						  &remain,
+						  0,
+						  "invalid function call parameters"
+		);
+	}
+	return (size_t)(pos - buffer);
+}
+
+/// @brief	`(pid:tid) : ` decoration ĳ (庰)
+typedef struct log_pid_tid_cache
+{
+	uint32_t	pid;
+	uint32_t	tid;
+	size_t		length;			///< 0 ̸ 
+	char		str[32];
+} *plog_pid_tid_cache;
+
+static thread_local log_pid_tid_cache _pid_tid_cache = {};
+
+/// @brief
+size_t
+log_format_decoration(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t flags,
+	_In_ uint32_t log_level,
+	_In_ uint64_t time,
+	_In_ uint32_t pid,
+	_In_ uint32_t tid,
+	_In_z_ const wchar_t* process_name,
+	_In_opt_z_ const char* function
+)
+{
+	size_t remain = size;
+	char* pos = buffer;
+
+	if (FlagOn(flags, log_deco_time))
+	{
+		//   ĳ (file_time_to_str() )
+		size_t length = file_time_to_str(time, true, false, pos, remain);
+		pos += length;
+		remain -= length;
+		StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", " ");
+	}
+
+	// log level
+	switch (log_level)
+	{
+	case log_level_debug: StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[DEBG] "); break;
+	case log_level_info:  StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[INFO] "); break;
+	case log_level_warn:  StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[WARN] "); break;
+	case log_level_error: StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s", "[EROR] "); break;
+	default:
+		_ASSERTE(!"never reach here!");
+		buffer[0] = '\0';
+		return 0;
+	}
+
+	//> show process name
+	if (FlagOn(flags, log_deco_process_name))
+	{
+		StringCbPrintfExA(pos,
+						  remain,
+						  &pos,
+						  &remain,
+						  0,
+						  "%ws",
+						  process_name
+		);
+	}
+
+	//> show pid, tid
+	//	pid, tid  ٲ  ٽ . (direct 忡 ׻ ڱ ڽ)
+	if (FlagOn(flags, log_deco_pid_tid))
+	{
+		plog_pid_tid_cache cache = &_pid_tid_cache;
+		if (0 == cache->length || pid != cache->pid || tid != cache->tid)
+		{
+			size_t cache_remain = sizeof(cache->str);
+			char* cache_end = cache->str;
+			StringCbPrintfExA(cache->str,
+							  sizeof(cache->str),
+							  &cache_end,
+							  &cache_remain,
+							  0,
+							  "(%+5u:%+5u) : ",
+							  pid,
+							  tid
+			);
+			cache->length = (size_t)(cache_end - cache->str);
+			cache->pid = pid;
+			cache->tid = tid;
+		}
+		StringCbCopyExA(pos, remain, cache->str, &pos, &remain, 0);
+	}
+
+	//> show function name
+	if (FlagOn(flags, log_deco_function_name) && nullptr != function)
+	{
+		StringCbPrintfExA(pos, remain, &pos, &remain, 0, "%s : ", function);
+	}
+
+	return (size_t)(pos - buffer);
+}
+
+/// @brief
+size_t
+log_format_deferred_record(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t flags,
+	_In_ uint32_t log_level,
+	_In_ uint64_t time,
+	_In_ uint32_t pid,
+	_In_ uint32_t tid,
+	_In_z_ const wchar_t* process_name,
+	_In_opt_z_ const char* function,
+	_In_z_ const char* fmt,
+	_In_reads_bytes_(length) const char* args,
+	_In_ size_t length
+)
+{
+	char* pos = buffer;
+	size_t remain = size;
+
+	if (FlagOn(flags, log_deco_level))
+	{
+		size_t deco_length = log_format_decoration(pos,
+												   remain,
+												   flags,
+												   log_level,
+												   time,
+												   pid,
+												   tid,
+												   process_name,
+												   function);
+		if (0 == deco_length) return 0;
+		pos += deco_length;
+		remain -= deco_length;
+	}
+
+	size_t msg_length = log_format_args(pos, remain, fmt, args, length);
+	pos += msg_length;
+	remain -= msg_length;
+
+	// line feed
+	StringCbPrintfExA(pos, remain, &pos, &remain, 0, "\n");
+	return (size_t)(pos - buffer);
+}
+
+/// @brief	binary α  (log_format_binary )  ؽƮ α Ϸ ȯѴ.
+bool
+decode_log_file(
+	_In_z_ const wchar_t* binary_log_path,
+	_In_z_ const wchar_t* text_log_path
+)
+{
+	_ASSERTE(nullptr != binary_log_path);
+	_ASSERTE(nullptr != text_log_path);
+	if (nullptr == binary_log_path || nullptr == text_log_path) return false;
+
+	//
+	// binary α  д´.
+	//
+	std::vector<char> data;
+	{
+		handle_ptr file(CreateFileW(binary_log_path,
+									GENERIC_READ,
+									FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+									NULL,
+									OPEN_EXISTING,
+									FILE_ATTRIBUTE_NORMAL,
+									NULL),
+						[](HANDLE file_handle) {
+			if (INVALID_HANDLE_VALUE != file_handle)
+			{
+				CloseHandle(file_handle);
+			}
+		});
+		if (INVALID_HANDLE_VALUE == file.get())
+		{
+			log_err "CreateFileW(%ws) failed, gle = %u",
+				binary_log_path,
+				GetLastError()
+				log_end;
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if (TRUE != GetFileSizeEx(file.get(), &file_size) ||
+			(uint64_t)file_size.QuadPart > (uint64_t)UINT32_MAX)
+		{
+			log_err "GetFileSizeEx(%ws) failed, gle = %u",
+				binary_log_path,
+				GetLastError()
+				log_end;
+			return false;
+		}
+
+		data.resize((size_t)file_size.QuadPart);
+		DWORD read = 0;
+		if (0 < data.size() &&
+			(TRUE != ReadFile(file.get(), &data[0], (DWORD)data.size(), &read, NULL) ||
+			 read != (DWORD)data.size()))
+		{
+			log_err "ReadFile(%ws) failed, gle = %u",
+				binary_log_path,
+				GetLastError()
+				log_end;
+			return false;
+		}
+	}
+
+	const char* pos = data.data();
+	const char* end = data.data() + data.size();
+
+	log_bin_header header;
+	if (true != get_arg(pos, end, &header, sizeof(header)) ||
+		0 != memcmp(header.magic, log_bin_magic, sizeof(header.magic)) ||
+		log_bin_version != header.version)
+	{
+		log_err "not a binary log file, %ws", binary_log_path log_end;
+		return false;
+	}
+
+	std::wstring process_name(header.name_length, L'\0');
+	if (0 < header.name_length &&
+		true != get_arg(pos, end, &process_name[0], header.name_length * sizeof(wchar_t)))
+	{
+		log_err "invalid binary log file, %ws", binary_log_path log_end;
+		return false;
+	}
+
+	//
+	// ؽƮ α Ϸ ȯѴ.
+	//
+	handle_ptr text_file(CreateFileW(text_log_path,
+									 GENERIC_WRITE,
+									 FILE_SHARE_READ,
+									 NULL,
+									 CREATE_ALWAYS,
+									 FILE_ATTRIBUTE_NORMAL,
+									 NULL),
+						 [](HANDLE file_handle) {
+		if (INVALID_HANDLE_VALUE != file_handle)
+		{
+			CloseHandle(file_handle);
+		}
+	});
+	if (INVALID_HANDLE_VALUE == text_file.get())
+	{
+		log_err "CreateFileW(%ws) failed, gle = %u",
+			text_log_path,
+			GetLastError()
+			log_end;
+		return false;
+	}
+
+	std::map<uint32_t, std::string> strings;
+	std::string text;
+	char msg[_max_log_message_size];
+	bool ret = true;
+	while (pos < end && true == ret)
+	{
+		switch ((uint8_t)*pos)
+		{
+		case log_bin_type_string:
+		{
+			log_bin_string_def def;
+			if (true != get_arg(pos, end, &def, sizeof(def)) ||
+				(size_t)(end - pos) < def.length)
+			{
+				ret = false;
+				break;
+			}
+			uint32_t id = def.id;		// packed ü    ʴ´.
+			strings[id].assign(pos, def.length);
+			pos += def.length;
+			break;
+		}
+		case log_bin_type_record:
+		{
+			log_bin_record record;
+			if (true != get_arg(pos, end, &record, sizeof(record)) ||
+				(size_t)(end - pos) < record.length)
+			{
+				ret = false;
+				break;
+			}
+
+			std::map<uint32_t, std::string>::const_iterator fmt = strings.find(record.fmt_id);
+			std::map<uint32_t, std::string>::const_iterator function = strings.find(record.function_id);
+			if (fmt == strings.end())
+			{
+				ret = false;
+				break;
+			}
+
+			text.append(msg, log_format_deferred_record(msg,
+												 sizeof(msg),
+												 record.flags,
+												 record.level,
+												 record.time,
+												 header.pid,
+												 record.tid,
+												 process_name.c_str(),
+												 (function == strings.end()) ? nullptr : function->second.c_str(),
+												 fmt->second.c_str(),
+												 pos,
+												 record.length));
+			pos += record.length;
+			break;
+		}
+		case log_bin_type_text:
+		{
+			log_bin_text record;
+			if (true != get_arg(pos, end, &record, sizeof(record)) ||
+				(size_t)(end - pos) < record.length)
+			{
+				ret = false;
+				break;
+			}
+			text.append(pos, record.length);
+			pos += record.length;
+			break;
+		}
+		default:
+			ret = false;
+			break;
+		}
+
+		if (true != ret)
+		{
+			log_err "invalid binary log file, %ws, offset = %llu",
+				binary_log_path,
+				(uint64_t)(pos - data.data())
+				log_end;
+		}
+
+		//
+		// ȯ α׸ Ƽ .
+		//
+		if (text.size() >= _log_batch_size_def || pos >= end || true != ret)
+		{
+			DWORD written = 0;
+			if (0 < text.size() &&
+				TRUE != WriteFile(text_file.get(), text.data(), (DWORD)text.size(), &written, NULL))
+			{
+				log_err "WriteFile(%ws) failed, gle = %u",
+					text_log_path,
+					GetLastError()
+					log_end;
+				return false;
+			}
+			text.clear();
+		}
+	}
+
+	return ret;
+}
+
+
+/*****************************************************************************/
+/*					structured log (JSON lines) encoder						 */
+/*****************************************************************************/
+
+/// @brief	buffer    writer
+///			buffer  ϸ full  ǰ,    õȴ. 
+///			end  JSON  ݱ   (`"}\n` + NULL)  ܵ ġ̴.
+typedef struct log_writer
+{
+	char*	pos;
+	char*	end;
+	bool	full;
+
+	log_writer(_In_ char* buffer, _In_ size_t size, _In_ size_t reserved) :
+		pos(buffer), end(buffer + ((size > reserved) ? size - reserved : 0)), full(size <= reserved)
+	{
+	}
+
+	bool put(_In_ char c)
+	{
+		if (true == full || pos >= end) { full = true; return false; }
+		*pos++ = c;
+		return true;
+	}
+
+	bool put(_In_reads_(length) const char* str, _In_ size_t length)
+	{
+		if (true == full || length > (size_t)(end - pos)) { full = true; return false; }
+		memcpy(pos, str, length);
+		pos += length;
+		return true;
+	}
+
+	bool put(_In_z_ const char* str)
+	{
+		return put(str, strlen(str));
+	}
+
+	bool put_uint(_In_ uint64_t value, _In_ uint32_t min_digits = 1)
+	{
+		char digits[24];
+		char* p = digits + sizeof(digits);
+		do
+		{
+			*--p = (char)('0' + (value % 10));
+			value /= 10;
+		} while (0 != value || (uint32_t)(digits + sizeof(digits) - p) < min_digits);
+		return put(p, (size_t)(digits + sizeof(digits) - p));
+	}
+
+	bool put_int(_In_ int64_t value)
+	{
+		if (value < 0)
+		{
+			if (true != put('-')) return false;
+			return put_uint((uint64_t)0 - (uint64_t)value);
+		}
+		return put_uint((uint64_t)value);
+	}
+} *plog_writer;
+
+/// @brief	JSON string  escape ؾ ϴ ڸ . 
+///			escape  ʿ䰡  false  Ѵ.
+static bool put_json_escape(_Inout_ log_writer& writer, _In_ uint32_t c, _Out_ bool& written)
+{
+	static const char hex[] = "0123456789abcdef";
+	const char* escape = nullptr;
+	switch (c)
+	{
+	case '"':  escape = "\\\""; break;
+	case '\\': escape = "\\\\"; break;
+	case '\n': escape = "\\n"; break;
+	case '\r': escape = "\\r"; break;
+	case '\t': escape = "\\t"; break;
+	default:
+		if (c >= 0x20) return false;
+		{
+			char u[6] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xf], hex[c & 0xf] };
+			written = writer.put(u, sizeof(u));
+			return true;
+		}
+	}
+	written = writer.put(escape, 2);
+	return true;
+}
+
+/// @brief	 (unicode code point) ϳ escape ϰų UTF-8  .
+static bool put_json_codepoint(_Inout_ log_writer& writer, _In_ uint32_t c)
+{
+	bool written = false;
+	if (true == put_json_escape(writer, c, written)) return written;
+
+	char utf8[4];
+	size_t length = 0;
+	if (c < 0x80)
+	{
+		utf8[length++] = (char)c;
+	}
+	else if (c < 0x800)
+	{
+		utf8[length++] = (char)(0xc0 | (c >> 6));
+		utf8[length++] = (char)(0x80 | (c & 0x3f));
+	}
+	else if (c < 0x10000)
+	{
+		utf8[length++] = (char)(0xe0 | (c >> 12));
+		utf8[length++] = (char)(0x80 | ((c >> 6) & 0x3f));
+		utf8[length++] = (char)(0x80 | (c & 0x3f));
+	}
+	else
+	{
+		utf8[length++] = (char)(0xf0 | (c >> 18));
+		utf8[length++] = (char)(0x80 | ((c >> 12) & 0x3f));
+		utf8[length++] = (char)(0x80 | ((c >> 6) & 0x3f));
+		utf8[length++] = (char)(0x80 | (c & 0x3f));
+	}
+	return writer.put(utf8, length);
+}
+
+/// @brief	UTF-16 ڿ UTF-8  ȯϰ escape ؼ . (ǥ )
+///			  Ƿ buffer  ص UTF-8 ڰ ߰ ߸ ʴ´.
+static bool put_json_wchars(_Inout_ log_writer& writer, _In_reads_(length) const wchar_t* str, _In_ size_t length)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		uint32_t c = (uint16_t)str[i];
+		if (c >= 0xd800 && c <= 0xdbff && i + 1 < length && str[i + 1] >= 0xdc00 && str[i + 1] <= 0xdfff)
+		{
+			c = 0x10000 + ((c - 0xd800) << 10) + ((uint16_t)str[i + 1] - 0xdc00);
+			++i;
+		}
+		else if (c >= 0xd800 && c <= 0xdfff)
+		{
+			c = 0xfffd;		// ¦  ʴ surrogate
+		}
+
+		if (true != put_json_codepoint(writer, c)) return false;
+	}
+	return true;
+}
+
+static bool put_json_wchars(_Inout_ log_writer& writer, _In_z_ const wchar_t* str)
+{
+	return put_json_wchars(writer, str, wcslen(str));
+}
+
+/// @brief	ANSI code page ڿ  0x80 ̻ ڷ  κ UTF-8  .
+///			DBCS (CP949 )  ι° Ʈ 0x80 ̸  Ƿ 
+///			lead byte     ڸ. 
+///			ȯ Ʈ  consumed  Ѵ.
+static bool 
+put_json_ansi_chars(
+	_Inout_ log_writer& writer, 
+	_In_reads_(length) const char* str, 
+	_In_ size_t length,
+	_Out_ size_t& consumed
+	)
+{
+	wchar_t wide[128];
+	consumed = 0;
+	while (consumed < length && 0x80 <= (uint8_t)str[consumed])
+	{
+		// ѹ _countof(wide) Ʈ ,  迡 ڸ.
+		size_t chunk = 0;
+		while (consumed + chunk < length && 
+			   0x80 <= (uint8_t)str[consumed + chunk] &&
+			   chunk + 2 <= _countof(wide))
+		{
+			if (TRUE == IsDBCSLeadByte((BYTE)str[consumed + chunk]) && consumed + chunk + 1 < length)
+			{
+				chunk += 2;
+			}
+			else
+			{
+				chunk += 1;
+			}
+		}
+
+		int count = MultiByteToWideChar(CP_ACP, 
+										0, 
+										&str[consumed], 
+										(int)chunk, 
+										wide, 
+										_countof(wide));
+		if (0 >= count)
+		{
+			// ȯ   U+FFFD  .
+			wide[0] = 0xfffd;
+			count = 1;
+		}
+
+		if (true != put_json_wchars(writer, wide, (size_t)count)) return false;
+		consumed += chunk;
+	}
+	return true;
+}
+
+/// @brief	ANSI code page ڿ UTF-8  ȯϰ escape ؼ . (ǥ )
+///			ASCII  ״ ϰ, 0x80 ̻ ڸ ȯѴ. 
+///			buffer  ϸ   ִ ŭ  false  Ѵ.
+static bool put_json_chars(_Inout_ log_writer& writer, _In_reads_(length) const char* str, _In_ size_t length)
+{
+	const char* run = str;
+	size_t i = 0;
+	while (i < length)
+	{
+		uint32_t c = (uint8_t)str[i];
+		if (c < 0x80 && c >= 0x20 && '"' != c && '\\' != c)
+		{
+			++i;
+			continue;
+		}
+
+		if (true != writer.put(run, (size_t)(str + i - run)))
+		{
+			writer.full = false;
+			writer.put(run, (size_t)(writer.end - writer.pos));
+			writer.full = true;
+			return false;
+		}
+
+		if (c >= 0x80)
+		{
+			size_t consumed = 0;
+			if (true != put_json_ansi_chars(writer, &str[i], length - i, consumed)) return false;
+			i += consumed;
+		}
+		else
+		{
+			bool written = false;
+			put_json_escape(writer, c, written);
+			if (true != written) return false;
+			++i;
+		}
+		run = str + i;
+	}
+
+	if (true != writer.put(run, (size_t)(str + length - run)))
+	{
+		writer.full = false;
+		writer.put(run, (size_t)(writer.end - writer.pos));
+		writer.full = true;
+		return false;
+	}
+	return true;
+}
+
+/// @brief	FILETIME (UTC)  ISO 8601 (2026-10-17T01:02:03.456Z) · . 
+static bool put_iso8601(_Inout_ log_writer& writer, _In_ uint64_t time)
+{
+	// 1601-01-01  100ns  -> 1970-01-01  msec
+	const uint64_t epoch_diff = 116444736000000000ull;
+	int64_t msec = (time >= epoch_diff) ? (int64_t)((time - epoch_diff) / 10000) : 0;
+	int64_t days = msec / 86400000;
+	uint32_t msec_of_day = (uint32_t)(msec % 86400000);
+
+	// civil from days (proleptic gregorian)
+	int64_t z = days + 719468;
+	int64_t era = z / 146097;
+	uint32_t doe = (uint32_t)(z - era * 146097);
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp = (5 * doy + 2) / 153;
+	uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+	uint32_t month = (mp < 10) ? mp + 3 : mp - 9;
+	uint64_t year = (uint64_t)(yoe + era * 400) + ((month <= 2) ? 1 : 0);
+
+	return writer.put_uint(year, 4) && writer.put('-') &&
+		   writer.put_uint(month, 2) && writer.put('-') &&
+		   writer.put_uint(day, 2) && writer.put('T') &&
+		   writer.put_uint(msec_of_day / 3600000, 2) && writer.put(':') &&
+		   writer.put_uint((msec_of_day / 60000) % 60, 2) && writer.put(':') &&
+		   writer.put_uint((msec_of_day / 1000) % 60, 2) && writer.put('.') &&
+		   writer.put_uint(msec_of_day % 1000, 3) && writer.put('Z');
+}
+
+/// @brief	field   . json  true ̸ ڿ JSON string  .
+static bool put_field_value(_Inout_ log_writer& writer, _In_ const log_field& field, _In_ bool json)
+{
+	switch (field.type)
+	{
+	case log_field::type_int:
+		return writer.put_int(field.int_value);
+	case log_field::type_uint:
+		return writer.put_uint(field.uint_value);
+	case log_field::type_bool:
+		return writer.put((true == field.bool_value) ? "true" : "false");
+	case log_field::type_double:
+	{
+		// NaN, inf  JSON  ǥ  .
+		if (field.double_value != field.double_value ||
+			field.double_value - field.double_value != 0.0)
+		{
+			return writer.put("null");
+		}
+
+		char number[32];
+		size_t remain = sizeof(number);
+		char* end = number;
+		StringCbPrintfExA(number, sizeof(number), &end, &remain, 0, "%.17g", field.double_value);
+		return writer.put(number, (size_t)(end - number));
+	}
+	case log_field::type_str:
+		if (nullptr == field.str_value) return writer.put("null");
+		if (true != json) return writer.put(field.str_value);
+		return writer.put('"') &&
+			   put_json_chars(writer, field.str_value, strlen(field.str_value)) &&
+			   writer.put('"');
+	case log_field::type_wstr:
+		if (nullptr == field.wstr_value) return writer.put("null");
+		// ؽƮ 忡 UTF-8  .
+		if (true != json) return put_json_wchars(writer, field.wstr_value);
+		return writer.put('"') &&
+			   put_json_wchars(writer, field.wstr_value) &&
+			   writer.put('"');
+	}
+	return false;
+}
+
+/// @brief	
+size_t
+log_format_fields(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_reads_(field_count) const log_field* fields,
+	_In_ size_t field_count
+)
+{
+	_ASSERTE(nullptr != buffer);
+	if (nullptr == buffer || 0 == size) return 0;
+
+	log_writer writer(buffer, size, 1);
+	for (size_t i = 0; i < field_count; ++i)
+	{
+		char* field_begin = writer.pos;
+		if (true != writer.put(' ') ||
+			true != writer.put(fields[i].key) ||
+			true != writer.put('=') ||
+			true != put_field_value(writer, fields[i], false))
+		{
+			writer.pos = field_begin;
+			break;
+		}
+	}
+	*writer.pos = '\0';
+	return (size_t)(writer.pos - buffer);
+}
+
+/// @brief	
+size_t
+log_format_json_record(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t log_level,
+	_In_ uint64_t time,
+	_In_ uint32_t pid,
+	_In_ uint32_t tid,
+	_In_opt_z_ const wchar_t* process_name,
+	_In_opt_z_ const char* function,
+	_In_reads_(msg_length) const char* msg,
+	_In_ size_t msg_length,
+	_In_reads_opt_(field_count) const log_field* fields,
+	_In_ size_t field_count
+)
+{
+	_ASSERTE(nullptr != buffer);
+	_ASSERTE(nullptr != msg);
+	if (nullptr == buffer || nullptr == msg) return 0;
+
+	const char* level = nullptr;
+	switch (log_level)
+	{
+	case log_level_debug: level = "debug"; break;
+	case log_level_info:  level = "info"; break;
+	case log_level_warn:  level = "warn"; break;
+	case log_level_error: level = "error"; break;
+	default:
+		_ASSERTE(!"never reach here!");
+		if (0 < size) buffer[0] = '\0';
+		return 0;
+	}
+
+	// `"` (msg  ߸ ), `}`, `\n`, NULL  ܵд.
+	const size_t reserved = 4;
+	log_writer writer(buffer, size, reserved);
+	if (true == writer.full) 
+	{
+		if (0 < size) buffer[0] = '\0';
+		return 0;
+	}
+
+	bool ret = writer.put("{\"time\":\"") &&
+			   put_iso8601(writer, time) &&
+			   writer.put("\",\"level\":\"") &&
+			   writer.put(level) &&
+			   writer.put("\",\"pid\":") &&
+			   writer.put_uint(pid) &&
+			   writer.put(",\"tid\":") &&
+			   writer.put_uint(tid);
+	if (true == ret && nullptr != process_name)
+	{
+		ret = writer.put(",\"process\":\"") &&
+			  put_json_wchars(writer, process_name) &&
+			  writer.put('"');
+	}
+	if (true == ret && nullptr != function)
+	{
+		ret = writer.put(",\"function\":\"") &&
+			  put_json_chars(writer, function, strlen(function)) &&
+			  writer.put('"');
+	}
+
+	if (true != ret || true != writer.put(",\"msg\":\""))
+	{
+		// buffer  ʹ ۴.
+		buffer[0] = '\0';
+		return 0;
+	}
+
+	//
+	// msg  buffer  ϸ ߶ . 
+	// escape sequence  ѹ Ƿ ߰ ߸ ʴ´.
+	// 
+	put_json_chars(writer, msg, msg_length);
+
+	// reserved  .
+	*writer.pos++ = '"';
+	writer.end += 1;
+
+	for (size_t i = 0; i < field_count && true != writer.full; ++i)
+	{
+		char* field_begin = writer.pos;
+		if (true != writer.put(",\"") ||
+			true != put_json_chars(writer, fields[i].key, strlen(fields[i].key)) ||
+			true != writer.put("\":") ||
+			true != put_field_value(writer, fields[i], true))
+		{
+			writer.pos = field_begin;
+			break;
+		}
+	}
+
+	*writer.pos++ = '}';
+	*writer.pos++ = '\n';
+	*writer.pos = '\0';
+	return (size_t)(writer.pos - buffer);
+}
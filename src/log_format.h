@@ -0,0 +1,171 @@
+/**
+ * @file    log_format.h
+ * @brief   log record 
+ *
+ *			- log decoration (ð, level, μ, pid/tid, Լ)
+ *			- deferred  printf  ĸ/
+ *			- binary α  ̾ƿ (decode_log_file() )
+ *
+ *			deferred 忡 α׸   format string Ϳ
+ *			ڸ record  ϰ,  logger thread  Ѵ.
+ *			%s, %ws ڴ ڿ  , format string 
+ *			͸ ϹǷ ݵ ڿ  Ѵ. (log_err 
+ *			ũδ ׻ ڿ  Ѵ)
+ * @ref
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026/10/17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+
+#ifndef _log_format_h_
+#define _log_format_h_
+
+#include <cstdint>
+#include <cstdarg>
+
+/// @brief	binary α 
+///
+///			log_bin_header, μ (wchar_t[name_length])
+///			 log_bin_string_def, log_bin_record, log_bin_text  ݺȴ.
+///			format string, Լ Ͽ ó   ѹ
+///			log_bin_string_def  ϵǰ, Ŀ id  ȴ.
+#define log_bin_magic			"MYLIBLOG"
+#define log_bin_version			1
+
+#define log_bin_type_string		1
+#define log_bin_type_record		2
+#define log_bin_type_text		3
+
+/// @brief	%s ڰ NULL    
+#define log_bin_null_string		0xffffffff
+
+#pragma pack(push, 1)
+typedef struct log_bin_header
+{
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	pid;
+	uint32_t	name_length;	///< μ (wchar_t )
+} *plog_bin_header;
+
+typedef struct log_bin_string_def
+{
+	uint8_t		type;			///< log_bin_type_string
+	uint32_t	id;
+	uint32_t	length;			///< ڿ (NULL )
+} *plog_bin_string_def;
+
+typedef struct log_bin_record
+{
+	uint8_t		type;			///< log_bin_type_record
+	uint8_t		level;
+	uint16_t	flags;			///< log_deco_xxx
+	uint32_t	tid;
+	uint64_t	time;			///< FILETIME (UTC)
+	uint32_t	fmt_id;
+	uint32_t	function_id;	///< 0 ̸ 
+	uint32_t	length;			///<  ũ
+} *plog_bin_record;
+
+typedef struct log_bin_text
+{
+	uint8_t		type;			///< log_bin_type_text
+	uint8_t		level;
+	uint32_t	length;			///<   α (NULL )
+} *plog_bin_text;
+#pragma pack(pop)
+
+
+/// @brief	decoration  buffer  ϰ,  (NULL )  Ѵ.
+///			log level  ߸  0  Ѵ.
+size_t
+log_format_decoration(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t flags,
+	_In_ uint32_t log_level,
+	_In_ uint64_t time,
+	_In_ uint32_t pid,
+	_In_ uint32_t tid,
+	_In_z_ const wchar_t* process_name,
+	_In_opt_z_ const char* function
+	);
+
+/// @brief	fmt   args  buffer  binary  Ѵ.
+///			 ʴ conversion (%n )  ְų buffer  ϸ
+///			false  Ѵ. (  ٷ ؾ Ѵ)
+bool
+log_pack_args(
+	_Out_writes_bytes_(size) char* buffer,
+	_In_ size_t size,
+	_In_z_ const char* fmt,
+	_In_ va_list args,
+	_Out_ uint32_t& length
+	);
+
+/// @brief	log_pack_args()   ڸ fmt   ϰ,
+///			 (NULL )  Ѵ.
+size_t
+log_format_args(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_z_ const char* fmt,
+	_In_reads_bytes_(length) const char* args,
+	_In_ size_t length
+	);
+
+/// @brief	deferred record  `decoration + ޼ + line feed`  ϰ,
+///			 (NULL )  Ѵ.
+size_t
+log_format_deferred_record(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t flags,
+	_In_ uint32_t log_level,
+	_In_ uint64_t time,
+	_In_ uint32_t pid,
+	_In_ uint32_t tid,
+	_In_z_ const wchar_t* process_name,
+	_In_opt_z_ const char* function,
+	_In_z_ const char* fmt,
+	_In_reads_bytes_(length) const char* args,
+	_In_ size_t length
+	);
+
+/// @brief	log_field  ` key=value` · buffer  ,  (NULL )  
+///			Ѵ. 
+size_t
+log_format_fields(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_reads_(field_count) const struct log_field* fields,
+	_In_ size_t field_count
+	);
+
+/// @brief	α   JSON object  line feed  buffer  , 
+///			 (NULL )  Ѵ. log level  ߸  0  Ѵ.
+///
+///			{"time":"2026-10-17T01:02:03.456Z","level":"info","pid":1,"tid":2,
+///			 "process":"a.exe","function":"f","msg":"...","key":value,...}
+///
+///			msg  char ʵ ANSI code page ڿ  UTF-8  ȯѴ. 
+///
+///			buffer  ϸ msg  ߸,  ʵ  ׻ 
+///			ùٸ JSON  . 
+size_t
+log_format_json_record(
+	_Out_writes_z_(size) char* buffer,
+	_In_ size_t size,
+	_In_ uint32_t log_level,
+	_In_ uint64_t time,
+	_In_ uint32_t pid,
+	_In_ uint32_t tid,
+	_In_opt_z_ const wchar_t* process_name,
+	_In_opt_z_ const char* function,
+	_In_reads_(msg_length) const char* msg,
+	_In_ size_t msg_length,
+	_In_reads_opt_(field_count) const struct log_field* fields,
+	_In_ size_t field_count
+	);
+
+#endif//_log_format_h_
@@ -52,27 +52,36 @@
 #ifndef ___MD5_H___
 #define ___MD5_H___
 
-/* Typedef a 32 bit type */
-#ifndef UINT4
-typedef unsigned long int UINT4;
-#endif
+#include <stddef.h>
+#include <stdint.h>
 
 /* Data structure for MD5 (Message Digest) computation */
+/* The state is fixed at 32 bits, `unsigned long` is 64 bits on LP64 */
 typedef struct {
-	UINT4 i[2];                   /* Number of _bits_ handled mod 2^64 */
-	UINT4 buf[4];                                    /* Scratch buffer */
+	uint32_t i[2];                /* Number of _bits_ handled mod 2^64 */
+	uint32_t buf[4];                                 /* Scratch buffer */
 	unsigned char in[64];                              /* Input buffer */
 	unsigned char digest[16];     /* Actual digest after MD5Final call */
 } MD5_CTX;
 
+#define MD5_BLOCK_SIZE  64
+#define MD5_DIGEST_SIZE 16
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
 void MD5Init(MD5_CTX *mdContext, unsigned long pseudoRandomNumber);
-void MD5Update(MD5_CTX *mdContext, unsigned char *inBuf, unsigned int inLen);
+void MD5Update(MD5_CTX *mdContext, const unsigned char *inBuf, unsigned int inLen);
 void MD5Final(MD5_CTX *mdContext);
 
+/* Process `blocks` whole 64 byte blocks of `data` into `state` (a, b, c, d) */
+/* without copying them into MD5_CTX.in, no padding is added               */
+void MD5Blocks(uint32_t state[4], const unsigned char *data, size_t blocks);
+
+/* One shot MD5 of `len` bytes of `data` */
+void MD5Hash(unsigned char digest[MD5_DIGEST_SIZE], const unsigned char *data, size_t len);
+
 #if defined(__cplusplus)
 }
 #endif
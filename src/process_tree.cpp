@@ -11,6 +11,34 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include "process_tree.h"
+#include "constexpr_hash.h"
+
+/// @brief	known_process_type  μ ̸
+static constexpr const wchar_t* _known_process_names[] = {
+	_idle_proc_,
+	_system_proc_,
+	L"smss.exe",
+	L"csrss.exe",
+	L"wininit.exe",
+	L"winlogon.exe",
+	L"services.exe",
+	L"lsass.exe",
+	L"svchost.exe",
+	_explorer_proc_
+};
+static_assert((size_t)known_process_max == _countof(_known_process_names), "known_process_type mismatch");
+
+static constexpr const_string_table<wchar_t, _countof(_known_process_names), true>
+	_known_processes(_known_process_names);
+
+/// @brief	process_name   ˷ μ ̸̸  Ÿ Ѵ.
+known_process_type get_known_process_type(_In_ const wchar_t* process_name)
+{
+	_ASSERTE(nullptr != process_name);
+	if (nullptr == process_name) return known_process_unknown;
+
+	return (known_process_type)_known_processes.find(process_name);
+}
 
 /**
  * @brief	
@@ -254,6 +282,23 @@ DWORD cprocess_tree::find_process(_In_ const wchar_t* process_name)
 	return 0;
 }
 
+/// @brief	type μ  ó ã μ pid,  0
+///			̸  add_process()  ص known_type()  Ѵ.
+DWORD cprocess_tree::find_process(_In_ known_process_type type)
+{
+	_ASSERTE(known_process_unknown != type);
+	if (known_process_unknown == type) return 0;
+
+	for (const auto& entry : _proc_map)
+	{
+		if (type == entry.second.known_type())
+		{
+			return entry.second.pid();
+		}
+	}
+	return 0;
+}
+
 const process* cprocess_tree::get_process(_In_ DWORD pid)
 {
 	auto p = _proc_map.find(pid);
@@ -25,10 +25,33 @@
 #define _system_proc_pid 4
 #define _explorer_proc_ L"explorer.exe"
 
-#define _idle_proc_		L"System Idle Process";
+#define _idle_proc_		L"System Idle Process"
 #define _idle_proc_pid	0
 #endif
 
+/// @brief	 ˷ μ, get_known_process_type() 
+typedef enum _known_process_type
+{
+	known_process_unknown = -1,
+	known_process_idle = 0,
+	known_process_system,
+	known_process_smss,
+	known_process_csrss,
+	known_process_wininit,
+	known_process_winlogon,
+	known_process_services,
+	known_process_lsass,
+	known_process_svchost,
+	known_process_explorer,
+	known_process_max
+} known_process_type;
+
+/// @brief	process_name   ˷ μ ̸̸  Ÿ, ƴϸ 
+///			known_process_unknown  Ѵ. (ҹ  )
+///			 Ÿӿ  perfect hash table  ϹǷ ؽ ѹ
+///			ڿ  ѹ .
+known_process_type get_known_process_type(_In_ const wchar_t* process_name);
+
 /**
  * @brief	class for running process
 **/
@@ -43,7 +66,8 @@ public:
 		_creation_time(0), 
 		_is_wow64(false),
 		_full_path(L""), 
-		_killed(false)
+		_killed(false),
+		_known_type(known_process_unknown)
 	{
 	}
 
@@ -61,7 +85,8 @@ public:
 		_creation_time(creation_time), 
 		_is_wow64(is_wow64),
 		_full_path(full_path), 
-		_killed(killed)
+		_killed(killed),
+		_known_type(get_known_process_type(process_name))
 	{
 	}
 
@@ -76,6 +101,7 @@ public:
 	uint64_t		creation_time() const { return _creation_time; }
 	bool			is_wow64() const { return _is_wow64; }
 	bool			killed() { return _killed; }
+	known_process_type known_type() const { return _known_type; }
 
 private:
 	std::wstring	_process_name;
@@ -85,6 +111,7 @@ private:
 	bool			_is_wow64;
     std::wstring    _full_path;
 	bool			_killed;
+	known_process_type _known_type;
 } *pprocess;
 
 /**
@@ -102,6 +129,7 @@ public:
 	bool build_process_tree(_In_ bool enable_debug_priv);
 
 	DWORD find_process(_In_ const wchar_t* process_name);
+	DWORD find_process(_In_ known_process_type type);
 
 	const process* get_process(_In_ DWORD pid);
 	const wchar_t*get_process_name(_In_ DWORD pid);
@@ -0,0 +1,551 @@
+/**
+ * @file    ring_queue.h
+ * @brief   Bounded lock-free ring queues.
+ *
+ * ring_queue<T>             multi producer / multi consumer
+ * ring_queue<T, ring_spsc>  single producer / single consumer
+ *
+ * Unlike Queue<T> (Queue.h) these are safe to share between threads without
+ * an external lock, never allocate after construction, and move elements in
+ * and out, so move-only types work. The capacity is rounded up to a power of
+ * two. try_push()/try_pop() never block. If the queue is constructed with
+ * `blocking` set, push()/pop() and the timed variants park the caller on a
+ * condition variable until the queue has room or an element; otherwise the
+ * hot path does not pay for the wakeup check.
+ *
+ * The MPMC variant is D. Vyukov's bounded queue: every cell carries a
+ * sequence number which tells producers and consumers whether the cell is
+ * free or full for the current lap, so a single CAS on the head or tail
+ * claims a cell (or a run of cells for push_n()/pop_n()).
+ *
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026:10:17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <atomic>
+#include <type_traits>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+
+#define RING_QUEUE_CACHE_LINE   64
+
+enum ring_queue_mode
+{
+    ring_mpmc,
+    ring_spsc
+};
+
+namespace ring_queue_detail
+{
+    inline std::size_t round_up_pow2(std::size_t n)
+    {
+        std::size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    /// @brief  Parks threads until the other side makes progress.
+    ///
+    ///         `ready` (a try_push()/try_pop()) runs without the lock held,
+    ///         since it notifies the opposite waiter. A wakeup is never
+    ///         lost: the notifier bumps `_epoch` after changing the queue and
+    ///         then looks for waiters, the waiter reads `_epoch` before
+    ///         trying and counts itself in before re-reading `_epoch`.
+    class waiter : private boost::noncopyable
+    {
+    public:
+        waiter() : _epoch(0), _waiters(0) {}
+
+        /// @brief  `deadline` null means wait forever.
+        template < typename Ready >
+        bool wait(Ready ready, const boost::chrono::steady_clock::time_point* deadline)
+        {
+            for (;;)
+            {
+                std::size_t epoch = _epoch.load();
+                if (true == ready()) return true;
+
+                boost::unique_lock< boost::mutex > lock(_lock);
+                ++_waiters;
+                while (epoch == _epoch.load())
+                {
+                    if (nullptr == deadline)
+                    {
+                        _condition.wait(lock);
+                    }
+                    else if (boost::cv_status::timeout == _condition.wait_until(lock, *deadline))
+                    {
+                        --_waiters;
+                        lock.unlock();
+                        return ready();
+                    }
+                }
+                --_waiters;
+            }
+        }
+
+        void notify()
+        {
+            ++_epoch;
+            if (0 < _waiters.load())
+            {
+                boost::lock_guard< boost::mutex > lock(_lock);
+                _condition.notify_all();
+            }
+        }
+
+    private:
+        std::atomic< std::size_t >  _epoch;
+        std::atomic< std::size_t >  _waiters;
+        boost::mutex                _lock;
+        boost::condition_variable   _condition;
+    };
+
+    /// @brief  Blocking push()/pop() shared by both queue modes.
+    template < typename Queue, typename T >
+    class blocking_ops
+    {
+    public:
+        /// @brief  Wait until there is room, return false if the queue was
+        ///         not constructed as blocking.
+        bool push(T&& value)
+        {
+            return push_until(std::move(value), nullptr);
+        }
+
+        bool push_for(T&& value, uint32_t timeout_ms)
+        {
+            boost::chrono::steady_clock::time_point deadline =
+                boost::chrono::steady_clock::now() + boost::chrono::milliseconds(timeout_ms);
+            return push_until(std::move(value), &deadline);
+        }
+
+        /// @brief  Wait until an element is available, return false if the
+        ///         queue was not constructed as blocking.
+        bool pop(T& value)
+        {
+            return pop_until(value, nullptr);
+        }
+
+        bool pop_for(T& value, uint32_t timeout_ms)
+        {
+            boost::chrono::steady_clock::time_point deadline =
+                boost::chrono::steady_clock::now() + boost::chrono::milliseconds(timeout_ms);
+            return pop_until(value, &deadline);
+        }
+
+    private:
+        Queue& self() { return static_cast< Queue& >(*this); }
+
+        bool push_until(T&& value, const boost::chrono::steady_clock::time_point* deadline)
+        {
+            Queue& q = self();
+            if (true == q.try_push(std::move(value))) return true;
+            if (true != q._blocking) return false;
+
+            // try_push() leaves `value` untouched when it fails.
+            return q._not_full.wait([&]() { return q.try_push(std::move(value)); }, deadline);
+        }
+
+        bool pop_until(T& value, const boost::chrono::steady_clock::time_point* deadline)
+        {
+            Queue& q = self();
+            if (true == q.try_pop(value)) return true;
+            if (true != q._blocking) return false;
+
+            return q._not_empty.wait([&]() { return q.try_pop(value); }, deadline);
+        }
+    };
+} // namespace ring_queue_detail
+
+/// @brief  Bounded MPMC queue.
+/// @see    test_ring_queue()
+template < typename T, ring_queue_mode mode = ring_mpmc >
+class ring_queue
+    : private boost::noncopyable,
+      public ring_queue_detail::blocking_ops< ring_queue< T, mode >, T >
+{
+    friend class ring_queue_detail::blocking_ops< ring_queue< T, mode >, T >;
+
+public:
+    explicit ring_queue(std::size_t capacity, bool blocking = false)
+        :
+        _blocking(blocking),
+        _mask(ring_queue_detail::round_up_pow2(capacity) - 1),
+        _cells(new cell[_mask + 1]),
+        _tail(0),
+        _head(0)
+    {
+        for (std::size_t i = 0; i <= _mask; ++i)
+        {
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~ring_queue()
+    {
+        std::size_t tail = _tail.load();
+        for (std::size_t pos = _head.load(); pos != tail; ++pos)
+        {
+            cell& c = _cells[pos & _mask];
+            if (c.seq.load() == pos + 1)
+            {
+                reinterpret_cast< T* >(&c.storage)->~T();
+            }
+        }
+        delete[] _cells;
+    }
+
+    std::size_t capacity() const { return _mask + 1; }
+
+    /// @brief  Approximate while other threads are working on the queue.
+    std::size_t size() const
+    {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        return (tail > head) ? tail - head : 0;
+    }
+
+    bool empty() const { return 0 == size(); }
+
+    /// @brief  Returns false if full. `value` is moved from only on success.
+    bool try_push(T&& value)
+    {
+        std::size_t pos;
+        if (0 == claim_push(1, pos)) return false;
+
+        cell& c = _cells[pos & _mask];
+        new (&c.storage) T(std::move(value));
+        c.seq.store(pos + 1, std::memory_order_release);
+
+        if (true == _blocking) _not_empty.notify();
+        return true;
+    }
+
+    bool try_push(const T& value)
+    {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+
+    /// @brief  Returns false if empty.
+    bool try_pop(T& value)
+    {
+        std::size_t pos;
+        if (0 == claim_pop(1, pos)) return false;
+
+        release(pos, value);
+        if (true == _blocking) _not_full.notify();
+        return true;
+    }
+
+    /// @brief  Push up to `count` elements from `values` with a single
+    ///         claim, returns how many were pushed (moved from).
+    std::size_t push_n(T* values, std::size_t count)
+    {
+        std::size_t pos;
+        std::size_t n = claim_push(count, pos);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            cell& c = _cells[(pos + i) & _mask];
+            new (&c.storage) T(std::move(values[i]));
+            c.seq.store(pos + i + 1, std::memory_order_release);
+        }
+
+        if (0 < n && true == _blocking) _not_empty.notify();
+        return n;
+    }
+
+    /// @brief  Pop up to `count` elements into `values` with a single claim,
+    ///         returns how many were popped.
+    std::size_t pop_n(T* values, std::size_t count)
+    {
+        std::size_t pos;
+        std::size_t n = claim_pop(count, pos);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            release(pos + i, values[i]);
+        }
+
+        if (0 < n && true == _blocking) _not_full.notify();
+        return n;
+    }
+
+private:
+    typedef typename std::aligned_storage< sizeof(T), alignof(T) >::type storage_type;
+
+    struct cell
+    {
+        // pos     : free for the producer of `pos`
+        // pos + 1 : holds the element of `pos`
+        std::atomic< std::size_t >  seq;
+        storage_type                storage;
+    };
+
+    /// @brief  Claim the run of free cells starting at the tail, up to
+    ///         `count`. Free cells stay free until claimed, so counting them
+    ///         first and then moving the tail with one CAS is safe.
+    std::size_t claim_push(std::size_t count, std::size_t& pos)
+    {
+        pos = _tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            std::size_t n = 0;
+            while (n < count &&
+                   _cells[(pos + n) & _mask].seq.load(std::memory_order_acquire) == pos + n)
+            {
+                ++n;
+            }
+
+            if (0 == n)
+            {
+                std::size_t seq = _cells[pos & _mask].seq.load(std::memory_order_acquire);
+                if (static_cast< std::ptrdiff_t >(seq - pos) < 0) return 0;   // full
+
+                // Another producer took this cell, catch up.
+                pos = _tail.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (_tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) return n;
+        }
+    }
+
+    std::size_t claim_pop(std::size_t count, std::size_t& pos)
+    {
+        pos = _head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            std::size_t n = 0;
+            while (n < count &&
+                   _cells[(pos + n) & _mask].seq.load(std::memory_order_acquire) == pos + n + 1)
+            {
+                ++n;
+            }
+
+            if (0 == n)
+            {
+                std::size_t seq = _cells[pos & _mask].seq.load(std::memory_order_acquire);
+                if (static_cast< std::ptrdiff_t >(seq - (pos + 1)) < 0) return 0;  // empty
+
+                // Another consumer took this cell, catch up.
+                pos = _head.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (_head.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) return n;
+        }
+    }
+
+    /// @brief  Move the element of `pos` out and hand the cell to the
+    ///         producer of the next lap.
+    void release(std::size_t pos, T& value)
+    {
+        cell& c = _cells[pos & _mask];
+        T* element = reinterpret_cast< T* >(&c.storage);
+        value = std::move(*element);
+        element->~T();
+        c.seq.store(pos + _mask + 1, std::memory_order_release);
+    }
+
+private:
+    const bool                          _blocking;
+    const std::size_t                   _mask;
+    cell* const                         _cells;
+    ring_queue_detail::waiter           _not_empty;
+    ring_queue_detail::waiter           _not_full;
+
+    char _pad0[RING_QUEUE_CACHE_LINE];
+    std::atomic< std::size_t >          _tail;
+    char _pad1[RING_QUEUE_CACHE_LINE - sizeof(std::atomic< std::size_t >)];
+    std::atomic< std::size_t >          _head;
+    char _pad2[RING_QUEUE_CACHE_LINE - sizeof(std::atomic< std::size_t >)];
+};
+
+/// @brief  Bounded SPSC queue. Exactly one thread may push and exactly one
+///         (other) thread may pop. Each side keeps a cached copy of the
+///         other side's index and only re-reads it when the cache says the
+///         queue is full (or empty).
+template < typename T >
+class ring_queue< T, ring_spsc >
+    : private boost::noncopyable,
+      public ring_queue_detail::blocking_ops< ring_queue< T, ring_spsc >, T >
+{
+    friend class ring_queue_detail::blocking_ops< ring_queue< T, ring_spsc >, T >;
+
+public:
+    explicit ring_queue(std::size_t capacity, bool blocking = false)
+        :
+        _blocking(blocking),
+        _mask(ring_queue_detail::round_up_pow2(capacity) - 1),
+        _slots(new storage_type[_mask + 1]),
+        _tail(0),
+        _head_cache(0),
+        _head(0),
+        _tail_cache(0)
+    {
+    }
+
+    ~ring_queue()
+    {
+        std::size_t tail = _tail.load();
+        for (std::size_t pos = _head.load(); pos != tail; ++pos)
+        {
+            reinterpret_cast< T* >(&_slots[pos & _mask])->~T();
+        }
+        delete[] _slots;
+    }
+
+    std::size_t capacity() const { return _mask + 1; }
+
+    std::size_t size() const
+    {
+        std::size_t head = _head.load(std::memory_order_acquire);
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+
+    bool empty() const { return 0 == size(); }
+
+    /// @brief  Producer side. Returns false if full.
+    bool try_push(T&& value)
+    {
+        return 1 == push_n(&value, 1);
+    }
+
+    bool try_push(const T& value)
+    {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+
+    /// @brief  Consumer side. Returns false if empty.
+    bool try_pop(T& value)
+    {
+        return 1 == pop_n(&value, 1);
+    }
+
+    /// @brief  Producer side.
+    std::size_t push_n(T* values, std::size_t count)
+    {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head_cache + count > capacity())
+        {
+            _head_cache = _head.load(std::memory_order_acquire);
+        }
+
+        std::size_t n = capacity() - (tail - _head_cache);
+        if (n > count) n = count;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            new (&_slots[(tail + i) & _mask]) T(std::move(values[i]));
+        }
+
+        if (0 < n)
+        {
+            _tail.store(tail + n, std::memory_order_release);
+            if (true == _blocking) _not_empty.notify();
+        }
+        return n;
+    }
+
+    /// @brief  Consumer side.
+    std::size_t pop_n(T* values, std::size_t count)
+    {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (_tail_cache - head < count)
+        {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+        }
+
+        std::size_t n = _tail_cache - head;
+        if (n > count) n = count;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            T* element = reinterpret_cast< T* >(&_slots[(head + i) & _mask]);
+            values[i] = std::move(*element);
+            element->~T();
+        }
+
+        if (0 < n)
+        {
+            _head.store(head + n, std::memory_order_release);
+            if (true == _blocking) _not_full.notify();
+        }
+        return n;
+    }
+
+    /// @brief  Producer side, in place. Returns the storage of the next
+    ///         element or nullptr if full. The caller constructs the element
+    ///         there and publishes it with commit_push().
+    void* try_reserve()
+    {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head_cache == capacity())
+        {
+            _head_cache = _head.load(std::memory_order_acquire);
+            if (tail - _head_cache == capacity()) return nullptr;
+        }
+        return &_slots[tail & _mask];
+    }
+
+    void commit_push()
+    {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        if (true == _blocking) _not_empty.notify();
+    }
+
+    /// @brief  Consumer side, in place. Returns the element `index` places
+    ///         from the front or nullptr if there are not that many.
+    T* peek(std::size_t index)
+    {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (_tail_cache - head <= index)
+        {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            if (_tail_cache - head <= index) return nullptr;
+        }
+        return reinterpret_cast< T* >(&_slots[(head + index) & _mask]);
+    }
+
+    /// @brief  Consumer side. Destroy the first `count` elements, which
+    ///         must have been seen with peek().
+    void consume(std::size_t count)
+    {
+        if (0 == count) return;
+
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            reinterpret_cast< T* >(&_slots[(head + i) & _mask])->~T();
+        }
+
+        _head.store(head + count, std::memory_order_release);
+        if (true == _blocking) _not_full.notify();
+    }
+
+private:
+    typedef typename std::aligned_storage< sizeof(T), alignof(T) >::type storage_type;
+
+    const bool                          _blocking;
+    const std::size_t                   _mask;
+    storage_type* const                 _slots;
+    ring_queue_detail::waiter           _not_empty;
+    ring_queue_detail::waiter           _not_full;
+
+    // producer
+    char _pad0[RING_QUEUE_CACHE_LINE];
+    std::atomic< std::size_t >          _tail;
+    std::size_t                         _head_cache;
+    char _pad1[RING_QUEUE_CACHE_LINE - sizeof(std::atomic< std::size_t >) - sizeof(std::size_t)];
+
+    // consumer
+    std::atomic< std::size_t >          _head;
+    std::size_t                         _tail_cache;
+    char _pad2[RING_QUEUE_CACHE_LINE - sizeof(std::atomic< std::size_t >) - sizeof(std::size_t)];
+};
@@ -189,6 +189,114 @@
 #undef  SWAP_BYTES
 #endif
 
+/*  3. RUN TIME CPU FEATURE DETECTION
+
+    The compression functions have SIMD/SHA instruction versions that are
+    selected at run time. GCC/clang need a target attribute to compile
+    them without enabling the instructions for the whole file, MSVC does
+    not.
+*/
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define SHA2_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#elif defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO))
+#  define SHA2_ARMV8
+#  if defined(_MSC_VER)
+#    include <arm64_neon.h>
+#  else
+#    include <arm_neon.h>
+#    include <sys/auxv.h>
+#    include <asm/hwcap.h>
+#  endif
+#endif
+
+#if defined(__GNUC__)
+#  define SHA2_TARGET(x)  __attribute__((target(x)))
+#else
+#  define SHA2_TARGET(x)
+#endif
+
+#if defined(SHA2_X86)
+static void sha2_cpuid(int leaf, int sub_leaf, sha2_32t regs[4])
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, leaf, sub_leaf);
+    regs[0] = r[0]; regs[1] = r[1]; regs[2] = r[2]; regs[3] = r[3];
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    __cpuid_count(leaf, sub_leaf, a, b, c, d);
+    regs[0] = a; regs[1] = b; regs[2] = c; regs[3] = d;
+#endif
+}
+
+/* register state the OS saves on context switch (XCR0), the YMM        */
+/* registers (bit 1, 2) are needed for AVX2, the ZMM/opmask registers   */
+/* (bit 5, 6, 7) for AVX-512                                            */
+static sha2_32t sha2_xcr0(void)
+{
+#if defined(_MSC_VER)
+    return (sha2_32t)_xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return eax;
+#endif
+}
+#endif
+
+sha2_32t sha2_cpu_features(void)
+{   sha2_32t features = 0;
+#if defined(SHA2_X86)
+    sha2_32t regs[4];
+
+    sha2_cpuid(0, 0, regs);
+    const sha2_32t max_leaf = regs[0];
+
+    sha2_cpuid(1, 0, regs);
+    if(regs[2] & (1 << 9))  features |= SHA2_CPU_SSSE3;
+    if(regs[2] & (1 << 19)) features |= SHA2_CPU_SSE41;
+    const sha2_32t xcr0 = ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28))) ? sha2_xcr0() : 0;
+    const int avx_usable = (xcr0 & 0x06) == 0x06;
+    const int avx512_usable = (xcr0 & 0xe6) == 0xe6;
+
+    if(max_leaf >= 7)
+    {
+        sha2_cpuid(7, 0, regs);
+        if(avx_usable && (regs[1] & (1 << 5))) features |= SHA2_CPU_AVX2;
+        if(regs[1] & (1 << 8))  features |= SHA2_CPU_BMI2;
+        if(regs[1] & (1 << 29)) features |= SHA2_CPU_SHA;
+        if(avx512_usable && (regs[1] & (1 << 16))) features |= SHA2_CPU_AVX512F;
+        if(avx512_usable && (regs[1] & (1 << 30))) features |= SHA2_CPU_AVX512BW;
+    }
+#elif defined(SHA2_ARMV8)
+#  if defined(_MSC_VER)
+    if(IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE)) features |= SHA2_CPU_ARMV8_SHA2;
+#  else
+    if(getauxval(AT_HWCAP) & HWCAP_SHA2) features |= SHA2_CPU_ARMV8_SHA2;
+#  endif
+#endif
+    return features;
+}
+
+const char* sha2_impl_name(int impl)
+{
+    switch(impl)
+    {
+        case SHA2_IMPL_C:     return "c";
+        case SHA2_IMPL_AVX2:  return "avx2";
+        case SHA2_IMPL_SHANI: return "sha-ni";
+        case SHA2_IMPL_ARMV8: return "armv8";
+    }
+    return "unknown";
+}
+
 #if defined(SHA_2) || defined(SHA_256)
 
 #define SHA256_MASK (SHA256_BLOCK_SIZE - 1)
@@ -264,7 +372,7 @@ void sha256_begin(sha256_ctx ctx[1])
 /* buffer will now go to the high end of words on BOTH big  */
 /* and little endian systems                                */
 
-void sha256_compile(sha256_ctx ctx[1])
+static void sha256_compile_c(sha256_ctx ctx[1])
 {   sha2_32t	v[8], j;
 
     memcpy(v, ctx->hash, 8 * sizeof(sha2_32t));
@@ -281,6 +389,315 @@ void sha256_compile(sha256_ctx ctx[1])
     ctx->hash[4] += v[4]; ctx->hash[5] += v[5]; ctx->hash[6] += v[6]; ctx->hash[7] += v[7];
 }
 
+/* The SIMD/SHA instruction versions take the input as it is (big      */
+/* endian byte stream, not swapped into ctx->wbuf) and compile any      */
+/* number of whole blocks per call, so sha256_hash() can run them       */
+/* straight from the caller's buffer.                                   */
+
+typedef void (*sha256_blocks_fn)(sha2_32t hash[8], const unsigned char data[], unsigned long blocks);
+
+static void sha256_blocks_c(sha2_32t hash[8], const unsigned char data[], unsigned long blocks)
+{   sha256_ctx  cx[1];
+
+    memcpy(cx->hash, hash, 8 * sizeof(sha2_32t));
+    while(blocks--)
+    {
+        memcpy(cx->wbuf, data, SHA256_BLOCK_SIZE);
+        bsw_32(cx->wbuf, SHA256_BLOCK_SIZE >> 2)
+        sha256_compile_c(cx);
+        data += SHA256_BLOCK_SIZE;
+    }
+    memcpy(hash, cx->hash, 8 * sizeof(sha2_32t));
+}
+
+#if defined(SHA2_X86)
+
+/* SHA extensions: two rounds per sha256rnds2 on the ABEF/CDGH state    */
+/* layout, sha256msg1/sha256msg2 compute the message schedule.          */
+
+SHA2_TARGET("sha,sse4.1,ssse3")
+static void sha256_blocks_shani(sha2_32t hash[8], const unsigned char data[], unsigned long blocks)
+{   const __m128i bswap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, abef_save, cdgh_save, msg[4], wk, tmp;
+    int g;
+
+    tmp    = _mm_loadu_si128((const __m128i*)&hash[0]);  /* DCBA */
+    state1 = _mm_loadu_si128((const __m128i*)&hash[4]);  /* HGFE */
+    tmp    = _mm_shuffle_epi32(tmp, 0xb1);                /* CDAB */
+    state1 = _mm_shuffle_epi32(state1, 0x1b);             /* EFGH */
+    state0 = _mm_alignr_epi8(tmp, state1, 8);             /* ABEF */
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);          /* CDGH */
+
+    while(blocks--)
+    {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        for(g = 0; g < 4; ++g)
+            msg[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * g)), bswap_mask);
+
+        /* 16 groups of 4 rounds, w[4g .. 4g + 3] is in msg[g & 3]      */
+        for(g = 0; g < 16; ++g)
+        {
+            wk = _mm_add_epi32(msg[g & 3], _mm_loadu_si128((const __m128i*)&k256[4 * g]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+
+            if(g >= 3 && g <= 14)   /* w[4g + 4 .. 4g + 7]              */
+            {
+                tmp = _mm_alignr_epi8(msg[g & 3], msg[(g - 1) & 3], 4);
+                msg[(g + 1) & 3] = _mm_add_epi32(msg[(g + 1) & 3], tmp);
+                msg[(g + 1) & 3] = _mm_sha256msg2_epu32(msg[(g + 1) & 3], msg[g & 3]);
+            }
+
+            wk = _mm_shuffle_epi32(wk, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+
+            if(g >= 1 && g <= 12)
+                msg[(g - 1) & 3] = _mm_sha256msg1_epu32(msg[(g - 1) & 3], msg[g & 3]);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+        data += SHA256_BLOCK_SIZE;
+    }
+
+    tmp    = _mm_shuffle_epi32(state0, 0x1b);             /* FEBA */
+    state1 = _mm_shuffle_epi32(state1, 0xb1);             /* DCHG */
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);          /* DCBA */
+    state1 = _mm_alignr_epi8(state1, tmp, 8);             /* HGFE */
+
+    _mm_storeu_si128((__m128i*)&hash[0], state0);
+    _mm_storeu_si128((__m128i*)&hash[4], state1);
+}
+
+/* AVX2: the message schedule (w[t] + k[t]) of two blocks is computed   */
+/* together, one block in each 128-bit lane, then the rounds of each    */
+/* block run in scalar code (rorx with BMI2).                           */
+
+#define s256_vrotr(x, n)  _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define s256_vg0(x)       _mm256_xor_si256(_mm256_xor_si256(s256_vrotr((x), 7), s256_vrotr((x), 18)), _mm256_srli_epi32((x), 3))
+#define s256_vg1(x)       _mm256_xor_si256(_mm256_xor_si256(s256_vrotr((x), 17), s256_vrotr((x), 19)), _mm256_srli_epi32((x), 10))
+
+SHA2_TARGET("avx2,bmi2")
+static void sha256_schedule_avx2(sha2_32t wk[2][64], const unsigned char b0[], const unsigned char b1[])
+{   const __m256i bswap_mask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                  0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const __m256i mask_lo = _mm256_set_epi64x(0, -1, 0, -1);
+    __m256i x[4], t, s;
+    sha2_32t lanes[8];
+    int i, g;
+
+    for(g = 0; g < 4; ++g)
+    {
+        t = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(b0 + 16 * g))),
+                                    _mm_loadu_si128((const __m128i*)(b1 + 16 * g)), 1);
+        x[g] = _mm256_shuffle_epi8(t, bswap_mask);
+    }
+
+    for(g = 0; g < 16; ++g)
+    {
+        /* w[4g .. 4g + 3] + k  */
+        t = _mm256_add_epi32(x[g & 3], _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)&k256[4 * g])));
+        _mm256_storeu_si256((__m256i*)lanes, t);
+        for(i = 0; i < 4; ++i)
+        {
+            wk[0][4 * g + i] = lanes[i];
+            wk[1][4 * g + i] = lanes[4 + i];
+        }
+
+        if(g >= 12) continue;
+
+        /* w[t] = g1(w[t - 2]) + w[t - 7] + g0(w[t - 15]) + w[t - 16]    */
+        /* for t = 4g + 16 .. 4g + 19, x[g & 3] = w[4g .. 4g + 3]         */
+        t = _mm256_add_epi32(x[g & 3], s256_vg0(_mm256_alignr_epi8(x[(g + 1) & 3], x[g & 3], 4)));
+        t = _mm256_add_epi32(t, _mm256_alignr_epi8(x[(g + 3) & 3], x[(g + 2) & 3], 4));
+
+        /* the first two words need w[t - 2] of the previous group      */
+        s = s256_vg1(_mm256_shuffle_epi32(x[(g + 3) & 3], 0xee));
+        t = _mm256_add_epi32(t, _mm256_and_si256(s, mask_lo));
+
+        /* the last two depend on the first two words just computed    */
+        s = s256_vg1(_mm256_shuffle_epi32(t, 0x44));
+        x[g & 3] = _mm256_add_epi32(t, _mm256_andnot_si256(mask_lo, s));
+    }
+}
+
+#define h2_round(a,b,c,d,e,f,g,h,t) \
+    h += s256_1(e) + ch(e, f, g) + wk[t]; d += h; h += s256_0(a) + maj(a, b, c)
+
+SHA2_TARGET("avx2,bmi2")
+static void sha256_rounds_wk(sha2_32t hash[8], const sha2_32t wk[64])
+{   sha2_32t a = hash[0], b = hash[1], c = hash[2], d = hash[3],
+             e = hash[4], f = hash[5], g = hash[6], h = hash[7];
+    int t;
+
+    for(t = 0; t < 64; t += 8)
+    {
+        h2_round(a, b, c, d, e, f, g, h, t + 0);
+        h2_round(h, a, b, c, d, e, f, g, t + 1);
+        h2_round(g, h, a, b, c, d, e, f, t + 2);
+        h2_round(f, g, h, a, b, c, d, e, t + 3);
+        h2_round(e, f, g, h, a, b, c, d, t + 4);
+        h2_round(d, e, f, g, h, a, b, c, t + 5);
+        h2_round(c, d, e, f, g, h, a, b, t + 6);
+        h2_round(b, c, d, e, f, g, h, a, t + 7);
+    }
+
+    hash[0] += a; hash[1] += b; hash[2] += c; hash[3] += d;
+    hash[4] += e; hash[5] += f; hash[6] += g; hash[7] += h;
+}
+
+SHA2_TARGET("avx2,bmi2")
+static void sha256_blocks_avx2(sha2_32t hash[8], const unsigned char data[], unsigned long blocks)
+{   sha2_32t wk[2][64];
+
+    while(blocks)
+    {
+        /* with an odd block count the last block is scheduled twice   */
+        const unsigned char* next = (blocks > 1) ? data + SHA256_BLOCK_SIZE : data;
+
+        sha256_schedule_avx2(wk, data, next);
+        sha256_rounds_wk(hash, wk[0]);
+        if(blocks == 1) break;
+
+        sha256_rounds_wk(hash, wk[1]);
+        data += 2 * SHA256_BLOCK_SIZE; blocks -= 2;
+    }
+}
+
+#endif
+
+#if defined(SHA2_ARMV8)
+
+#if defined(__GNUC__)
+__attribute__((target("+crypto")))
+#endif
+static void sha256_blocks_armv8(sha2_32t hash[8], const unsigned char data[], unsigned long blocks)
+{   uint32x4_t state0 = vld1q_u32(&hash[0]), state1 = vld1q_u32(&hash[4]);
+    uint32x4_t abcd_save, efgh_save, msg[4], wk, tmp;
+    int g;
+
+    while(blocks--)
+    {
+        abcd_save = state0;
+        efgh_save = state1;
+
+        for(g = 0; g < 4; ++g)
+            msg[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * g)));
+
+        for(g = 0; g < 16; ++g)
+        {
+            wk = vaddq_u32(msg[g & 3], vld1q_u32(&k256[4 * g]));
+            if(g < 12)
+                msg[g & 3] = vsha256su0q_u32(msg[g & 3], msg[(g + 1) & 3]);
+
+            tmp = state0;
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, tmp, wk);
+
+            if(g < 12)
+                msg[g & 3] = vsha256su1q_u32(msg[g & 3], msg[(g + 2) & 3], msg[(g + 3) & 3]);
+        }
+
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+        data += SHA256_BLOCK_SIZE;
+    }
+
+    vst1q_u32(&hash[0], state0);
+    vst1q_u32(&hash[4], state1);
+}
+
+#endif
+
+/* run time selection of the compression function                      */
+
+typedef struct
+{   int              impl;
+    sha256_blocks_fn blocks;
+} sha256_impl_t;
+
+static sha256_blocks_fn sha256_impl_blocks(int impl)
+{   const sha2_32t features = sha2_cpu_features();
+
+    switch(impl)
+    {
+        case SHA2_IMPL_C:
+            return sha256_blocks_c;
+#if defined(SHA2_X86)
+        case SHA2_IMPL_AVX2:
+            if((features & (SHA2_CPU_AVX2 | SHA2_CPU_BMI2)) == (SHA2_CPU_AVX2 | SHA2_CPU_BMI2))
+                return sha256_blocks_avx2;
+            break;
+        case SHA2_IMPL_SHANI:
+            if((features & (SHA2_CPU_SHA | SHA2_CPU_SSE41 | SHA2_CPU_SSSE3)) == (SHA2_CPU_SHA | SHA2_CPU_SSE41 | SHA2_CPU_SSSE3))
+                return sha256_blocks_shani;
+            break;
+#endif
+#if defined(SHA2_ARMV8)
+        case SHA2_IMPL_ARMV8:
+            if(features & SHA2_CPU_ARMV8_SHA2)
+                return sha256_blocks_armv8;
+            break;
+#endif
+    }
+    (void)features;
+    return 0;
+}
+
+static sha256_impl_t* sha256_impl(void)
+{   static sha256_impl_t current = []()
+    {   /* fastest first    */
+        static const int order[] = { SHA2_IMPL_SHANI, SHA2_IMPL_ARMV8, SHA2_IMPL_AVX2, SHA2_IMPL_C };
+        sha256_impl_t selected = { SHA2_IMPL_C, sha256_blocks_c };
+        for(int impl : order)
+        {
+            sha256_blocks_fn blocks = sha256_impl_blocks(impl);
+            if(blocks) { selected.impl = impl; selected.blocks = blocks; break; }
+        }
+        return selected;
+    }();
+    return &current;
+}
+
+int sha256_get_impl(void)
+{
+    return sha256_impl()->impl;
+}
+
+/* not thread safe, hashing must not run while switching               */
+int sha256_set_impl(int impl)
+{   sha256_blocks_fn blocks = sha256_impl_blocks(impl);
+
+    if(!blocks) return SHA2_BAD;
+    sha256_impl()->impl = impl;
+    sha256_impl()->blocks = blocks;
+    return SHA2_GOOD;
+}
+
+void sha256_compile_blocks(sha2_32t hash[8], const unsigned char data[], unsigned long blocks)
+{
+    sha256_impl()->blocks(hash, data, blocks);
+}
+
+/* Compile 64 bytes of hash data (in ctx->wbuf, byte order as described */
+/* above) into SHA256 digest value                                      */
+
+void sha256_compile(sha256_ctx ctx[1])
+{   const sha256_impl_t *impl = sha256_impl();
+    sha2_32t w[16];
+
+    if(impl->impl == SHA2_IMPL_C)
+    {
+        sha256_compile_c(ctx); return;
+    }
+
+    /* back to the byte stream order */
+    memcpy(w, ctx->wbuf, SHA256_BLOCK_SIZE);
+    bsw_32(w, SHA256_BLOCK_SIZE >> 2)
+    impl->blocks(ctx->hash, (const unsigned char*)w, 1);
+}
+
 /* SHA256 hash data in an array of bytes into hash buffer   */
 /* and call the hash_compile function as required.          */
 
@@ -289,15 +706,22 @@ void sha256_hash(const unsigned char data[], unsigned long len, sha256_ctx ctx[1
              space = SHA256_BLOCK_SIZE - pos;
     const unsigned char *sp = data;
 
+    sha256_blocks_fn blocks = sha256_impl()->blocks;
+
     if((ctx->count[0] += len) < len)
         ++(ctx->count[1]);
 
-    while(len >= space)     /* tranfer whole blocks while possible  */
+    if(pos && len >= space) /* complete the buffered block first    */
     {
         memcpy(((unsigned char*)ctx->wbuf) + pos, sp, space);
-        sp += space; len -= space; space = SHA256_BLOCK_SIZE; pos = 0; 
-		bsw_32(ctx->wbuf, SHA256_BLOCK_SIZE >> 2)
-        sha256_compile(ctx);
+        sp += space; len -= space; pos = 0;
+        blocks(ctx->hash, (const unsigned char*)ctx->wbuf, 1);
+    }
+
+    if(len >= SHA256_BLOCK_SIZE)    /* whole blocks from the input  */
+    {
+        blocks(ctx->hash, sp, len / SHA256_BLOCK_SIZE);
+        sp += len & ~(unsigned long)SHA256_MASK; len &= SHA256_MASK;
     }
 
     memcpy(((unsigned char*)ctx->wbuf) + pos, sp, len);
@@ -448,9 +872,10 @@ const sha2_64t  k512[80] =
     n_u64(5fcb6fab3ad6faec), n_u64(6c44198c4a475817)
 };
 
-/* Compile 64 bytes of hash data into SHA384/SHA512 digest value  */
+/* Compile 128 bytes of hash data into SHA384/SHA512 digest value */
+/* (ctx->wbuf[] in the byte order described for sha256_compile) */
 
-void sha512_compile(sha512_ctx ctx[1])
+static void sha512_compile_c(sha512_ctx ctx[1])
 {   sha2_64t    v[8];
     sha2_32t    j;
 
@@ -468,27 +893,238 @@ void sha512_compile(sha512_ctx ctx[1])
     ctx->hash[4] += v[4]; ctx->hash[5] += v[5]; ctx->hash[6] += v[6]; ctx->hash[7] += v[7];
 }
 
-/* Compile 128 bytes of hash data into SHA256 digest value  */
-/* NOTE: this routine assumes that the byte order in the    */
-/* ctx->wbuf[] at this point is in such an order that low   */
-/* address bytes in the ORIGINAL byte stream placed in this */
-/* buffer will now go to the high end of words on BOTH big  */
-/* and little endian systems                                */
+/* As for SHA256 the SIMD versions take whole 128 byte blocks of the    */
+/* input byte stream.                                                   */
+
+typedef void (*sha512_blocks_fn)(sha2_64t hash[8], const unsigned char data[], unsigned long blocks);
+
+static void sha512_blocks_c(sha2_64t hash[8], const unsigned char data[], unsigned long blocks)
+{   sha512_ctx  cx[1];
+
+    memcpy(cx->hash, hash, 8 * sizeof(sha2_64t));
+    while(blocks--)
+    {
+        memcpy(cx->wbuf, data, SHA512_BLOCK_SIZE);
+        bsw_64(cx->wbuf, SHA512_BLOCK_SIZE >> 3)
+        sha512_compile_c(cx);
+        data += SHA512_BLOCK_SIZE;
+    }
+    memcpy(hash, cx->hash, 8 * sizeof(sha2_64t));
+}
+
+#if defined(SHA2_X86)
+
+/* AVX2: the message schedule (w[t] + k[t]) of two blocks is computed   */
+/* together, two words of one block in each 128-bit lane. With two      */
+/* words per step w[t - 2], w[t - 1] are always from the previous step, */
+/* so unlike SHA256 no step has to be split. The schedule steps are     */
+/* interleaved with the scalar rounds (rorx with BMI2) of the first     */
+/* block so both run at the same time, the rounds of the second block   */
+/* then use the stored schedule.                                        */
+
+#define s512_vrotr(x, n)  _mm256_or_si256(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+#define s512_vg0(x)       _mm256_xor_si256(_mm256_xor_si256(s512_vrotr((x), 1), s512_vrotr((x), 8)), _mm256_srli_epi64((x), 7))
+#define s512_vg1(x)       _mm256_xor_si256(_mm256_xor_si256(s512_vrotr((x), 19), s512_vrotr((x), 61)), _mm256_srli_epi64((x), 6))
+
+/* w[2g], w[2g + 1] + k of both blocks, then                            */
+/* w[t] = g1(w[t - 2]) + w[t - 7] + g0(w[t - 15]) + w[t - 16]           */
+/* for t = 2g + 16, 2g + 17 (x[g & 7] holds w[2g], w[2g + 1])           */
+#define h5_vstep(g) \
+    t = _mm256_add_epi64(x[(g) & 7], _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)&k512[2 * (g)]))); \
+    _mm_storeu_si128((__m128i*)&wk[0][2 * (g)], _mm256_castsi256_si128(t)); \
+    _mm_storeu_si128((__m128i*)&wk[1][2 * (g)], _mm256_extracti128_si256(t, 1)); \
+    if((g) < 32) \
+    {   t = _mm256_add_epi64(x[(g) & 7], s512_vg0(_mm256_alignr_epi8(x[((g) + 1) & 7], x[(g) & 7], 8))); \
+        t = _mm256_add_epi64(t, _mm256_alignr_epi8(x[((g) + 5) & 7], x[((g) + 4) & 7], 8)); \
+        x[(g) & 7] = _mm256_add_epi64(t, s512_vg1(x[((g) + 7) & 7])); \
+    }
+
+#define h5_round(a,b,c,d,e,f,g,h,w) \
+    h += s512_1(e) + ch(e, f, g) + (w); d += h; h += s512_0(a) + maj(a, b, c)
+
+SHA2_TARGET("avx2,bmi2")
+static void sha512_rounds_wk(sha2_64t hash[8], const sha2_64t wk[80])
+{   sha2_64t a = hash[0], b = hash[1], c = hash[2], d = hash[3],
+             e = hash[4], f = hash[5], g = hash[6], h = hash[7];
+    int t;
+
+    for(t = 0; t < 80; t += 8)
+    {
+        h5_round(a, b, c, d, e, f, g, h, wk[t + 0]);
+        h5_round(h, a, b, c, d, e, f, g, wk[t + 1]);
+        h5_round(g, h, a, b, c, d, e, f, wk[t + 2]);
+        h5_round(f, g, h, a, b, c, d, e, wk[t + 3]);
+        h5_round(e, f, g, h, a, b, c, d, wk[t + 4]);
+        h5_round(d, e, f, g, h, a, b, c, wk[t + 5]);
+        h5_round(c, d, e, f, g, h, a, b, wk[t + 6]);
+        h5_round(b, c, d, e, f, g, h, a, wk[t + 7]);
+    }
+
+    hash[0] += a; hash[1] += b; hash[2] += c; hash[3] += d;
+    hash[4] += e; hash[5] += f; hash[6] += g; hash[7] += h;
+}
+
+/* rounds of block b0 with the schedule of b0 and b1, the schedule of   */
+/* b1 is left in wk[1]                                                  */
+
+SHA2_TARGET("avx2,bmi2")
+static void sha512_rounds_schedule_avx2(sha2_64t hash[8], sha2_64t wk[2][80],
+                                        const unsigned char b0[], const unsigned char b1[])
+{   const __m256i bswap_mask = _mm256_set_epi64x(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL,
+                                                  0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+    sha2_64t a = hash[0], b = hash[1], c = hash[2], d = hash[3],
+             e = hash[4], f = hash[5], g = hash[6], h = hash[7];
+    __m256i x[8], t;
+    int i;
+
+    for(i = 0; i < 8; ++i)
+    {
+        t = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(b0 + 16 * i))),
+                                    _mm_loadu_si128((const __m128i*)(b1 + 16 * i)), 1);
+        x[i] = _mm256_shuffle_epi8(t, bswap_mask);
+    }
+
+    for(i = 0; i < 40; i += 4)
+    {
+        h5_vstep(i);
+        h5_round(a, b, c, d, e, f, g, h, wk[0][2 * i + 0]);
+        h5_round(h, a, b, c, d, e, f, g, wk[0][2 * i + 1]);
+        h5_vstep(i + 1);
+        h5_round(g, h, a, b, c, d, e, f, wk[0][2 * i + 2]);
+        h5_round(f, g, h, a, b, c, d, e, wk[0][2 * i + 3]);
+        h5_vstep(i + 2);
+        h5_round(e, f, g, h, a, b, c, d, wk[0][2 * i + 4]);
+        h5_round(d, e, f, g, h, a, b, c, wk[0][2 * i + 5]);
+        h5_vstep(i + 3);
+        h5_round(c, d, e, f, g, h, a, b, wk[0][2 * i + 6]);
+        h5_round(b, c, d, e, f, g, h, a, wk[0][2 * i + 7]);
+    }
+
+    hash[0] += a; hash[1] += b; hash[2] += c; hash[3] += d;
+    hash[4] += e; hash[5] += f; hash[6] += g; hash[7] += h;
+}
+
+SHA2_TARGET("avx2,bmi2")
+static void sha512_blocks_avx2(sha2_64t hash[8], const unsigned char data[], unsigned long blocks)
+{   sha2_64t wk[2][80];
+
+    while(blocks)
+    {
+        /* with an odd block count the last block is scheduled twice   */
+        const unsigned char* next = (blocks > 1) ? data + SHA512_BLOCK_SIZE : data;
+
+        sha512_rounds_schedule_avx2(hash, wk, data, next);
+        if(blocks == 1) break;
+
+        sha512_rounds_wk(hash, wk[1]);
+        data += 2 * SHA512_BLOCK_SIZE; blocks -= 2;
+    }
+}
+
+#endif
+
+/* run time selection of the compression function                      */
+
+typedef struct
+{   int              impl;
+    sha512_blocks_fn blocks;
+} sha512_impl_t;
+
+static sha512_blocks_fn sha512_impl_blocks(int impl)
+{   const sha2_32t features = sha2_cpu_features();
+
+    switch(impl)
+    {
+        case SHA2_IMPL_C:
+            return sha512_blocks_c;
+#if defined(SHA2_X86)
+        case SHA2_IMPL_AVX2:
+            if((features & (SHA2_CPU_AVX2 | SHA2_CPU_BMI2)) == (SHA2_CPU_AVX2 | SHA2_CPU_BMI2))
+                return sha512_blocks_avx2;
+            break;
+#endif
+    }
+    (void)features;
+    return 0;
+}
+
+static sha512_impl_t* sha512_impl(void)
+{   static sha512_impl_t current = []()
+    {   /* fastest first    */
+        static const int order[] = { SHA2_IMPL_AVX2, SHA2_IMPL_C };
+        sha512_impl_t selected = { SHA2_IMPL_C, sha512_blocks_c };
+        for(int impl : order)
+        {
+            sha512_blocks_fn blocks = sha512_impl_blocks(impl);
+            if(blocks) { selected.impl = impl; selected.blocks = blocks; break; }
+        }
+        return selected;
+    }();
+    return &current;
+}
+
+int sha512_get_impl(void)
+{
+    return sha512_impl()->impl;
+}
+
+/* not thread safe, hashing must not run while switching               */
+int sha512_set_impl(int impl)
+{   sha512_blocks_fn blocks = sha512_impl_blocks(impl);
+
+    if(!blocks) return SHA2_BAD;
+    sha512_impl()->impl = impl;
+    sha512_impl()->blocks = blocks;
+    return SHA2_GOOD;
+}
+
+void sha512_compile_blocks(sha2_64t hash[8], const unsigned char data[], unsigned long blocks)
+{
+    sha512_impl()->blocks(hash, data, blocks);
+}
+
+/* Compile 128 bytes of hash data (in ctx->wbuf) into the SHA384/SHA512 */
+/* digest value                                                         */
+
+void sha512_compile(sha512_ctx ctx[1])
+{   const sha512_impl_t *impl = sha512_impl();
+    sha2_64t w[16];
+
+    if(impl->impl == SHA2_IMPL_C)
+    {
+        sha512_compile_c(ctx); return;
+    }
+
+    /* back to the byte stream order */
+    memcpy(w, ctx->wbuf, SHA512_BLOCK_SIZE);
+    bsw_64(w, SHA512_BLOCK_SIZE >> 3)
+    impl->blocks(ctx->hash, (const unsigned char*)w, 1);
+}
+
+/* SHA384/SHA512 hash data in an array of bytes into hash buffer and    */
+/* call the compression function as required.                           */
 
 void sha512_hash(const unsigned char data[], unsigned long len, sha512_ctx ctx[1])
 {   sha2_32t pos = (sha2_32t)(ctx->count[0] & SHA512_MASK), 
              space = SHA512_BLOCK_SIZE - pos;
     const unsigned char *sp = data;
 
+    sha512_blocks_fn blocks = sha512_impl()->blocks;
+
     if((ctx->count[0] += len) < len)
         ++(ctx->count[1]);
 
-    while(len >= space)     /* tranfer whole blocks while possible  */
+    if(pos && len >= space) /* complete the buffered block first    */
     {
         memcpy(((unsigned char*)ctx->wbuf) + pos, sp, space);
-        sp += space; len -= space; space = SHA512_BLOCK_SIZE; pos = 0; 
-		bsw_64(ctx->wbuf, SHA512_BLOCK_SIZE >> 3);        
-        sha512_compile(ctx);
+        sp += space; len -= space; pos = 0;
+        blocks(ctx->hash, (const unsigned char*)ctx->wbuf, 1);
+    }
+
+    if(len >= SHA512_BLOCK_SIZE)    /* whole blocks from the input  */
+    {
+        blocks(ctx->hash, sp, len / SHA512_BLOCK_SIZE);
+        sp += len & ~(unsigned long)SHA512_MASK; len &= SHA512_MASK;
     }
 
     memcpy(((unsigned char*)ctx->wbuf) + pos, sp, len);
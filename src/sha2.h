@@ -120,6 +120,50 @@ typedef struct
 void sha256_compile(sha256_ctx ctx[1]);
 void sha512_compile(sha512_ctx ctx[1]);
 
+/* implementations of the compression function. The fastest one that   */
+/* the CPU supports is selected on first use; sha256_set_impl() can     */
+/* force another one (for testing) and returns SHA2_BAD if the CPU      */
+/* does not support it. All of them produce identical digests.          */
+
+#define SHA2_IMPL_C         0   /* portable C                          */
+#define SHA2_IMPL_AVX2      1   /* x86 AVX2 message schedule, 2 blocks */
+#define SHA2_IMPL_SHANI     2   /* x86 SHA extensions                  */
+#define SHA2_IMPL_ARMV8     3   /* ARMv8 SHA2 instructions             */
+
+int sha256_get_impl(void);
+int sha256_set_impl(int impl);
+const char* sha2_impl_name(int impl);
+
+/* SHA384/SHA512 use the same selection, only SHA2_IMPL_C and           */
+/* SHA2_IMPL_AVX2 (2 block message schedule) exist                      */
+
+int sha512_get_impl(void);
+int sha512_set_impl(int impl);
+
+/* compile whole 64 byte blocks of input (byte stream order, no         */
+/* padding) into hash[] with the selected implementation                */
+
+void sha256_compile_blocks(sha2_32t hash[8], const unsigned char data[], unsigned long blocks);
+void sha512_compile_blocks(sha2_64t hash[8], const unsigned char data[], unsigned long blocks);
+
+/* round constants (also used by the multi-buffer code)                 */
+
+extern const sha2_32t k256[64];
+extern const sha2_64t k512[80];
+
+/* CPU features the SIMD/SHA instruction versions need                  */
+
+#define SHA2_CPU_SSSE3      0x0001
+#define SHA2_CPU_SSE41      0x0002
+#define SHA2_CPU_AVX2       0x0004
+#define SHA2_CPU_BMI2       0x0008
+#define SHA2_CPU_SHA        0x0010
+#define SHA2_CPU_AVX512F    0x0020
+#define SHA2_CPU_AVX512BW   0x0040
+#define SHA2_CPU_ARMV8_SHA2 0x0100
+
+sha2_32t sha2_cpu_features(void);
+
 void sha256_begin(sha256_ctx ctx[1]);
 void sha256_hash(const unsigned char data[], unsigned long len, sha256_ctx ctx[1]);
 void sha256_end(unsigned char hval[], sha256_ctx ctx[1]);
@@ -0,0 +1,270 @@
+/**
+ * @file    task_graph.h
+ * @brief   task dependency graph on thread_pool.
+ *
+ * A task_node is a unit of work that starts when its predecessors are done.
+ * Nodes are chained with then() and joined with when_all()/when_any(). A node
+ * that becomes ready is posted to the pool by the thread that completed its
+ * last predecessor, so no pool thread ever blocks waiting for a dependency.
+ *
+ * @code
+ *      std::shared_ptr<chunk> c = std::make_shared<chunk>();
+ *      task_node read = spawn_task(pool, [c]() { read_chunk(*c); });
+ *      task_node md5 = read.then([c]() { md5_chunk(*c); });
+ *      task_node sha = read.then([c]() { sha256_chunk(*c); });
+ *      task_node store = when_all({ md5, sha }).then([c]() { cache_insert(*c); });
+ *      store.wait();
+ * @endcode
+ *
+ * If a task throws, its dependants are not run and the exception is rethrown
+ * from wait() of every node downstream.
+ *
+ * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
+ * @date    2026:10:17 created.
+ * @copyright All rights reserved by Yonghwan, Roh.
+**/
+#pragma once
+
+#include <stdexcept>
+#include "thread_pool.h"
+
+namespace task_graph_detail
+{
+    /// @brief  Shared state of a node.
+    class node_state : public std::enable_shared_from_this< node_state >
+    {
+    public:
+        node_state(thread_pool* pool, std::size_t predecessors, bool any)
+            :
+            _pool(pool),
+            _waiting(predecessors),
+            _any(any),
+            _fired(false),
+            _done(false)
+        {
+        }
+
+        thread_pool* pool() const { return _pool; }
+
+        void set_work(pool_task& work) { _work = std::move(work); }
+
+        bool is_done()
+        {
+            boost::lock_guard< boost::mutex > lock(_lock);
+            return _done;
+        }
+
+        void wait()
+        {
+            boost::unique_lock< boost::mutex > lock(_lock);
+            while (true != _done)
+            {
+                _condition.wait(lock);
+            }
+
+            if (_error) std::rethrow_exception(_error);
+        }
+
+        /// @brief  Run `successor` once this node is done.
+        void add_successor(const std::shared_ptr< node_state >& successor)
+        {
+            std::exception_ptr error;
+            {
+                boost::lock_guard< boost::mutex > lock(_lock);
+                if (true != _done)
+                {
+                    _successors.push_back(successor);
+                    return;
+                }
+                error = _error;
+            }
+            successor->predecessor_done(error);
+        }
+
+        /// @brief  Called once by every predecessor when it is done.
+        void predecessor_done(std::exception_ptr error)
+        {
+            // when_any: only the first predecessor counts.
+            if (true == _any && true == _fired.exchange(true)) return;
+
+            if (error)
+            {
+                boost::lock_guard< boost::mutex > lock(_lock);
+                if (!_error) _error = error;
+            }
+
+            if (true != _any && 0 != --_waiting) return;
+            start();
+        }
+
+        /// @brief  Nodes without predecessors are started by their creator.
+        void start()
+        {
+            std::exception_ptr error;
+            {
+                boost::lock_guard< boost::mutex > lock(_lock);
+                error = _error;
+            }
+
+            // Joins and failed nodes complete right away.
+            if (_work.empty() || error)
+            {
+                _work.reset();
+                complete(error);
+                return;
+            }
+
+            std::shared_ptr< node_state > self = shared_from_this();
+            _pool->post_task([self]()
+            {
+                std::exception_ptr error;
+                try
+                {
+                    self->_work();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                // Release the captures before the dependants run.
+                self->_work.reset();
+                self->complete(error);
+            });
+        }
+
+    private:
+        void complete(std::exception_ptr error)
+        {
+            std::vector< std::shared_ptr< node_state > > successors;
+            {
+                boost::lock_guard< boost::mutex > lock(_lock);
+                if (error && !_error) _error = error;
+                error = _error;
+                _done = true;
+                successors.swap(_successors);
+                _condition.notify_all();
+            }
+
+            for (auto& successor : successors)
+            {
+                successor->predecessor_done(error);
+            }
+        }
+
+    private:
+        thread_pool*                                    _pool;
+        pool_task                                       _work;
+        std::atomic< std::size_t >                      _waiting;
+        const bool                                      _any;
+        std::atomic< bool >                             _fired;
+
+        boost::mutex                                    _lock;
+        boost::condition_variable                       _condition;
+        bool                                            _done;
+        std::exception_ptr                              _error;
+        std::vector< std::shared_ptr< node_state > >    _successors;
+    };
+} // namespace task_graph_detail
+
+/// @brief  Handle of a node in the task graph. Cheap to copy.
+/// @see    test_task_graph()
+class task_node
+{
+public:
+    task_node() {}
+
+    /// @brief  Create a node that runs `func` on the same pool once this
+    ///         node is done.
+    template < typename Func >
+    task_node then(Func func) const
+    {
+        check();
+
+        std::shared_ptr< task_graph_detail::node_state > next =
+            std::make_shared< task_graph_detail::node_state >(_state->pool(), 1, false);
+        pool_task work(std::move(func));
+        next->set_work(work);
+
+        _state->add_successor(next);
+        return task_node(next);
+    }
+
+    /// @brief  Block the calling thread until the node is done, then rethrow
+    ///         the exception of the node or of any node upstream.
+    ///         Not to be called from a task; chain with then() instead.
+    void wait() const
+    {
+        check();
+        _state->wait();
+    }
+
+    bool is_ready() const
+    {
+        check();
+        return _state->is_done();
+    }
+
+    bool empty() const { return !_state; }
+
+private:
+    explicit task_node(const std::shared_ptr< task_graph_detail::node_state >& state)
+        : _state(state)
+    {
+    }
+
+    void check() const
+    {
+        if (!_state) throw std::logic_error("empty task_node");
+    }
+
+    static task_node join(const std::vector< task_node >& nodes, bool any)
+    {
+        if (nodes.empty()) throw std::invalid_argument("no task_node to join");
+        for (const auto& node : nodes)
+        {
+            node.check();
+        }
+
+        std::shared_ptr< task_graph_detail::node_state > join =
+            std::make_shared< task_graph_detail::node_state >(
+                nodes.front()._state->pool(), nodes.size(), any);
+        for (const auto& node : nodes)
+        {
+            node._state->add_successor(join);
+        }
+        return task_node(join);
+    }
+
+    template < typename Func >
+    friend task_node spawn_task(thread_pool& pool, Func func);
+    friend task_node when_all(const std::vector< task_node >& nodes);
+    friend task_node when_any(const std::vector< task_node >& nodes);
+
+private:
+    std::shared_ptr< task_graph_detail::node_state > _state;
+};
+
+/// @brief  Create a node without predecessors and post it to `pool`.
+template < typename Func >
+inline task_node spawn_task(thread_pool& pool, Func func)
+{
+    std::shared_ptr< task_graph_detail::node_state > state =
+        std::make_shared< task_graph_detail::node_state >(&pool, 0, false);
+    pool_task work(std::move(func));
+    state->set_work(work);
+    state->start();
+    return task_node(state);
+}
+
+/// @brief  Node that is done when all of `nodes` are done.
+inline task_node when_all(const std::vector< task_node >& nodes)
+{
+    return task_node::join(nodes, false);
+}
+
+/// @brief  Node that is done when the first of `nodes` is done.
+inline task_node when_any(const std::vector< task_node >& nodes)
+{
+    return task_node::join(nodes, true);
+}
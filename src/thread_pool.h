@@ -1,43 +1,332 @@
 /**
  * @file    thread_pool.h
  * @brief   thread pool implementation.
- * 
+ *
  * This file contains thread pool implementation using boost thread.
  *
  * @author  Yonhgwhan, Roh (fixbrain@gmail.com)
  * @date    2015:08:01 10:02 created.
  * @copyright All rights reserved by Yonghwan, Roh.
 **/
+#pragma once
 
-#include <queue>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <type_traits>
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
 
+/// @brief  Move-only `void()` callable used as the thread pool task.
+///
+///         Callables up to `inline_size` bytes (a lambda capturing a dozen
+///         pointers, a bind with a few arguments) are stored inside the
+///         object, so posting them costs no heap allocation. Larger or
+///         throwing-move callables fall back to the heap.
+/// @see    test_thread_pool_task_alloc()
+class pool_task
+{
+public:
+    /// @brief  sizeof(pool_task) is 120 bytes on x64 (inline_size plus the
+    ///         ops pointer, max_align_t is 8 bytes on MSVC).
+    static const std::size_t inline_size = 112;
+
+    pool_task() : _ops(nullptr) {}
+
+    template < typename Func,
+               typename = typename std::enable_if<
+                   !std::is_same< typename std::decay< Func >::type, pool_task >::value >::type >
+    pool_task(Func&& func) : _ops(nullptr)
+    {
+        typedef typename std::decay< Func >::type func_type;
+        construct< func_type >(std::forward< Func >(func), fits_inline< func_type >());
+    }
+
+    pool_task(pool_task&& other) : _ops(nullptr)
+    {
+        take(other);
+    }
+
+    pool_task& operator=(pool_task&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~pool_task()
+    {
+        reset();
+    }
+
+    /// @brief  Must not be called on an empty task.
+    void operator()()
+    {
+        _ops->invoke(&_storage);
+    }
+
+    bool empty() const { return nullptr == _ops; }
+
+    void reset()
+    {
+        if (nullptr != _ops)
+        {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    pool_task(const pool_task&);
+    pool_task& operator=(const pool_task&);
+
+    typedef std::aligned_storage< inline_size, alignof(std::max_align_t) >::type storage_type;
+
+    template < typename Func >
+    struct fits_inline : std::integral_constant< bool,
+        sizeof(Func) <= sizeof(storage_type) &&
+        alignof(Func) <= alignof(storage_type) &&
+        std::is_nothrow_move_constructible< Func >::value > {};
+
+    struct ops_type
+    {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src);     // leaves `src` destroyed
+        void (*destroy)(void* storage);
+    };
+
+    template < typename Func >
+    struct inline_ops
+    {
+        static Func* get(void* s) { return static_cast< Func* >(s); }
+        static void invoke(void* s) { (*get(s))(); }
+        static void move(void* dst, void* src)
+        {
+            new (dst) Func(std::move(*get(src)));
+            get(src)->~Func();
+        }
+        static void destroy(void* s) { get(s)->~Func(); }
+        static const ops_type* table()
+        {
+            static const ops_type ops = { &invoke, &move, &destroy };
+            return &ops;
+        }
+    };
+
+    template < typename Func >
+    struct heap_ops
+    {
+        static Func*& get(void* s) { return *static_cast< Func** >(s); }
+        static void invoke(void* s) { (*get(s))(); }
+        static void move(void* dst, void* src) { new (dst) Func*(get(src)); }
+        static void destroy(void* s) { delete get(s); }
+        static const ops_type* table()
+        {
+            static const ops_type ops = { &invoke, &move, &destroy };
+            return &ops;
+        }
+    };
+
+    template < typename Func, typename Arg >
+    void construct(Arg&& func, std::true_type /* inline */)
+    {
+        new (&_storage) Func(std::forward< Arg >(func));
+        _ops = inline_ops< Func >::table();
+    }
+
+    template < typename Func, typename Arg >
+    void construct(Arg&& func, std::false_type /* heap */)
+    {
+        new (&_storage) Func*(new Func(std::forward< Arg >(func)));
+        _ops = heap_ops< Func >::table();
+    }
+
+    void take(pool_task& other)
+    {
+        if (nullptr != other._ops)
+        {
+            other._ops->move(&_storage, &other._storage);
+            _ops = other._ops;
+            other._ops = nullptr;
+        }
+    }
+
+private:
+    storage_type        _storage;
+    const ops_type*     _ops;
+};
+
+#if defined(_M_X64)
+static_assert(sizeof(pool_task) == 120, "sizeof(pool_task) changed, update the comment on inline_size");
+#endif
+
 /// @brief thread pool implementation
+///
+///        Every worker owns a task deque. A worker pops from the back of its
+///        own deque first, then takes from the global injection queue, and
+///        finally steals from the front of a randomly chosen victim's deque.
+///        Tasks posted by a worker thread go to that worker's deque, tasks
+///        posted from any other thread go to the injection queue, so the
+///        workers never contend on a single pool-wide lock.
+///
+///        By default run_task() keeps its original contract and rejects the
+///        task if no thread is available. If `max_pending` is given, the pool
+///        runs in bounded mode instead: up to `max_pending` tasks may wait in
+///        the queues and producers park until there is room (run_task(),
+///        submit()) or until the timeout expires (run_task_for()).
+///
 /// @see test_thread_pool()
+/// @see test_thread_pool_work_stealing()
+/// @see test_thread_pool_bounded()
 /// @see original code is from http://stackoverflow.com/questions/12215395/thread-pool-using-boost-asio
 typedef class thread_pool
 {
 private:
-    std::queue< boost::function< void() > > _tasks;
-    boost::thread_group                     _threads;  
-    std::size_t                             _pool_size;
-    std::size_t                             _available;
-    boost::mutex                            _lock;
-    boost::condition_variable               _condition;
-    bool                                    _running;
+    typedef pool_task task_type;
+
+    /// @brief  Task deque. The owner works on the back, thieves on the front.
+    ///
+    ///         A power-of-two ring that only grows, so once it has reached
+    ///         its working size pushing and popping tasks never allocates
+    ///         (std::deque allocates a block per element for large types).
+    class work_queue
+    {
+    public:
+        work_queue() : _ring(64), _head(0), _count(0), _size(0) {}
+
+        void push_back(task_type& task)
+        {
+            boost::lock_guard< boost::mutex > lock(_lock);
+            if (_count == _ring.size()) grow();
+            _ring[(_head + _count) & (_ring.size() - 1)] = std::move(task);
+            ++_count;
+            _size.store(_count, std::memory_order_relaxed);
+        }
+
+        bool pop_back(task_type& task)
+        {
+            if (0 == _size.load(std::memory_order_relaxed)) return false;
+
+            boost::lock_guard< boost::mutex > lock(_lock);
+            if (0 == _count) return false;
+            --_count;
+            task = std::move(_ring[(_head + _count) & (_ring.size() - 1)]);
+            _size.store(_count, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool pop_front(task_type& task)
+        {
+            if (0 == _size.load(std::memory_order_relaxed)) return false;
+
+            boost::lock_guard< boost::mutex > lock(_lock);
+            if (0 == _count) return false;
+            task = std::move(_ring[_head]);
+            _head = (_head + 1) & (_ring.size() - 1);
+            --_count;
+            _size.store(_count, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        void grow()
+        {
+            std::vector< task_type > ring(_ring.size() * 2);
+            for (std::size_t i = 0; i < _count; ++i)
+            {
+                ring[i] = std::move(_ring[(_head + i) & (_ring.size() - 1)]);
+            }
+            _ring.swap(ring);
+            _head = 0;
+        }
+
+    private:
+        boost::mutex                _lock;
+        std::vector< task_type >    _ring;
+        std::size_t                 _head;
+        std::size_t                 _count;
+
+        // Lets thieves skip an empty deque without taking its lock.
+        std::atomic< std::size_t >  _size;
+
+        // Keep the next deque's lock off this cache line.
+        char                        _pad[64];
+    };
+
+    /// @brief  Identifies the pool and the deque owned by the calling thread.
+    struct worker_context
+    {
+        thread_pool*    pool;
+        std::size_t     index;
+        uint32_t        seed;
+    };
+
+    static worker_context& current_worker()
+    {
+        static thread_local worker_context context = { nullptr, 0, 0 };
+        return context;
+    }
+
+private:
+    std::vector< std::unique_ptr< work_queue > >    _queues;
+    work_queue                                      _injection;
+    boost::thread_group                             _threads;
+    std::size_t                                     _pool_size;
+    std::size_t                                     _max_pending;
+
+    // Free slots. A slot is an idle thread in the default mode (released
+    // when the task finishes) or a free queue entry in bounded mode
+    // (released when a worker dequeues the task). Signed because workers
+    // are allowed to overcommit, see acquire_slot().
+    std::atomic< std::ptrdiff_t >                   _available;
+    std::atomic< std::size_t >                      _pending;
+    std::atomic< std::size_t >                      _active;
+    std::atomic< std::size_t >                      _idle_workers;
+    boost::mutex                                    _lock;
+    boost::condition_variable                       _condition;
+
+    // Producers parked on a full pool.
+    std::atomic< std::size_t >                      _slot_waiters;
+    boost::mutex                                    _slot_lock;
+    boost::condition_variable                       _slot_condition;
+    std::atomic< bool >                             _running;
 
 public:
     /// @brief  Constructor
-    thread_pool(std::size_t pool_size)
+    /// @param  pool_size       number of worker threads.
+    /// @param  max_pending     0 to reject tasks while all threads are busy,
+    ///                         otherwise maximum number of queued tasks.
+    thread_pool(std::size_t pool_size, std::size_t max_pending = 0)
         :
         _pool_size(pool_size),
-        _available(pool_size),
+        _max_pending(max_pending),
+        _available(static_cast< std::ptrdiff_t >(0 == max_pending ? pool_size : max_pending)),
+        _pending(0),
+        _active(0),
+        _idle_workers(0),
+        _slot_waiters(0),
         _running(true)
     {
         for (std::size_t i = 0; i < pool_size; ++i)
         {
-            _threads.create_thread(boost::bind(&thread_pool::pool_main, this));
+            _queues.push_back(std::unique_ptr< work_queue >(new work_queue()));
+        }
+
+        for (std::size_t i = 0; i < pool_size; ++i)
+        {
+            _threads.create_thread(boost::bind(&thread_pool::pool_main, this, i));
         }
     }
 
@@ -50,108 +339,707 @@ public:
             _running = false;
             _condition.notify_all();
         }
+        {
+            boost::lock_guard< boost::mutex > lock(_slot_lock);
+            _slot_condition.notify_all();
+        }
 
         try
         {
             _threads.join_all();
-            //log_dbg 
-            //    "all thread joined. available = %u, remain task = %u ", 
-            //    this->_available, 
-            //    this->_tasks.size()
+            //log_dbg
+            //    "all thread joined. available = %u, remain task = %u ",
+            //    this->_available,
+            //    this->_pending
             //log_end
         }
         // Suppress all exceptions.
         catch (...) {}
     }
 
+    /// @brief return number of worker threads.
+    std::size_t get_pool_size() const
+    {
+        return _pool_size;
+    }
+
     /// @brief return task count in the queue.
     std::size_t get_task_count()
     {
-        boost::unique_lock< boost::mutex > lock(_lock);
-        return _tasks.size();
+        return _pending.load();
     }
 
     /// @brief  return true if all thread in pool is idle.
     bool is_idle()
     {
-        boost::lock_guard< boost::mutex > lock(_lock);
-        return (_tasks.empty() && _available == _pool_size) ? true : false;
+        return (0 == _pending.load() && 0 == _active.load()) ? true : false;
     }
 
-    /// @brief Add task to the thread pool if a thread is currently available.
+    /// @brief  Add task to the thread pool.
+    ///
+    ///         In the default mode the task is added only if a thread is
+    ///         currently available. In bounded mode the caller waits until
+    ///         the queue has room.
     template < typename Task >
     bool run_task(Task task)
     {
-        // We will use condition variable later of this function, so we have to 
-        // use unique_lock.
-        boost::unique_lock< boost::mutex > lock(_lock);
+        if (0 == _max_pending)
+        {
+            // If no threads are available, then return.
+            if (true != try_acquire_slot()) return false;
+        }
+        else
+        {
+            if (true != acquire_slot(nullptr)) return false;
+        }
 
-        // If no threads are available, then return.
-        if (0 == _available) return false;
+        task_type t(std::move(task));
+        push_task(t);
+        return true;
+    }
 
-        // Decrement count, indicating thread is no longer available.
-        --_available;
+    /// @brief  Add task to the thread pool only if it can be done without
+    ///         waiting, in either mode.
+    template < typename Task >
+    bool try_run_task(Task task)
+    {
+        if (true != try_acquire_slot()) return false;
+
+        task_type t(std::move(task));
+        push_task(t);
+        return true;
+    }
+
+    /// @brief  Add task to the thread pool unconditionally, never waiting,
+    ///         even if that overcommits the pool. Used for continuations,
+    ///         which must not be dropped and must not block a worker.
+    template < typename Task >
+    void post_task(Task task)
+    {
+        if (true != try_acquire_slot()) --_available;
+
+        task_type t(std::move(task));
+        push_task(t);
+    }
 
-        // Set task and signal condition variable so that a worker thread will
-        // wake up andl use the task.
-        _tasks.push(boost::function< void() >(task));
-        _condition.notify_one();
+    /// @brief  Add task to the thread pool, waiting up to `timeout_ms` for
+    ///         an available thread (default mode) or queue entry (bounded
+    ///         mode). Returns false on timeout.
+    template < typename Task >
+    bool run_task_for(Task task, uint32_t timeout_ms)
+    {
+        boost::chrono::steady_clock::time_point deadline =
+            boost::chrono::steady_clock::now() + boost::chrono::milliseconds(timeout_ms);
+        if (true != acquire_slot(&deadline)) return false;
+
+        task_type t(std::move(task));
+        push_task(t);
         return true;
     }
 
-    /// @brief return true if idle thread exists.
+    /// @brief  Add task to the thread pool and return a future of its result.
+    ///         Waits like run_task() in bounded mode, and waits for an
+    ///         available thread in the default mode. An exception thrown by
+    ///         the task is rethrown from future::get().
+    template < typename Func >
+    std::future< typename std::result_of< Func() >::type > submit(Func func)
+    {
+        typedef typename std::result_of< Func() >::type result_type;
+
+        std::packaged_task< result_type() > job(std::move(func));
+        std::future< result_type > result = job.get_future();
+
+        // If the pool is shutting down, `job` is dropped here and the
+        // future reports broken_promise.
+        if (true != acquire_slot(nullptr)) return result;
+
+        task_type t([job = std::move(job)]() mutable { job(); });
+        push_task(t);
+        return result;
+    }
+
+    /// @brief return true if idle thread (or free queue entry in bounded
+    ///        mode) exists.
     bool is_available()
     {
-        // boost::lock_guard is enough becauese we will not use any condition variables.
-        boost::lock_guard< boost::mutex > lock(_lock);
-        if (0 == _available)
+        if (0 >= _available.load())
             return false;
         else
             return true;
     }
 
     /// @brief Entry point for pool threads.
-    void pool_main()
+    void pool_main(std::size_t index)
     {
+        worker_context& self = current_worker();
+        self.pool = this;
+        self.index = index;
+        self.seed = static_cast< uint32_t >(index + 1) * 2654435761u;
+
         while (_running)
         {
-            // Wait on condition variable while the task is empty and the pool is
-            // still running.
+            // Move the task out of the deque within its own scope so that the
+            // task object is destructed immediately after running the task.
+            // This is useful in the event that the function contains
+            // shared_ptr arguments bound via bind.
+            {
+                task_type task;
+                if (true == find_task(index, task))
+                {
+                    ++_active;
+                    --_pending;
+
+                    // The task has left the queue, so there is room for one more.
+                    if (0 != _max_pending) release_slot();
+
+                    // Run the task.
+                    try
+                    {
+                        task();
+                    }
+                    // Suppress all exceptions.
+                    catch (...) {}
+
+                    // Task has finished, so increment count of available threads.
+                    if (0 == _max_pending) release_slot();
+                    --_active;
+                    continue;
+                }
+            }
+
+            // Nothing to run or to steal. Park until a task is posted or the
+            // pool is no longer running. `_idle_workers` is published before
+            // `_pending` is checked, so push_task() either sees a parked worker
+            // or the worker sees the new task.
             boost::unique_lock< boost::mutex > lock(_lock);
-            while (_tasks.empty() && _running)
+            ++_idle_workers;
+            while (0 == _pending.load() && _running)
             {
                 _condition.wait(lock);
             }
+            --_idle_workers;
+        } // while _running
+
+        self.pool = nullptr;
+    }
 
-            // If pool is no longer running, break out.
-            if (!_running) 
+private:
+    /// @brief  Take a free slot without waiting.
+    bool try_acquire_slot()
+    {
+        std::ptrdiff_t available = _available.load();
+        do
+        {
+            if (0 >= available) return false;
+        } while (!_available.compare_exchange_weak(available, available - 1));
+        return true;
+    }
+
+    /// @brief  Take a free slot, waiting until `deadline` (forever if null).
+    ///
+    ///         A worker of this pool never waits: it could be the one that
+    ///         has to free the slot, so its task is accepted even if the pool
+    ///         is full.
+    bool acquire_slot(const boost::chrono::steady_clock::time_point* deadline)
+    {
+        if (true == try_acquire_slot()) return true;
+
+        if (this == current_worker().pool)
+        {
+            --_available;
+            return true;
+        }
+
+        // `_slot_waiters` is published before the slot is re-checked, so
+        // release_slot() either sees a waiter or the waiter sees the slot.
+        boost::unique_lock< boost::mutex > lock(_slot_lock);
+        ++_slot_waiters;
+
+        bool acquired = false;
+        while (_running)
+        {
+            if (true == try_acquire_slot())
             {
-                ++_available;
+                acquired = true;
                 break;
             }
 
-            // Copy task locally and remove from the queue.  This is done within
-            // its own scope so that the task object is destructed immediately
-            // after running the task.  This is useful in the event that the
-            // function contains shared_ptr arguments bound via bind.
+            if (nullptr == deadline)
+            {
+                _slot_condition.wait(lock);
+            }
+            else if (boost::cv_status::timeout == _slot_condition.wait_until(lock, *deadline))
             {
-                boost::function< void() > task = _tasks.front();
-                _tasks.pop();
+                acquired = try_acquire_slot();
+                break;
+            }
+        }
+
+        --_slot_waiters;
+        return acquired;
+    }
+
+    /// @brief  Return a slot and wake up a parked producer if any.
+    void release_slot()
+    {
+        ++_available;
+        if (0 < _slot_waiters.load())
+        {
+            boost::lock_guard< boost::mutex > lock(_slot_lock);
+            _slot_condition.notify_one();
+        }
+    }
+
+    /// @brief  Queue the task on the caller's own deque if the caller is one
+    ///         of our workers, otherwise on the injection queue, then wake up
+    ///         a parked worker if any.
+    void push_task(task_type& task)
+    {
+        // Count the task before it becomes visible so that `_pending` never
+        // underflows when a worker grabs it right away.
+        ++_pending;
+
+        worker_context& self = current_worker();
+        if (this == self.pool)
+        {
+            _queues[self.index]->push_back(task);
+        }
+        else
+        {
+            _injection.push_back(task);
+        }
 
-                lock.unlock();
+        if (0 < _idle_workers.load())
+        {
+            boost::lock_guard< boost::mutex > lock(_lock);
+            _condition.notify_one();
+        }
+    }
+
+    /// @brief  Own deque (LIFO) -> injection queue (FIFO) -> steal (FIFO).
+    bool find_task(std::size_t index, task_type& task)
+    {
+        if (true == _queues[index]->pop_back(task)) return true;
+        if (true == _injection.pop_front(task)) return true;
+        return steal_task(index, task);
+    }
 
-                // Run the task.
-                try
+    /// @brief  Visit every other worker once, starting from a random victim.
+    bool steal_task(std::size_t index, task_type& task)
+    {
+        if (_pool_size < 2) return false;
+
+        // xorshift32
+        worker_context& self = current_worker();
+        uint32_t x = self.seed;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        self.seed = x;
+
+        std::size_t victim = x % _pool_size;
+        for (std::size_t i = 0; i < _pool_size; ++i)
+        {
+            if (victim != index && true == _queues[victim]->pop_front(task))
+            {
+                return true;
+            }
+
+            if (++victim == _pool_size) victim = 0;
+        }
+        return false;
+    }
+} *pthread_pool;
+
+
+//
+// Data-parallel algorithms on thread_pool.
+//
+// The range is split into chunks which are claimed from a shared counter by
+// the calling thread and by helper tasks posted to the pool. Each claim takes
+// `remaining / (2 * participants)` items but no less than the grain size, so
+// chunks start large and shrink towards the end of the range, and whoever is
+// free picks up the tail. The calling thread always takes part, so the
+// algorithms make progress even if the pool is busy or if they are called
+// from a task running on the same pool. An exception thrown by the body
+// stops the remaining chunks and is rethrown to the caller.
+//
+
+namespace parallel_detail
+{
+    /// @brief  State shared by the caller and the helper tasks of one loop.
+    ///         Helpers hold it through a shared_ptr, so a helper that starts
+    ///         after the loop is over only touches this object.
+    class loop_state
+    {
+    public:
+        loop_state(std::size_t count, std::size_t participants, std::size_t grain)
+            :
+            _count(count),
+            _participants(participants),
+            _grain(grain),
+            _next(0),
+            _completed(0),
+            _failed(false)
+        {
+        }
+
+        /// @brief  Run chunks until nothing is left to claim.
+        template < typename RangeFunc >
+        void run(RangeFunc& range_func)
+        {
+            std::size_t begin;
+            std::size_t end;
+            while (true == claim(begin, end))
+            {
+                if (true != _failed.load(std::memory_order_relaxed))
                 {
-                    task();
+                    try
+                    {
+                        range_func(begin, end);
+                    }
+                    catch (...)
+                    {
+                        set_exception(std::current_exception());
+                    }
                 }
-                // Suppress all exceptions.
-                catch (...) {}
+                complete(end - begin);
             }
+        }
 
-            // Task has finished, so increment count of available threads.
-            lock.lock();
-            ++_available;
-        } // while _running
+        /// @brief  Wait until every claimed chunk is done, then rethrow the
+        ///         first exception thrown by the body, if any.
+        void wait()
+        {
+            {
+                boost::unique_lock< boost::mutex > lock(_lock);
+                while (_completed.load() != _count)
+                {
+                    _condition.wait(lock);
+                }
+            }
+
+            if (_exception) std::rethrow_exception(_exception);
+        }
+
+    private:
+        bool claim(std::size_t& begin, std::size_t& end)
+        {
+            std::size_t next = _next.load();
+            std::size_t size;
+            do
+            {
+                if (next >= _count) return false;
+
+                size = (_count - next) / (2 * _participants);
+                if (size < _grain) size = _grain;
+                if (size > _count - next) size = _count - next;
+            } while (!_next.compare_exchange_weak(next, next + size));
+
+            begin = next;
+            end = next + size;
+            return true;
+        }
+
+        void complete(std::size_t size)
+        {
+            if (_completed.fetch_add(size) + size == _count)
+            {
+                boost::lock_guard< boost::mutex > lock(_lock);
+                _condition.notify_all();
+            }
+        }
+
+        void set_exception(std::exception_ptr exception)
+        {
+            boost::lock_guard< boost::mutex > lock(_lock);
+            if (!_exception) _exception = exception;
+            _failed = true;
+        }
+
+    private:
+        const std::size_t           _count;
+        const std::size_t           _participants;
+        const std::size_t           _grain;
+        std::atomic< std::size_t >  _next;
+        std::atomic< std::size_t >  _completed;
+        std::atomic< bool >         _failed;
+        std::exception_ptr          _exception;
+        boost::mutex                _lock;
+        boost::condition_variable   _condition;
+    };
+
+    /// @brief  Call `range_func(begin, end)` for chunks covering [0, count).
+    ///         `grain` is the smallest chunk, 0 picks one from the range and
+    ///         pool size.
+    template < typename RangeFunc >
+    void for_range(
+        thread_pool& pool,
+        std::size_t count,
+        RangeFunc range_func,
+        std::size_t grain
+        )
+    {
+        if (0 == count) return;
+
+        std::size_t participants = pool.get_pool_size() + 1;
+        if (0 == grain)
+        {
+            grain = count / (participants * 128);
+            if (0 == grain) grain = 1;
+        }
+
+        std::size_t max_chunks = (count + grain - 1) / grain;
+        if (participants > max_chunks) participants = max_chunks;
+
+        std::shared_ptr< loop_state > state =
+            std::make_shared< loop_state >(count, participants, grain);
+
+        // Post helpers while the pool accepts them without waiting. Whatever
+        // is not picked up by a helper is done by the calling thread.
+        RangeFunc* func = &range_func;
+        for (std::size_t i = 1; i < participants; ++i)
+        {
+            if (true != pool.try_run_task([state, func]() { state->run(*func); }))
+            {
+                break;
+            }
+        }
+
+        state->run(range_func);
+        state->wait();
+    }
+
+    template < typename Iterator, typename Func >
+    void for_each(
+        thread_pool& pool,
+        Iterator first,
+        Iterator last,
+        Func& func,
+        std::size_t grain,
+        std::random_access_iterator_tag
+        )
+    {
+        for_range(pool,
+                  static_cast< std::size_t >(std::distance(first, last)),
+                  [first, &func](std::size_t begin, std::size_t end)
+                  {
+                      for (std::size_t i = begin; i < end; ++i)
+                      {
+                          func(first[i]);
+                      }
+                  },
+                  grain);
+    }
+
+    /// @brief  Forward iterators (std::list, std::map, ...) are collected
+    ///         into a vector first.
+    template < typename Iterator, typename Func >
+    void for_each(
+        thread_pool& pool,
+        Iterator first,
+        Iterator last,
+        Func& func,
+        std::size_t grain,
+        std::forward_iterator_tag
+        )
+    {
+        std::vector< Iterator > its;
+        for (; first != last; ++first)
+        {
+            its.push_back(first);
+        }
+
+        for_range(pool,
+                  its.size(),
+                  [&its, &func](std::size_t begin, std::size_t end)
+                  {
+                      for (std::size_t i = begin; i < end; ++i)
+                      {
+                          func(*its[i]);
+                      }
+                  },
+                  grain);
+    }
+} // namespace parallel_detail
+
+/// @brief  Call `func(i)` for every i in [first, last).
+///
+/// @code
+///     parallel_for(pool, 0, (int)files.size(), [&](int i)
+///     {
+///         hash_file(files[i]);
+///     });
+/// @endcode
+/// @see test_parallel_algorithms()
+template < typename Index, typename Func >
+void
+parallel_for(
+    thread_pool& pool,
+    Index first,
+    Index last,
+    Func func,
+    std::size_t grain = 0
+    )
+{
+    if (!(first < last)) return;
+
+    parallel_detail::for_range(
+        pool,
+        static_cast< std::size_t >(last - first),
+        [first, &func](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                func(static_cast< Index >(first + i));
+            }
+        },
+        grain);
+}
+
+/// @brief  Call `func(element)` for every element in [first, last).
+template < typename Iterator, typename Func >
+void
+parallel_for_each(
+    thread_pool& pool,
+    Iterator first,
+    Iterator last,
+    Func func,
+    std::size_t grain = 0
+    )
+{
+    parallel_detail::for_each(
+        pool,
+        first,
+        last,
+        func,
+        grain,
+        typename std::iterator_traits< Iterator >::iterator_category());
+}
+
+/// @brief  Fold `map(i)` for every i in [first, last) with `reduce`,
+///         starting from `identity`. Chunks are combined in no particular
+///         order, so `reduce` must be associative and commutative.
+///
+/// @code
+///     uint64_t total = parallel_reduce(pool, 0, (int)files.size(), (uint64_t)0,
+///                                      [&](int i) { return file_size(files[i]); },
+///                                      [](uint64_t a, uint64_t b) { return a + b; });
+/// @endcode
+template < typename Index, typename T, typename Map, typename Reduce >
+T
+parallel_reduce(
+    thread_pool& pool,
+    Index first,
+    Index last,
+    T identity,
+    Map map,
+    Reduce reduce,
+    std::size_t grain = 0
+    )
+{
+    T result = identity;
+    if (!(first < last)) return result;
+
+    boost::mutex lock;
+    parallel_detail::for_range(
+        pool,
+        static_cast< std::size_t >(last - first),
+        [&](std::size_t begin, std::size_t end)
+        {
+            T partial = identity;
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                partial = reduce(partial, map(static_cast< Index >(first + i)));
+            }
+
+            boost::lock_guard< boost::mutex > guard(lock);
+            result = reduce(result, partial);
+        },
+        grain);
+    return result;
+}
+
+/// @brief  Sort [first, last) with `comp`.
+///
+///         Splits the range into one block per participant, sorts the blocks
+///         in parallel, then merges neighbouring blocks pairwise, in parallel
+///         for every round. Small ranges are sorted on the calling thread.
+///         Not stable.
+template < typename RandomIt, typename Compare >
+void
+parallel_sort(
+    thread_pool& pool,
+    RandomIt first,
+    RandomIt last,
+    Compare comp
+    )
+{
+    const std::size_t min_block = 4096;
+
+    std::size_t count = static_cast< std::size_t >(last - first);
+    std::size_t blocks = std::min(pool.get_pool_size() + 1, count / min_block);
+    if (blocks < 2)
+    {
+        std::sort(first, last, comp);
+        return;
     }
-} *pthread_pool;
\ No newline at end of file
+
+    std::vector< std::size_t > bounds;
+    for (std::size_t i = 0; i <= blocks; ++i)
+    {
+        bounds.push_back(count * i / blocks);
+    }
+
+    parallel_detail::for_range(
+        pool,
+        blocks,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                std::sort(first + bounds[i], first + bounds[i + 1], comp);
+            }
+        },
+        1);
+
+    while (bounds.size() > 2)
+    {
+        std::size_t pairs = (bounds.size() - 1) / 2;
+        parallel_detail::for_range(
+            pool,
+            pairs,
+            [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    std::inplace_merge(first + bounds[2 * i],
+                                       first + bounds[2 * i + 1],
+                                       first + bounds[2 * i + 2],
+                                       comp);
+                }
+            },
+            1);
+
+        // Drop the bounds between merged pairs; an odd last block is kept
+        // as is for the next round.
+        std::vector< std::size_t > merged;
+        for (std::size_t i = 0; i < bounds.size(); i += 2)
+        {
+            merged.push_back(bounds[i]);
+        }
+        if (0 == bounds.size() % 2) merged.push_back(bounds.back());
+        bounds.swap(merged);
+    }
+}
+
+template < typename RandomIt >
+void
+parallel_sort(
+    thread_pool& pool,
+    RandomIt first,
+    RandomIt last
+    )
+{
+    parallel_sort(pool, first, last, std::less< typename std::iterator_traits< RandomIt >::value_type >());
+}